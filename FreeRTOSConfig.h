@@ -85,7 +85,7 @@ void assert_triggered(const char *file, uint32_t line);
 // <q> Generate runtime stats
 // <id> freertos_generate_run_time_stats
 #ifndef configGENERATE_RUN_TIME_STATS
-#define configGENERATE_RUN_TIME_STATS 0
+#define configGENERATE_RUN_TIME_STATS 1
 #endif
 
 // <q> Use 16bit tick
@@ -122,7 +122,7 @@ void assert_triggered(const char *file, uint32_t line);
 // <q> Use tickless idle
 // <id> freertos_use_tickless_idle
 #ifndef configUSE_TICKLESS_IDLE
-#define configUSE_TICKLESS_IDLE 0
+#define configUSE_TICKLESS_IDLE 2
 #endif
 
 // <q> Use trace facility
@@ -182,16 +182,16 @@ void assert_triggered(const char *file, uint32_t line);
 // <i> Default is 2
 // <id> freertos_timer_task_priority
 #ifndef configTIMER_TASK_PRIORITY
-#define configTIMER_TASK_PRIORITY (2)
+#define configTIMER_TASK_PRIORITY (3)
 #endif
 
-#define configTIMER_QUEUE_LENGTH 2
+#define configTIMER_QUEUE_LENGTH 4
 
 // <o> Timer task stack size <32-512:4>
 // <i> Default is 64
 // <id> freertos_timer_task_stack_depth
 #ifndef TIMER_TASK_STACK_DEPTH
-#define configTIMER_TASK_STACK_DEPTH (64)
+#define configTIMER_TASK_STACK_DEPTH (512)
 #endif
 
 #define configPRIO_BITS 3
@@ -208,7 +208,7 @@ to exclude the API function. */
 // <q> Include function to set task priority
 // <id> freertos_vtaskpriorityset
 #ifndef INCLUDE_vTaskPrioritySet
-#define INCLUDE_vTaskPrioritySet 0
+#define INCLUDE_vTaskPrioritySet 1
 #endif
 
 // <q> Include function to get task priority
@@ -238,7 +238,7 @@ to exclude the API function. */
 // <q> Include task delay utilities
 // <id> freertos_vtaskdelayuntil
 #ifndef INCLUDE_vTaskDelayUntil
-#define INCLUDE_vTaskDelayUntil 0
+#define INCLUDE_vTaskDelayUntil 1
 #endif
 
 // <q> Include task delay function
@@ -349,6 +349,25 @@ to all Cortex-M ports, and do not rely on any particular library functions. */
 #define configKERNEL_INTERRUPT_PRIORITY (configLIBRARY_LOWEST_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
 
+/* Count context switches for profiling (see misc/profiling/cycle_counter.c) */
+#if defined(__GNUC__) || defined(__ICCARM__)
+extern volatile uint32_t context_switch_count;
+#endif
+#define traceTASK_SWITCHED_IN() (context_switch_count++, run_time_task_switched_in())
+
+/* Time each task's run slices (see misc/profiling/run_time_stats.c) */
+#if defined(__GNUC__) || defined(__ICCARM__)
+extern void run_time_task_switched_in(void);
+extern void run_time_task_switched_out(void *handle);
+#endif
+#define traceTASK_SWITCHED_OUT() run_time_task_switched_out(pxCurrentTCB)
+
+/* Sleep in the idle task with the tick suppressed (see misc/rtos_support/tickless_idle.c) */
+#if defined(__GNUC__) || defined(__ICCARM__)
+extern void tickless_idle_sleep(uint32_t expected_idle_ticks);
+#endif
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) tickless_idle_sleep(xExpectedIdleTime)
+
 // <<< end of configuration section >>>
 
 #endif // FREERTOSCONFIG_H
@@ -0,0 +1,115 @@
+"""
+Decompresses log payloads made by PVDXos's log compressor (src/misc/logging/log_compress.c).
+
+Each payload is one line of hex, as the shell's `crashlog zip` prints them. Payloads decompress independently, so a
+missing one only loses its own part of the log. With --crash-log the output is read as crash log records (see
+src/misc/logging/crash_log.h) and printed one per line; otherwise the decompressed bytes are written out as they are.
+
+Usage: python3 log_decompress.py payloads.txt                       (raw bytes to stdout)
+       python3 log_decompress.py payloads.txt --output log.bin
+       python3 log_decompress.py payloads.txt --crash-log
+"""
+
+import argparse
+import struct
+import sys
+
+# Payload format, matching src/misc/logging/log_compress.h
+HEADER = struct.Struct("<BH")  # Format byte (window bits << 4 | length bits), decompressed length
+MIN_MATCH = 2
+
+# Crash log records, matching src/misc/logging/crash_log.h
+RECORD = struct.Struct("<HHIIBB82s")  # Magic, CRC, sequence, tick count, kind, text length, text
+RECORD_MAGIC = 0xC1A5
+KINDS = {0: "FATAL", 1: "WARNING"}
+
+
+def decompress_payload(payload):
+    """The bytes one payload decompresses to."""
+    if len(payload) < HEADER.size:
+        raise ValueError("payload is shorter than its header")
+    format_byte, length = HEADER.unpack_from(payload)
+    window_bits, length_bits = format_byte >> 4, format_byte & 0x0F
+    bits = int.from_bytes(payload[HEADER.size:], "big")
+    remaining = (len(payload) - HEADER.size) * 8
+
+    def take(count):
+        nonlocal remaining
+        if count > remaining:
+            raise ValueError("payload ends in the middle of a token")
+        remaining -= count
+        return (bits >> remaining) & ((1 << count) - 1)
+
+    output = bytearray()
+    while len(output) < length:
+        if take(1):
+            output.append(take(8))
+            continue
+        offset = take(window_bits) + 1
+        count = take(length_bits) + MIN_MATCH
+        if offset > len(output):
+            raise ValueError(f"back-reference {offset} bytes back, with only {len(output)} bytes decompressed")
+        for _ in range(count):  # Byte by byte, since a copy may overlap the bytes it produces
+            output.append(output[-offset])
+    if len(output) != length:
+        raise ValueError(f"payload decompressed to {len(output)} bytes, its header says {length}")
+    return bytes(output)
+
+
+def read_payloads(lines):
+    """Payloads from lines of hex, skipping blank lines and anything that isn't hex (such as a shell prompt)."""
+    for line in lines:
+        line = line.strip()
+        try:
+            payload = bytes.fromhex(line)
+        except ValueError:
+            continue
+        if payload:
+            yield payload
+
+
+def format_crash_log(data):
+    """Crash log records, one line each, as the shell's `crashlog` command prints them."""
+    lines = []
+    for offset in range(0, len(data) - RECORD.size + 1, RECORD.size):
+        magic, _, sequence, ticks, kind, length, text = RECORD.unpack_from(data, offset)
+        if magic != RECORD_MAGIC:
+            lines.append(f"(bad record at byte {offset})")
+            continue
+        label = KINDS.get(kind, f"KIND {kind}")
+        lines.append(f"#{sequence} {label} at tick {ticks}: {text[:length].decode(errors='replace').rstrip()}")
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", nargs="?", help="file of hex payloads, one per line (default: stdin)")
+    parser.add_argument("--output", help="write the decompressed bytes to this file")
+    parser.add_argument("--crash-log", action="store_true", help="print the decompressed bytes as crash log records")
+    args = parser.parse_args()
+
+    with (open(args.input) if args.input else sys.stdin) as f:
+        payloads = list(read_payloads(f))
+
+    data = bytearray()
+    compressed = 0
+    for index, payload in enumerate(payloads):
+        try:
+            data += decompress_payload(payload)
+            compressed += len(payload)
+        except ValueError as error:
+            print(f"Payload {index}: {error}", file=sys.stderr)
+    if payloads:
+        print(f"{len(payloads)} payloads, {compressed} bytes -> {len(data)} bytes", file=sys.stderr)
+
+    if args.crash_log:
+        print("\n".join(format_crash_log(data)))
+    elif args.output:
+        with open(args.output, "wb") as f:
+            f.write(data)
+    else:
+        sys.stdout.buffer.write(data)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,9 +1,184 @@
+"""
+Reads PVDXos's log output from RTT channel 1 and prints it, keeping a copy in logs/.
+
+Builds made with `make dev TOKENIZED_LOGS=1` send each log call as a short binary record instead of text (see
+src/misc/logging/log_tokens.c). Pass the build's ELF with --elf (or a string table written by `make log_strings` with
+--table) and the records are turned back into the same text the normal build prints, with the tick count added.
+
+Usage: python3 rtt_logs.py                               (text logs)
+       python3 rtt_logs.py --elf ../src/PVDXos.elf       (tokenized logs)
+       python3 rtt_logs.py --elf PVDXos.elf --dump-table PVDXos_log_strings.json
+       python3 rtt_logs.py --table PVDXos_log_strings.json --decode capture.bin
+"""
+
+import argparse
 import platform
-import pylink # pip install pylink-square
-import os
 import datetime
+import json
+import os
+import re
+import struct
+
+# Record framing and call-site descriptors, matching src/misc/logging/log_tokens.h
+SYNC_BYTE = 0xA5
+HEADER = struct.Struct("<BHIB")  # Sync byte, token, tick count, payload length
+SITE = struct.Struct("<IIHBx")   # Format string address, file name address, line, kind
+TICK_RATE_HZ = 1000
+
+# Label and colour of each log_kind_t, as the text build prints them (see src/misc/logging/logging.h)
+BRIGHT_RED = "\x1b[1;31m"
+BRIGHT_WHITE = "\x1b[1;37m"
+WHITE = "\x1b[2;37m"
+RESET = "\x1b[0m"
+KINDS = [("FATAL", BRIGHT_RED), ("WARNING", BRIGHT_RED), ("EVENT", BRIGHT_WHITE), ("INFO", BRIGHT_WHITE),
+         ("DEBUG", WHITE), ("TEST", WHITE)]
+
+# A conversion as SEGGER_RTT_vprintf parses it: flags, width, precision, ignored length modifiers, conversion
+CONVERSION_RE = re.compile(r"%([-0+#]*)(\d*)(?:\.(\d*))?[lh]*(.?)", re.S)
+
+
+def read_elf_sections(data):
+    """Section headers of a little-endian 32-bit ELF file, as (name, type, address, offset, size, link) tuples."""
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise ValueError("not a little-endian 32-bit ELF file")
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+    headers = [struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+    names_offset = headers[shstrndx][4]
+
+    def name_at(offset):
+        return data[names_offset + offset:data.index(b"\0", names_offset + offset)].decode()
+
+    return [(name_at(h[0]), h[1], h[3], h[4], h[5], h[6]) for h in headers]
+
+
+def load_log_sites(elf_path):
+    """Call-site descriptors of a build, in token order, read from between __log_sites_start and __log_sites_end."""
+    with open(elf_path, "rb") as f:
+        data = f.read()
+    sections = read_elf_sections(data)
+
+    symbols = {}
+    for name, kind, _, offset, size, link in sections:
+        if kind != 2:  # SHT_SYMTAB
+            continue
+        strings_offset = sections[link][3]
+        for i in range(0, size, 16):
+            name_offset, value = struct.unpack_from("<II", data, offset + i)
+            end = data.index(b"\0", strings_offset + name_offset)
+            symbols[data[strings_offset + name_offset:end].decode()] = value
+    if "__log_sites_start" not in symbols:
+        raise ValueError(f"{elf_path} has no logging call sites (is it linked with src/src_ram.ld?)")
+
+    def read(address, length):
+        for _, kind, start, offset, size, _ in sections:
+            if kind == 1 and start <= address < start + size:  # SHT_PROGBITS
+                return data[offset + address - start:offset + min(address - start + length, size)]
+        raise ValueError(f"address 0x{address:08x} is not in the ELF")
+
+    def read_string(address):
+        chunk = read(address, 512)
+        return chunk[:chunk.find(b"\0")].decode("ascii", errors="replace")
+
+    start, end = symbols["__log_sites_start"], symbols["__log_sites_end"]
+    sites = []
+    for address in range(start, end, SITE.size):
+        format_address, file_address, line, kind = SITE.unpack(read(address, SITE.size))
+        sites.append({"kind": kind, "file": read_string(file_address), "line": line,
+                      "format": read_string(format_address)})
+    return sites
+
+
+def format_message(fmt, payload):
+    """Rebuilds the text of a record the way SEGGER_RTT_vprintf would have printed it on the target."""
+    out = []
+    position = 0
+    last = 0
+    for match in CONVERSION_RE.finditer(fmt):
+        out.append(fmt[last:match.start()])
+        last = match.end()
+        flags, width, precision, conversion = match.groups()
+        if conversion == "%":
+            out.append("%")
+            continue
+        if conversion == "" or conversion not in "cduxXps":
+            continue
+        if conversion == "s":
+            if position >= len(payload):
+                out.append("<?>")
+                continue
+            length = payload[position]
+            out.append(payload[position + 1:position + 1 + length].decode("ascii", errors="replace"))
+            position += 1 + length
+            continue
+        if position + 4 > len(payload):
+            out.append("<?>")
+            continue
+        value, = struct.unpack_from("<I", payload, position)
+        position += 4
+        if conversion == "c":
+            out.append(chr(value & 0xFF))
+        elif conversion == "p":
+            out.append(f"{value:08X}")
+        else:
+            spec = "%" + flags.replace("#", "") + width + ("." + precision if precision is not None else "")
+            if conversion == "d":
+                out.append((spec + "d") % (value - (1 << 32) if value & 0x80000000 else value))
+            elif conversion == "u":
+                out.append((spec + "d") % value)
+            else:
+                out.append((spec + "X") % value)  # SEGGER_RTT_vprintf prints hex in upper case
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+class TokenDecoder:
+    """Turns the byte stream of tokenized records back into log text."""
+
+    def __init__(self, sites):
+        self.sites = sites
+        self.pending = bytearray()
+        self.skipped = 0
+
+    def feed(self, data):
+        """Adds bytes read from RTT and returns the text of every record they complete."""
+        self.pending += data
+        text = []
+        while True:
+            sync = self.pending.find(SYNC_BYTE)
+            if sync < 0:
+                self.skipped += len(self.pending)
+                self.pending.clear()
+                break
+            if sync > 0:
+                self.skipped += sync
+                del self.pending[:sync]
+            if len(self.pending) < HEADER.size:
+                break
+            _, token, ticks, length = HEADER.unpack_from(self.pending)
+            if len(self.pending) < HEADER.size + length:
+                break
+            payload = bytes(self.pending[HEADER.size:HEADER.size + length])
+            if token >= len(self.sites):
+                # Not a record start (or the ELF is from another build): look for the next sync byte
+                self.skipped += 1
+                del self.pending[:1]
+                continue
+            del self.pending[:HEADER.size + length]
+            text.append(self.decode(token, ticks, payload))
+        return "".join(text)
+
+    def decode(self, token, ticks, payload):
+        site = self.sites[token]
+        label, colour = KINDS[site["kind"]] if site["kind"] < len(KINDS) else ("?", RESET)
+        seconds = ticks / TICK_RATE_HZ
+        message = format_message(site["format"], payload)
+        return f"{colour}[{label}|{site['file']}:{site['line']}|{seconds:.3f}]: {message}{RESET}"
+
+
+def open_rtt_channels(logfile = None, decoder = None):
+    import pylink # pip install pylink-square
 
-def open_rtt_channels(logfile = None):
     jlink = pylink.JLink()
     jlink.open()
     jlink.connect(chip_name='ATSAMD51P20A')
@@ -13,13 +188,48 @@ def open_rtt_channels(logfile = None):
         buf1 = jlink.rtt_read(1, 2048)
 
         if buf1:
-            text1 = bytes(buf1).decode('ascii', errors='replace')
-            print(text1)
+            if decoder is not None:
+                text1 = decoder.feed(bytes(buf1))
+            else:
+                text1 = bytes(buf1).decode('ascii', errors='replace')
+            print(text1, end='' if decoder is not None else '\n')
             # Write to a log file if specified
             if logfile is not None:
                 logfile.write(text1)
 
 def main():
+    parser = argparse.ArgumentParser(description="Print PVDXos's RTT log output")
+    parser.add_argument("--elf", help="ELF of the running build, to decode tokenized logs (TOKENIZED_LOGS=1)")
+    parser.add_argument("--table", help="string table written by --dump-table, instead of --elf")
+    parser.add_argument("--dump-table", metavar="OUT", help="write the call-site string table of --elf to OUT and exit")
+    parser.add_argument("--decode", metavar="CAPTURE", help="decode a file of raw tokenized records instead of reading RTT")
+    args = parser.parse_args()
+
+    sites = None
+    if args.elf is not None:
+        sites = load_log_sites(args.elf)
+    elif args.table is not None:
+        with open(args.table) as f:
+            sites = json.load(f)
+
+    if args.dump_table is not None:
+        if args.elf is None:
+            parser.error("--dump-table needs --elf")
+        with open(args.dump_table, "w") as f:
+            json.dump(sites, f, indent=1)
+        print(f"Wrote {len(sites)} logging call sites to {args.dump_table}")
+        return
+
+    decoder = TokenDecoder(sites) if sites is not None else None
+    if args.decode is not None:
+        if decoder is None:
+            parser.error("--decode needs --elf or --table")
+        with open(args.decode, "rb") as f:
+            print(decoder.feed(f.read()), end="")
+        if decoder.skipped:
+            print(f"({decoder.skipped} bytes outside of records skipped)")
+        return
+
     # Sanity check to make sure this is not in WSL
     # if "microsoft" in platform.uname().release:
     #     print("This code cannot be executed in a WSL environment. Run natively on Windows instead!")
@@ -38,9 +248,9 @@ def main():
     current_time = datetime.datetime.now()
     log_filename = current_time.strftime("%Y-%m-%d_%H-%M-%S.log")
     log_file_path = os.path.join(logs_path, log_filename)
-    
+
     with open (log_file_path, "w") as file:
-        open_rtt_channels(file)
+        open_rtt_channels(file, decoder)
 
 if __name__ == "__main__":
     main()
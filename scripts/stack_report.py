@@ -0,0 +1,350 @@
+"""
+Worst-case static stack usage of every PVDX task.
+
+Reads the call graph and per-function stack frames that GCC writes next to every object file when building with
+-fcallgraph-info=su,da (`make dev STACK_REPORT=1`, see src/Makefile; needs GCC 10 or newer), then walks the call graph
+from each task's entry point in src/tasks/task_list.c to find the deepest chain of frames. Frames that grow at run
+time (the VLAs in the linalg functions) are bounded by reading their declarations from the source, with every matrix
+dimension set to --max-dim.
+
+Calls through function pointers cannot be followed from the call graph alone, so the targets of PVDXos's dispatch
+tables (command routes, task init functions, shell commands, device checks) are read from the source; any other
+indirect calls can be described with --indirect. Anything the
+report cannot bound (unlisted indirect calls, recursion, unbounded dynamic frames) is listed under the task, so the
+result is a lower bound until those are accounted for. Library functions built without call graph info (newlib, libm)
+are charged --extern-bytes each and listed as assumptions.
+
+Usage (from src/): make clean && make dev STACK_REPORT=1 && make stack_report
+     or: python3 ../scripts/stack_report.py --build-dir ../ASF/gcc --src-dir . [--measured <hex from 'stacks dump'>]
+"""
+
+import argparse
+import fnmatch
+import math
+import os
+import re
+import struct
+
+# Registers FreeRTOS keeps on a task's stack while it is switched out on the Cortex-M4F (hardware frame with the FPU
+# state, r4-r11 and the EXC_RETURN value, and s16-s31), in bytes
+CONTEXT_FRAME_BYTES = (26 + 9 + 16) * 4
+
+# Sizes of the element types used for VLAs in the linalg functions (f2c's integer is a long)
+TYPE_SIZES = {
+    "char": 1, "uint8_t": 1, "int8_t": 1, "bool": 1,
+    "short": 2, "uint16_t": 2, "int16_t": 2,
+    "int": 4, "long": 4, "float": 4, "real": 4, "integer": 4, "logical": 4, "uint32_t": 4, "int32_t": 4, "size_t": 4,
+    "double": 8, "doublereal": 8, "uint64_t": 8, "int64_t": 8,
+}
+
+NODE_RE = re.compile(r'node:\s*\{\s*title:\s*"([^"]*)"\s*label:\s*"([^"]*)"')
+EDGE_RE = re.compile(r'edge:\s*\{\s*sourcename:\s*"([^"]*)"\s*targetname:\s*"([^"]*)"')
+FRAME_RE = re.compile(r'(\d+) bytes \(([a-z,]+)\)')
+LOCATION_RE = re.compile(r'([^\s:]+):(\d+):\d+')
+VLA_RE = re.compile(r'^\s*(?:const\s+)?([A-Za-z_]\w*)\s+(?:const\s+)?([A-Za-z_]\w*)((?:\s*\[[^\]]+\])+)\s*[;=]', re.M)
+LOCAL_SIZE_RE = re.compile(r'^\s*(?:const\s+)?(?:size_t|int|integer|uint32_t)\s+(?:const\s+)?([A-Za-z_]\w*)\s*=\s*([^;]+);', re.M)
+
+
+class Function:
+    def __init__(self, name, source, line, frame_bytes, qualifier):
+        self.name = name
+        self.source = source
+        self.line = line
+        self.frame_bytes = frame_bytes
+        self.dynamic = qualifier.startswith("dynamic")
+        self.bounded = qualifier == "dynamic,bounded"
+        self.vla_bytes = 0
+        self.callees = []
+        self.indirect = False
+
+
+def load_call_graph(build_dir):
+    """Reads every .ci file under build_dir. Returns (functions by name, functions by (file, name))."""
+    by_name = {}
+    by_file = {}
+    for root, _, files in os.walk(build_dir):
+        for filename in files:
+            if not filename.endswith(".ci"):
+                continue
+            with open(os.path.join(root, filename), errors="replace") as ci_file:
+                text = ci_file.read()
+
+            defined = {}
+            for title, label in NODE_RE.findall(text):
+                frame = FRAME_RE.search(label)
+                if frame is None:
+                    continue  # Declared but defined elsewhere
+                location = LOCATION_RE.search(label)
+                source = os.path.basename(location.group(1)) if location else filename[:-3] + ".c"
+                line = int(location.group(2)) if location else 0
+                function = Function(title, source, line, int(frame.group(1)), frame.group(2))
+                defined[title] = function
+                by_file[(source, title)] = function
+                by_name.setdefault(title, []).append(function)
+
+            for source_name, target_name in EDGE_RE.findall(text):
+                caller = defined.get(source_name)
+                if caller is None:
+                    continue
+                if target_name == "__indirect_call":
+                    caller.indirect = True
+                else:
+                    caller.callees.append(target_name)
+    return by_name, by_file
+
+
+def resolve(name, caller, by_name, by_file):
+    """Finds the definition a call refers to, preferring a static function in the caller's own file"""
+    if caller is not None and (caller.source, name) in by_file:
+        return by_file[(caller.source, name)]
+    definitions = by_name.get(name)
+    return definitions[0] if definitions else None
+
+
+def find_sources(src_dirs):
+    sources = {}
+    for src_dir in src_dirs:
+        for root, _, files in os.walk(src_dir):
+            for filename in files:
+                if filename.endswith(".c"):
+                    sources.setdefault(filename, os.path.join(root, filename))
+    return sources
+
+
+def evaluate_size(expression, locals_, max_dim, depth=0):
+    """Evaluates a VLA dimension with every unknown identifier set to max_dim"""
+    expression = expression.replace("sizeof(float)", "4").replace("sizeof(double)", "8")
+
+    def substitute(match):
+        identifier = match.group(0)
+        if identifier in ("max", "min"):
+            return identifier
+        if identifier in locals_ and depth < 4:
+            return "(%d)" % evaluate_size(locals_[identifier], locals_, max_dim, depth + 1)
+        return str(max_dim)
+
+    expression = re.sub(r'[A-Za-z_]\w*', substitute, expression)
+    try:
+        return int(eval(expression, {"__builtins__": {}}, {"max": max, "min": min}))
+    except Exception:
+        return max_dim
+
+
+def bound_vlas(function, sources, max_dim):
+    """Sums the variable-length arrays declared in a function's body (an upper bound: disjoint scopes are added)"""
+    path = sources.get(function.source)
+    if path is None:
+        return 0
+    with open(path, errors="replace") as source_file:
+        lines = source_file.read().split("\n")
+    start = function.line - 1
+    end = start + 1
+    while end < len(lines) and not lines[end].startswith("}"):
+        end += 1
+    body = "\n".join(lines[start:end])
+
+    locals_ = dict(LOCAL_SIZE_RE.findall(body))
+    total = 0
+    for element_type, _, dimensions in VLA_RE.findall(body):
+        if element_type not in TYPE_SIZES:
+            continue
+        sizes = re.findall(r'\[([^\]]+)\]', dimensions)
+        if all(re.fullmatch(r'\s*\d+\s*', size) for size in sizes):
+            continue  # Fixed-size array, already part of the static frame
+        elements = 1
+        for size in sizes:
+            elements *= evaluate_size(size, locals_, max_dim)
+        total += elements * TYPE_SIZES[element_type]
+    return total
+
+
+class Analysis:
+    def __init__(self, by_name, by_file, indirect, sources, max_dim, extern_bytes):
+        self.by_name = by_name
+        self.by_file = by_file
+        self.indirect = indirect
+        self.sources = sources
+        self.max_dim = max_dim
+        self.extern_bytes = extern_bytes
+        self.externs = set()
+        self.memo = {}
+
+    def indirect_targets(self, function):
+        patterns = self.indirect.get(function.name)
+        if patterns is None:
+            return None
+        return sorted(name for name in self.by_name if any(fnmatch.fnmatch(name, pattern) for pattern in patterns if pattern))
+
+    def frame(self, function):
+        if function.dynamic and not function.bounded and function.vla_bytes == 0:
+            function.vla_bytes = bound_vlas(function, self.sources, self.max_dim)
+        return function.frame_bytes + function.vla_bytes
+
+    def worst(self, function, stack=()):
+        """Returns (worst-case bytes, deepest call chain, set of problems) for a function and everything it calls"""
+        key = (function.source, function.name)
+        if key in self.memo:
+            return self.memo[key]
+        if key in stack:
+            return 0, [], {"recursion through %s" % function.name}
+
+        problems = set()
+        if function.dynamic and not function.bounded and self.frame(function) == function.frame_bytes:
+            problems.add("unbounded dynamic frame in %s (%s)" % (function.name, function.source))
+
+        callees = list(function.callees)
+        if function.indirect:
+            targets = self.indirect_targets(function)
+            if targets is None:
+                problems.add("unlisted indirect call in %s (%s)" % (function.name, function.source))
+            else:
+                callees += targets
+
+        deepest_bytes, deepest_chain = 0, []
+        for callee_name in callees:
+            callee = resolve(callee_name, function, self.by_name, self.by_file)
+            if callee is None:
+                self.externs.add(callee_name)
+                if self.extern_bytes > deepest_bytes:
+                    deepest_bytes, deepest_chain = self.extern_bytes, []
+                continue
+            callee_bytes, callee_chain, callee_problems = self.worst(callee, stack + (key,))
+            problems |= callee_problems
+            if callee_bytes > deepest_bytes:
+                deepest_bytes, deepest_chain = callee_bytes, callee_chain
+
+        result = (self.frame(function) + deepest_bytes, [function] + deepest_chain, problems)
+        if not any(problem.startswith("recursion") for problem in problems):
+            self.memo[key] = result
+        return result
+
+
+def load_tasks(src_dir):
+    """Returns [(task_index name, task name, entry function, stack size in words)] from task_list.c and the headers"""
+    defines = {}
+    for root, _, files in os.walk(src_dir):
+        for filename in files:
+            if filename.endswith(".h"):
+                with open(os.path.join(root, filename), errors="replace") as header:
+                    defines.update(re.findall(r'#define\s+(\w+_STACK_SIZE)\s+(\d+)', header.read()))
+
+    with open(os.path.join(src_dir, "tasks", "task_list.c")) as task_list:
+        text = task_list.read()
+    tasks = []
+    for body in re.findall(r'pvdx_task_t\s+\w+\s*=\s*\{(.*?)\};', text, re.S):
+        fields = dict(re.findall(r'\.(\w+)\s*=\s*([^,\n]+)', body))
+        stack_size = fields["stack_size"].strip()
+        tasks.append((fields["task_index"].strip(), fields["name"].strip().strip('"'), fields["function"].strip(),
+                      int(defines.get(stack_size, stack_size))))
+    return tasks
+
+
+def strip_comments(text):
+    return re.sub(r'//[^\n]*|/\*.*?\*/', '', text, flags=re.S)
+
+
+def load_dispatch_tables(src_dir):
+    """Returns {caller: [possible targets]} for the function pointer tables PVDXos calls through"""
+    def read(*path):
+        with open(os.path.join(src_dir, *path), errors="replace") as source_file:
+            return strip_comments(source_file.read())
+
+    shell_entries = re.findall(r'\{\s*"[^"]*"\s*,\s*(\w+)\s*,\s*(\w+)\s*\}', read("tasks", "shell", "shell_commands.c"))
+    device_table = re.search(r'device_check_functions\[[^\]]*\]\)\(void\)\s*=\s*\{(.*?)\};', read("checks", "device_checks.c"), re.S)
+    return {
+        "exec_command": re.findall(r'ROUTE\([^()]*,\s*(\w+)\)', read("tasks", "command_dispatcher", "command_routing.c")),
+        "init_task_pointer": [name for name in re.findall(r'\.init\s*=\s*(\w+)', read("tasks", "task_list.c")) if name != "NULL"],
+        "main_shell": [function for function, _ in shell_entries],
+        "shell_help": [help_function for _, help_function in shell_entries],
+        "check_device": re.findall(r'&(\w+)', device_table.group(1)) if device_table else [],
+    }
+
+
+def load_task_indices(src_dir):
+    with open(os.path.join(src_dir, "globals.h")) as globals_h:
+        return re.findall(r'^\s*(TASK_INDEX_\w+)', globals_h.read(), re.M)
+
+
+def parse_measured(hex_dump, task_indices):
+    """Decodes the stack_usage_record_t records of 'stacks dump' into peak bytes by task_index name"""
+    data = bytes.fromhex(hex_dump.strip())
+    peaks = {}
+    for offset in range(0, len(data) - len(data) % 8, 8):
+        task_index, flags, _, peak_used_words, _ = struct.unpack_from("<BBHHH", data, offset)
+        if task_index < len(task_indices) and flags & 0x01:
+            peaks[task_indices[task_index]] = peak_used_words * 4
+    return peaks
+
+
+def main():
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description="Worst-case static stack usage of every PVDX task")
+    parser.add_argument("--build-dir", default=os.path.join(script_dir, "..", "ASF", "gcc"),
+                        help="directory holding the .ci files of a build with -fcallgraph-info=su,da")
+    parser.add_argument("--src-dir", default=os.path.join(script_dir, "..", "src"))
+    parser.add_argument("--max-dim", type=int, default=9, help="largest matrix dimension passed to the linalg functions")
+    parser.add_argument("--extern-bytes", type=int, default=128,
+                        help="stack charged for a library function built without call graph info")
+    parser.add_argument("--margin", type=float, default=0.25, help="headroom to keep above the worst case when sizing")
+    parser.add_argument("--indirect", action="append", default=[], metavar="CALLER=PATTERN[,PATTERN...]",
+                        help="functions a caller can reach through function pointers, besides the dispatch tables")
+    parser.add_argument("--measured", help="hex dump from the shell's 'stacks dump' command")
+    args = parser.parse_args()
+
+    by_name, by_file = load_call_graph(args.build_dir)
+    if not by_name:
+        print("No call graph found under %s; build with 'make clean && make dev STACK_REPORT=1' (or test/release) first"
+              % args.build_dir)
+        return 1
+
+    indirect = load_dispatch_tables(args.src_dir)
+    for entry in args.indirect:
+        caller, patterns = entry.split("=", 1)
+        indirect.setdefault(caller, []).extend(patterns.split(","))
+
+    analysis = Analysis(by_name, by_file, indirect, find_sources([args.src_dir, os.path.join(args.src_dir, "..", "ASF")]),
+                        args.max_dim, args.extern_bytes)
+    measured = parse_measured(args.measured, load_task_indices(args.src_dir)) if args.measured else {}
+
+    print("%-20s %10s %10s %10s %10s %10s" % ("task", "allocated", "worst", "measured", "suggested", "reclaim"))
+    total_allocated = total_reclaim = 0
+    notes = []
+    for task_index, name, entry, stack_words in load_tasks(args.src_dir):
+        allocated = stack_words * 4
+        function = resolve(entry, None, by_name, by_file)
+        if function is None:
+            print("%-20s %10d %10s" % (name, allocated, "?"))
+            notes.append((name, [], {"no call graph for entry point %s" % entry}))
+            continue
+
+        worst_bytes, chain, problems = analysis.worst(function)
+        worst_bytes += CONTEXT_FRAME_BYTES
+        # Suggested sizes are rounded up to 64 words so that small code changes don't keep moving them
+        suggested = int(math.ceil(worst_bytes * (1 + args.margin) / 256.0)) * 256
+        if task_index in measured:
+            suggested = max(suggested, int(math.ceil(measured[task_index] * (1 + args.margin) / 256.0)) * 256)
+        reclaim = max(0, allocated - suggested) if not problems else 0
+        total_allocated += allocated
+        total_reclaim += reclaim
+
+        print("%-20s %10d %9d%s %10s %10d %10d" % (name, allocated, worst_bytes, "+" if problems else " ",
+                                                   measured.get(task_index, "-"), suggested, reclaim))
+        notes.append((name, chain, problems))
+
+    print("\nAll sizes in bytes. 'worst' includes %d bytes of saved context; '+' marks a lower bound." % CONTEXT_FRAME_BYTES)
+    print("Reclaimable: %d of %d bytes of task stack (only counted for tasks with a complete bound)\n" %
+          (total_reclaim, total_allocated))
+
+    for name, chain, problems in notes:
+        print("%s:" % name)
+        if chain:
+            print("  deepest path: " + " -> ".join("%s (%d)" % (f.name.split(":")[-1], analysis.frame(f)) for f in chain))
+        for problem in sorted(problems):
+            print("  " + problem)
+    if analysis.externs:
+        print("\nCharged %d bytes each (no call graph): %s" % (args.extern_bytes, ", ".join(sorted(analysis.externs))))
+    return 0
+
+
+if __name__ == "__main__":
+    exit(main())
@@ -4,7 +4,7 @@
  * Hardware driver for RTC timer used in ADCS algorithms
  *
  * Created: November 9, 2025
- * Modified: November 24, 2025
+ * Modified: October 17, 2026
  * Authors: Alexander Thaep
  */
 
@@ -23,7 +23,14 @@ static const void *rtc_hw;
  * \returns status_t SUCCESS if initialization was successful
  */
 status_t init_rtc_hardware(void) {
+    // Already running (started early for tickless idle); resetting the count would corrupt sleep timing
+    if (rtc_hw) {
+        return SUCCESS;
+    }
     rtc_hw = (&TIMER_0.device)->hw;
+    // The count is only polled, so the ASF timer's compare 0 interrupt is not wanted (it would wake every sleep)
+    hri_rtcmode0_clear_INTEN_CMP0_bit(rtc_hw);
+    hri_rtcmode0_clear_interrupt_CMP0_bit(rtc_hw);
     hri_rtcmode0_clear_CTRLA_ENABLE_bit(rtc_hw);
     hri_rtcmode0_clear_CTRLA_MATCHCLR_bit(rtc_hw);
     hri_rtcmode0_write_COUNT_reg(rtc_hw, 0);
@@ -51,3 +58,54 @@ status_t get_rtc_values(rtc_data_t *data) {
     data->seconds_count = data->rtc_count / 32768;
     return SUCCESS;
 }
+
+/**
+ * \fn read_rtc_count
+ *
+ * \brief Read the raw 32.768 kHz RTC count (the RTC must be initialized)
+ *
+ * \returns uint32_t the current count
+ */
+uint32_t read_rtc_count(void) {
+    return hri_rtcmode0_read_COUNT_reg(rtc_hw);
+}
+
+/**
+ * \fn arm_rtc_wakeup
+ *
+ * \brief Set up compare 1 so that the core is woken from sleep when the RTC count reaches a value. Must be called
+ *        with interrupts masked (PRIMASK): the RTC interrupt wakes the core from WFI but is never taken, and
+ *        `disarm_rtc_wakeup()` must be called after waking.
+ *
+ * \param wakeup_count the RTC count at which to wake
+ *
+ * \returns bool true if the compare was armed, false if the count was already too close to (or past) `wakeup_count`
+ *          for the match to be seen, in which case the caller must not sleep
+ */
+bool arm_rtc_wakeup(uint32_t wakeup_count) {
+    hri_rtcmode0_write_COMP_reg(rtc_hw, 1, wakeup_count);
+    hri_rtcmode0_clear_interrupt_CMP1_bit(rtc_hw);
+    hri_rtcmode0_set_INTEN_CMP1_bit(rtc_hw);
+    NVIC_ClearPendingIRQ(RTC_IRQn);
+    NVIC_EnableIRQ(RTC_IRQn);
+
+    // Writing the compare takes a few RTC clocks to synchronize, so check that the match is still ahead
+    if ((int32_t)(wakeup_count - read_rtc_count()) < RTC_WAKEUP_MIN_LEAD_COUNTS) {
+        disarm_rtc_wakeup();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \fn disarm_rtc_wakeup
+ *
+ * \brief Undo `arm_rtc_wakeup()`, clearing the compare 1 match so that the RTC interrupt is never taken once
+ *        interrupts are unmasked (the ASF RTC handler only expects compare 0)
+ */
+void disarm_rtc_wakeup(void) {
+    hri_rtcmode0_clear_INTEN_CMP1_bit(rtc_hw);
+    hri_rtcmode0_clear_interrupt_CMP1_bit(rtc_hw);
+    NVIC_DisableIRQ(RTC_IRQn);
+    NVIC_ClearPendingIRQ(RTC_IRQn);
+}
@@ -3,6 +3,9 @@
 
 #include "globals.h"
 
+// Constants
+#define RTC_WAKEUP_MIN_LEAD_COUNTS 3 // A compare closer than this to the count when armed may be missed
+
 // Data structure to hold RTC values
 typedef struct {
     uint32_t rtc_count;
@@ -13,5 +16,8 @@ typedef struct {
 // Function declarations
 status_t init_rtc_hardware(void);
 status_t get_rtc_values(rtc_data_t *data);
+uint32_t read_rtc_count(void);
+bool arm_rtc_wakeup(uint32_t wakeup_count);
+void disarm_rtc_wakeup(void);
 
 #endif // RTC_DRIVER_H
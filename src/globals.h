@@ -12,6 +12,7 @@
 
 #include <FreeRTOS.h>
 #include <queue.h>
+#include <semphr.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <task.h>
@@ -28,9 +29,18 @@
 
 /* ---------- TASK CONSTANTS ---------- */
 
-#define TASK_STACK_OVERFLOW_PADDING 16            // Buffer for the stack size so that overflow doesn't corrupt any TCBs
-#define COMMAND_QUEUE_MAX_COMMANDS 30             // Maximum number of commands that can be queued at once for any task
-#define COMMAND_QUEUE_ITEM_SIZE sizeof(command_t) // Size of each item in command queues
+#define TASK_STACK_OVERFLOW_PADDING 16                   // Buffer for the stack size so that overflow doesn't corrupt any TCBs
+#define COMMAND_QUEUE_MAX_COMMANDS 30                    // Maximum number of commands that can be queued at once for any task
+#define COMMAND_QUEUE_ITEM_SIZE sizeof(packed_command_t) // Size of each item in command queues (the packed wire form)
+#define COMMAND_QUEUE_URGENT_MAX_COMMANDS 8              // Maximum number of urgent commands (checkins, power off) per task
+#define COMMAND_QUEUE_SET_SLACK 8                        // Extra queue set entries left by drop-oldest overflows (see `send_to_lane()`)
+#define COMMAND_QUEUE_SET_LENGTH \
+    (COMMAND_QUEUE_MAX_COMMANDS + COMMAND_QUEUE_URGENT_MAX_COMMANDS + 1 + COMMAND_QUEUE_SET_SLACK) // Both lanes, wakeup and slack
+#define COMMAND_COALESCE_TABLE_SIZE 8 // Maximum number of coalescable commands tracked as pending per task
+#define COMMAND_META_RESERVED_SLOTS NUM_TASKS // Metadata slots kept for commands with a waiting requester (one wait per task)
+#define COMMAND_META_POOL_SIZE \
+    (COMMAND_QUEUE_MAX_COMMANDS + COMMAND_QUEUE_URGENT_MAX_COMMANDS + COMMAND_META_RESERVED_SLOTS) // One task's full lanes, plus waits
+#define CHECKIN_HISTOGRAM_BINS 8      // Check-in interval histogram bins per task, each covering 1/8 of the task's watchdog timeout
 
 /* ---------- ENUMS ---------- */
 
@@ -51,6 +61,10 @@ typedef enum {
     ERROR_SANITY_CHECK_FAILED,
     ERROR_PROCESSING_FAILED,
     ERROR_NOT_READY,
+    ERROR_TIMEOUT,
+    ERROR_QUEUE_FULL,
+    ERROR_INVALID_COMMAND, // The target task has no route for the operation, or the data type is wrong
+    ERROR_TASK_RESTARTED,  // The target task was restarted before it executed the command
 } status_t;
 
 // An enum to represent the different operations that tasks can perform (contained within a command_t)
@@ -66,6 +80,7 @@ typedef enum {
     OPERATION_INIT_SUBTASKS,   // p_data: NULL
     OPERATION_ENABLE_SUBTASK,  // p_data: TaskHandle_t *handle
     OPERATION_DISABLE_SUBTASK, // p_data: TaskHandle_t *handle
+    OPERATION_SET_MODE,        // p_data: const mode_profile_t *profile
 
     // Display operations
     OPERATION_DISPLAY_IMAGE, // p_data: color_t *p_buffer
@@ -77,6 +92,8 @@ typedef enum {
 
     // TESTING
     TEST_OP, // p_data: char message[]
+
+    NUM_OPERATIONS, // Number of operations (must stay last)
 } operation_t;
 
 // An enum to represent the different log levels that functions can use
@@ -93,8 +110,22 @@ typedef enum {
     SENSOR,
     ACTUATOR,
     TESTING,
+    SERVICE, // Supports the other tasks without the OS depending on it (e.g. the Logger); restartable, enabled in every mode
 } task_type_t;
 
+// Index of each task in `task_list` (also used to index the command routing table)
+typedef enum {
+    TASK_INDEX_WATCHDOG = 0,
+    TASK_INDEX_COMMAND_DISPATCHER,
+    TASK_INDEX_TASK_MANAGER,
+    TASK_INDEX_ADCS,
+    TASK_INDEX_SHELL,
+    TASK_INDEX_DISPLAY,
+    TASK_INDEX_HEARTBEAT,
+    TASK_INDEX_LOGGER,
+    NUM_TASKS, // Number of tasks in `task_list` (must stay last)
+} task_index_t;
+
 /*
  * An enum to represent the ID/tag for each hardware device
  */
@@ -113,6 +144,13 @@ typedef enum {
     CAMERA_ID = 9,
 } device_id_t;
 
+// The lanes of a task's command queue. Lower values are always drained first.
+typedef enum {
+    COMMAND_LANE_URGENT = 0, // Commands that must not wait behind bulk work (e.g. watchdog checkins, power off)
+    COMMAND_LANE_NORMAL,     // Everything else
+    NUM_COMMAND_LANES,
+} command_lane_t;
+
 /* ---------- MISCELLANEOUS TASK TYPES ---------- */
 
 // A task-initialisation function; takes in nothing and returns a queue handle.
@@ -133,32 +171,107 @@ typedef struct {
     float z;
 } float_3d_t;
 
+// Head-of-line wait statistics for one command lane (time from `dispatch_command()` until the target dequeues it)
+typedef struct {
+    uint32_t commands_received; // Number of commands dequeued from the lane
+    uint32_t last_wait_us;      // Wait time of the most recently dequeued command
+    uint32_t max_wait_us;       // Longest wait time seen
+    uint64_t total_wait_us;     // Sum of all wait times (divide by `commands_received` for the mean)
+    uint32_t out_of_order;      // Commands dequeued from the lane while the queue set reported the other lane
+    uint32_t empty_wakeups;     // Queue set entries reported for the lane that found both lanes empty
+} command_lane_stats_t;
+
+// Who records a check-in in a task's interval statistics. Check-ins come from the task itself (direct check-ins) or
+// from the watchdog task executing the task's checkin command, and each keeps its own copy of the statistics so that
+// every copy has a single writer and needs no lock
+typedef enum {
+    CHECKIN_WRITER_TASK = 0, // Any task other than the watchdog (normally the task checking in)
+    CHECKIN_WRITER_WATCHDOG, // The watchdog task
+    NUM_CHECKIN_WRITERS,
+} checkin_writer_t;
+
+// Check-in interval statistics of one task, kept by the watchdog to size `watchdog_timeout_ms` from data
+typedef struct {
+    uint32_t intervals;                         // Number of check-in intervals measured
+    uint32_t min_interval_ticks;                // Shortest time between two check-ins
+    uint32_t max_interval_ticks;                // Longest time between two check-ins
+    uint64_t total_interval_ticks;              // Sum of all intervals (divide by `intervals` for the mean)
+    uint32_t min_margin_ticks;                  // Smallest time that was left before the watchdog timeout
+    uint16_t histogram[CHECKIN_HISTOGRAM_BINS]; // Intervals by fraction of the timeout (bin i: i/8 up to (i+1)/8)
+} checkin_interval_stats_t;
+
+// A task's check-in interval statistics, one copy per writer (combined by `get_watchdog_checkin_interval_stats()`)
+typedef struct {
+    checkin_interval_stats_t copies[NUM_CHECKIN_WRITERS]; // Statistics recorded by each writer
+    uint32_t generations[NUM_CHECKIN_WRITERS];            // Reset generation each copy was last cleared in (accessed atomically)
+} checkin_interval_copies_t;
+
+// Release statistics of a periodic task (see `wait_for_next_release()`)
+typedef struct {
+    TickType_t last_release_ticks; // Tick the latest job was released at (`vTaskDelayUntil()`'s previous wake time)
+    uint32_t last_release_cycles;  // Cycle count when the latest job started
+    uint32_t releases;             // Number of jobs released
+    uint32_t overruns;             // Jobs still running when their next release was due
+    uint32_t skipped_releases;     // Releases dropped to get back onto the schedule (after an overrun or a suspension)
+    uint32_t jitter_samples;       // Number of release-to-release intervals measured
+    uint32_t max_jitter_us;        // Largest deviation of an interval from its nominal length
+    uint64_t total_jitter_us;      // Sum of all deviations (divide by `jitter_samples` for the mean)
+    uint32_t max_execution_us;     // Longest job (from its release until the task waits for the next one)
+} task_period_stats_t;
+
+// Identifies a queued command that later duplicates can be coalesced into (see `OVERFLOW_POLICY_COALESCE`)
+typedef struct {
+    const void *target; // Target task of the pending command
+    const void *data;   // Data pointer of the pending command (e.g. the task checking in)
+    uint8_t operation;  // Operation of the pending command
+    bool in_use;        // Whether this slot holds a pending command
+} pending_command_key_t;
+
+typedef struct command_queue_set_memory command_queue_set_memory_t;
+
 // A struct defining a task's lifecycle in the PVDXos RTOS
 typedef struct {
-    const char *const name;             // Name of the task
-    bool enabled;                       // Whether the task is enabled
-    TaskHandle_t handle;                // FreeRTOS handle to the task
-    QueueHandle_t command_queue;        // Command queue associated with the task
-    const init_function init;           // Initialisation function to call before task entry point
-    const TaskFunction_t function;      // Main entry point for the task
-    const uint32_t stack_size;          // Size of the stack in words (multiply by 4 to get bytes)
-    StackType_t *const stack_buffer;    // Buffer for the stack
-    void *pvParameters;                 // Parameters to pass to the task's main function
-    UBaseType_t priority;               // Priority of the task in the RTOS scheduler
-    StaticTask_t *const task_tcb;       // Task control block
-    const uint32_t watchdog_timeout_ms; // How frequently the task should check in with the watchdog (in milliseconds)
-    uint32_t last_checkin_time_ticks;   // Last time the task checked in with the watchdog
-    bool has_registered;                // Whether the task is being monitored by the watchdog (initialized to NULL)
-    const task_type_t task_type;        // Whether the task is OS-integrity, a sensor, or an actuator
+    const char *const name;                             // Name of the task
+    bool enabled;                                       // Whether the task is enabled
+    TaskHandle_t handle;                                // FreeRTOS handle to the task
+    QueueHandle_t command_queue;                        // Command queue associated with the task (the normal lane)
+    QueueHandle_t urgent_command_queue;                 // Urgent command lane, drained before `command_queue` (NULL if unused)
+    QueueSetHandle_t command_queue_set;                 // Set containing both command lanes and the wakeup semaphore (NULL if unused)
+    SemaphoreHandle_t wakeup_semaphore;                 // Given to wake the task early without sending it a command
+    command_queue_set_memory_t *const queue_set_mem;    // Memory for the urgent lane and queue set (NULL if the task only uses its queue)
+    const init_function init;                           // Initialisation function to call before task entry point
+    const TaskFunction_t function;                      // Main entry point for the task
+    const uint32_t stack_size;                          // Size of the stack in words (multiply by 4 to get bytes)
+    StackType_t *const stack_buffer;                    // Buffer for the stack
+    void *pvParameters;                                 // Parameters to pass to the task's main function
+    UBaseType_t priority;                               // Priority of the task in the RTOS scheduler
+    StaticTask_t *const task_tcb;                       // Task control block
+    uint32_t watchdog_timeout_ms;                       // How frequently the task should check in with the watchdog (in milliseconds)
+    uint32_t last_checkin_time_ticks;                   // Last time the task checked in with the watchdog (accessed atomically)
+    bool has_registered;                                // Whether the task is being monitored by the watchdog (initialized to NULL)
+    const task_type_t task_type;                        // Whether the task is OS-integrity, a sensor, or an actuator
+    const task_index_t task_index;                      // Position of the task in `task_list`
+    command_lane_stats_t lane_stats[NUM_COMMAND_LANES]; // Head-of-line wait statistics for each command lane
+    checkin_interval_copies_t checkin_stats;            // Check-in interval statistics (see `record_checkin_interval()`)
+    uint32_t stack_peak_used_words;                     // Deepest stack use seen, in words (see `stack_usage_sample()`)
+    uint32_t period_ms;                                 // Release period of a periodic task in milliseconds (0 if event-driven)
+    task_period_stats_t period_stats;                   // Release statistics of a periodic task (see `wait_for_next_release()`)
+    uint32_t completion_sequence;                       // Sequence number of this task's latest `enqueue_command_and_wait()`
+    uint32_t queue_set_surplus;                         // Queue set entries whose command was dropped by drop-oldest
+    // Coalescable commands currently queued for this task (see `OVERFLOW_POLICY_COALESCE`)
+    pending_command_key_t pending_commands[COMMAND_COALESCE_TABLE_SIZE];
 } pvdx_task_t;
 
 typedef struct adcs_data adcs_data_t;
+typedef struct mode_profile mode_profile_t;
 
 typedef union command_data {
     adcs_data_t *adcs_data;
     const uint8_t *display_data;
     TaskHandle_t *task_handle;
     pvdx_task_t *pvdx_task;
+    const mode_profile_t *mode_profile;
+    const void *raw; // Any of the above, for code that only compares data pointers
 } command_data_t;
 
 typedef enum {
@@ -167,6 +280,8 @@ typedef enum {
     CMD_DATA_DISPLAY,
     CMD_DATA_TASK_HANDLE,
     CMD_DATA_PVDX_TASK,
+    CMD_DATA_MODE_PROFILE,
+    NUM_CMD_DATA_TYPES, // Number of data types (must stay last)
 } command_data_type_t;
 
 // A struct to represent a command that OS tasks can execute
@@ -176,8 +291,37 @@ typedef struct {
     const command_data_type_t data_type; // Tag indicating the type of data help
     const operation_t operation;         // The operation to perform
     status_t result;                     // Ttatus indicating result of the operation
+    uint32_t enqueued_cycles;            // Cycle count when the command was placed on a lane (set by `dispatch_command()`)
+    pvdx_task_t *requester;              // Task blocked waiting for `result` (set by `enqueue_command_and_wait()`)
+    uint32_t completion_sequence;        // Identifies the requester's wait so that late completions are ignored
+    uint16_t trace_id;                   // Identifies the command in the lifecycle trace (set by `enqueue_command()`)
+    uint32_t submitted_cycles;           // Cycle count when `enqueue_command()` was called
+    uint32_t dequeued_cycles;            // Cycle count when the target dequeued the command (0 until then)
 } command_t;
 
+// The 8-byte form a `command_t` takes while it sits in a command queue (see `pack_command()`). Timing and completion
+// metadata travels separately in a small pool, referenced by `meta_slot`.
+typedef struct {
+    uint8_t target_index; // task_index_t of the target (`COMMAND_TARGET_NONE` if NULL)
+    uint8_t operation;    // operation_t
+    uint8_t data_type;    // command_data_type_t
+    uint8_t meta_slot;    // Slot in the metadata pool (`COMMAND_META_NONE` if the command carries none)
+    uint32_t payload;     // `command_data_t` pointer
+} packed_command_t;
+
+_Static_assert(sizeof(packed_command_t) == 8, "packed_command_t must stay 8 bytes");
+_Static_assert(sizeof(void *) <= sizeof(uint32_t), "command payload pointers must fit in 32 bits");
+
+// Static memory for the urgent command lane and the queue set that lets a task block on both command lanes and its
+// wakeup semaphore at once (the normal lane is the task's own command queue)
+struct command_queue_set_memory {
+    uint8_t urgent_queue_buffer[COMMAND_QUEUE_URGENT_MAX_COMMANDS * COMMAND_QUEUE_ITEM_SIZE];
+    StaticQueue_t urgent_queue;
+    uint8_t queue_set_buffer[COMMAND_QUEUE_SET_LENGTH * sizeof(QueueSetMemberHandle_t)];
+    StaticQueue_t queue_set;
+    StaticSemaphore_t wakeup_semaphore;
+};
+
 /* ---------- BUILD CONSTANTS ---------- */
 
 // Defines for printing out the build version
@@ -6,7 +6,7 @@
  * the FreeRTOS scheduler.
  *
  * Created: November 20, 2023
- * Modified: November 9, 2025
+ * Modified: October 17, 2026
  * Authors: Oren Kohavi, Siddharta Laloux, Tanish Makadia, Yi Liu,
  *          Defne Doken, Aidan Wang, Ignacio Blancas Rodriguez, Alexander Thaep
  */
@@ -16,16 +16,27 @@
 #include "SEGGER_RTT.h"
 #include "checks/device_checks.h"
 #include "cosmic_monkey_task.h"
+#include "crash_log.h"
+#include "cycle_counter.h"
 #include "globals.h"
 #include "logging.h"
 #include "rtos_start.h"
 #include "task_list.h"
 #include "tasks/task_manager/task_manager_task.h"
+#include "tasks/watchdog/watchdog_snapshot.h"
+#include "tests/benchmark.h"
 #include "tests/test.h"
+#include "tickless_idle.h"
 
 cosmic_monkey_task_arguments_t cm_args = {0};
 
 static status_t PVDX_init(void) {
+    // Start the DWT cycle counter used to timestamp commands and for profiling
+    init_cycle_counter();
+
+    // Start the RTC that keeps time while the idle task sleeps with the tick suppressed
+    init_tickless_idle();
+
     // Segger Buffer 0 is pre-configured at compile time according to segger documentation
     // Config the logging output channel (assuming it's not zero)
     if (LOGGING_RTT_OUTPUT_CHANNEL != 0) {
@@ -59,15 +70,16 @@ int main(void) {
         warning_impl("[!] Abnormal bootloader behavior (Magic Number: %x)\n", magic_number);
     }
 
+    // Recover the fatal errors and warnings kept in backup RAM through the last reset, and hold them for downlink
+    report_crash_log();
+
+    // Report the task states captured by a watchdog early warning before the last reset, if there was one
+    watchdog_report_snapshot();
+
     /* ---------- INIT WATCHDOG, COMMAND_DISPATCHER, TASK_MANAGER TASKS (in that order) ---------- */
 
     info("AT_LEAST_ONE_DEVICE_FAILED: %d\n", check_all_devices_on_startup());
 
-/* -------------------------------------- TESTS ---------------------------------------------- */
-#ifdef UNITTEST
-    tests_run();
-#endif
-
     // Initialize a mutex wrapping the shared PVDX task list struct
     task_list_mutex = xSemaphoreCreateMutexStatic(&task_list_mutex_buffer);
 
@@ -77,6 +89,15 @@ int main(void) {
     if (task_list[0] != p_watchdog_task) {
         fatal("Watchdog is not first in task_list!");
     }
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        if (task_list[i]->task_index != i) {
+            fatal("%s task is not at its task_index in task_list!", task_list[i]->name);
+        }
+        // A periodic task checks in once per period, so its period must fit well inside its watchdog timeout
+        if (task_list[i]->period_ms > task_list[i]->watchdog_timeout_ms / 2) {
+            fatal("%s task's period is longer than half its watchdog timeout!", task_list[i]->name);
+        }
+    }
 
     // Initialize all OS integrity tasks
     for (pvdx_task_t **curr_task = task_list; *curr_task != NULL; curr_task++) {
@@ -94,6 +115,12 @@ int main(void) {
         }
     }
 
+/* -------------------------------------- TESTS ---------------------------------------------- */
+#ifdef UNITTEST
+    tests_run();
+    benchmarks_start_task();
+#endif
+
     /* ---------- COSMIC MONKEY TASK ---------- */
 
 #if defined(UNITTEST) || defined(DEVBUILD)
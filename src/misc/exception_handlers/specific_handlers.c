@@ -13,6 +13,7 @@
 
 #include "default_handler.h"
 #include "logging.h"
+#include "watchdog_task.h"
 
 // Implementation of Cortex-M4 core handlers
 void NonMaskableInt_Handler(void) {
@@ -90,7 +91,7 @@ void SUPC_1_Handler(void) {
     PVDX_default_handler();
 }
 void WDT_Handler(void) {
-    PVDX_default_handler();
+    early_warning_callback_watchdog(); // Snapshots task state into backup RAM ahead of the watchdog reset
 }
 void EIC_0_Handler(void) {
     PVDX_default_handler();
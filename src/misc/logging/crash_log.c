@@ -0,0 +1,250 @@
+/**
+ * crash_log.c
+ *
+ * Crash log for PVDXos. Every fatal error and warning is also written, as text, to a small ring of records in backup
+ * RAM, which keeps its contents through the watchdog reset that follows a fatal error or fault. On the next boot
+ * `report_crash_log()` (called from main) moves the records that survived into regular RAM for downlink and clears the
+ * ring, so the reason for a reset is kept even when nothing was reading RTT at the time.
+ *
+ * Each record carries a CRC, so records torn by a reset part-way through writing them, and the random contents of
+ * backup RAM after a power loss, are dropped rather than reported.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "crash_log.h"
+
+#include <string.h>
+
+#include "log_ring.h"
+#include "logging.h"
+
+// Lives in backup RAM (after the bootloader's reserved bytes, see src_ram.ld) and is never zeroed at startup
+__attribute__((section(".bkupram"))) static crash_log_t persistent_crash_log;
+
+// Records recovered from before the last reset, oldest first, held for downlink
+static crash_log_record_t recovered_records[CRASH_LOG_CAPACITY];
+static size_t recovered_count = 0;
+static bool crash_log_recovered = false;
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021) of every value of a nibble
+static const uint16_t crc16_nibble_table[16] = {0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+                                                0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+/**
+ * \fn crash_log_crc16
+ *
+ * \brief Computes the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of a block of bytes, a nibble at a
+ *        time to keep the table small
+ *
+ * \param p_data the bytes
+ * \param length number of bytes
+ *
+ * \returns the CRC
+ */
+uint16_t crash_log_crc16(const uint8_t *p_data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[(crc >> 12) ^ (p_data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble_table[(crc >> 12) ^ (p_data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+/**
+ * \fn record_crc
+ *
+ * \returns the CRC of a record's contents (everything after its `crc` field)
+ */
+static inline uint16_t record_crc(const crash_log_record_t *const p_record) {
+    const size_t offset = offsetof(crash_log_record_t, sequence);
+    return crash_log_crc16((const uint8_t *)p_record + offset, sizeof(crash_log_record_t) - offset);
+}
+
+/**
+ * \fn format_text
+ *
+ * \brief Prints a message into a buffer the way the log channel would, without going through RTT
+ *
+ * \returns the length of the text
+ */
+static size_t format_text(char *const p_text, size_t capacity, const char *format, va_list *p_args) {
+    uint8_t payload[LOG_RING_MAX_PAYLOAD];
+    bool truncated = false;
+    const size_t payload_length = log_token_encode_args(format, p_args, payload, sizeof(payload), &truncated);
+    return log_format_payload(format, payload, payload_length, p_text, capacity);
+}
+
+/**
+ * \fn format_prefix
+ *
+ * \brief Prints the call site in front of a message whose format string doesn't include it
+ *
+ * \returns the length of the text
+ */
+static size_t format_prefix(char *const p_text, size_t capacity, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    const size_t length = format_text(p_text, capacity, format, &args);
+    va_end(args);
+    return length;
+}
+
+/**
+ * \fn crash_log_write
+ *
+ * \brief Writes one message to a crash log as a new record, overwriting the oldest if the log is full. Never blocks;
+ *        safe from any task or interrupt, fault handlers included.
+ *
+ * \param p_log the crash log
+ * \param kind `LOG_KIND_FATAL` or `LOG_KIND_WARNING`
+ * \param file file name of the call site, or NULL if the format string already prints it
+ * \param line line of the call site (ignored if `file` is NULL)
+ * \param format the message's format string
+ * \param p_args the message's arguments
+ */
+void crash_log_write(crash_log_t *const p_log, log_kind_t kind, const char *file, uint32_t line, const char *format, va_list *p_args) {
+    char text[CRASH_LOG_TEXT_LENGTH + CRASH_LOG_FORMAT_SLACK];
+    size_t text_length = 0;
+    if (file != NULL) {
+        text_length = format_prefix(text, sizeof(text), "%s:%u: ", file, line);
+    }
+    text_length += format_text(&text[text_length], sizeof(text) - text_length, format, p_args);
+
+    crash_log_record_t record = {.magic = CRASH_LOG_RECORD_MAGIC, .ticks = log_tick_count(), .kind = (uint8_t)kind};
+    memset(record.text, 0, sizeof(record.text));
+
+    // Copy the text without its terminal colour codes (ESC '[' ... final letter), leaving room for the NUL
+    size_t length = 0;
+    for (size_t i = 0; i < text_length && length < CRASH_LOG_TEXT_LENGTH - 1; i++) {
+        if (text[i] == '\x1b' && i + 1 < text_length && text[i + 1] == '[') {
+            for (i += 2; i < text_length && !(text[i] >= '@' && text[i] <= '~'); i++) {
+            }
+            continue;
+        }
+        record.text[length++] = text[i];
+    }
+    record.length = (uint8_t)length;
+
+    // Claiming the slot is the only step shared with other writers; the CRC catches a slot left half-written by a reset
+    record.sequence = __atomic_fetch_add(&p_log->next_sequence, 1, __ATOMIC_RELAXED);
+    record.crc = record_crc(&record);
+    p_log->records[record.sequence & CRASH_LOG_INDEX_MASK] = record;
+}
+
+/**
+ * \fn crash_log_recover
+ *
+ * \brief Copies the intact records of a crash log out, oldest first, then empties the log. Records continue to be
+ *        numbered from the newest one recovered (or from 0 if there was none).
+ *
+ * \param p_log the crash log (in any state: garbage, torn records and all)
+ * \param p_records where to copy the records (room for `CRASH_LOG_CAPACITY`)
+ *
+ * \returns the number of records copied
+ */
+size_t crash_log_recover(crash_log_t *const p_log, crash_log_record_t p_records[CRASH_LOG_CAPACITY]) {
+    size_t count = 0;
+    uint32_t next_sequence = 0;
+    for (size_t i = 0; i < CRASH_LOG_CAPACITY; i++) {
+        const crash_log_record_t *const p_record = &p_log->records[i];
+        if (p_record->magic != CRASH_LOG_RECORD_MAGIC || p_record->length >= CRASH_LOG_TEXT_LENGTH ||
+            (p_record->sequence & CRASH_LOG_INDEX_MASK) != i || p_record->crc != record_crc(p_record)) {
+            continue;
+        }
+        if (p_record->sequence >= next_sequence) {
+            next_sequence = p_record->sequence + 1;
+        }
+
+        // Insertion sort by sequence number; the log holds few records and this runs once per boot
+        size_t position = count++;
+        while (position > 0 && p_records[position - 1].sequence > p_record->sequence) {
+            p_records[position] = p_records[position - 1];
+            position--;
+        }
+        p_records[position] = *p_record;
+    }
+
+    memset(p_log->records, 0, sizeof(p_log->records));
+    p_log->next_sequence = next_sequence;
+    return count;
+}
+
+/**
+ * \fn ensure_crash_log_recovered
+ *
+ * \brief Recovers the backup RAM crash log the first time it is used after a reset, so that a warning logged early in
+ *        boot doesn't overwrite a record from before the reset
+ */
+static inline void ensure_crash_log_recovered(void) {
+    if (!crash_log_recovered) {
+        recovered_count = crash_log_recover(&persistent_crash_log, recovered_records);
+        crash_log_recovered = true;
+    }
+}
+
+/**
+ * \fn append_crash_log
+ *
+ * \brief Writes a fatal error or warning to the crash log in backup RAM (see `crash_log_write()`)
+ */
+void append_crash_log(log_kind_t kind, const char *file, uint32_t line, const char *format, va_list *p_args) {
+    ensure_crash_log_recovered();
+    crash_log_write(&persistent_crash_log, kind, file, line, format, p_args);
+}
+
+/**
+ * \fn report_crash_log
+ *
+ * \brief Recovers the crash log left in backup RAM before the last reset (if not already done) and logs what it held.
+ *        The records stay available for downlink (`crash_log_serialize()`, the shell's `crashlog dump`). Called once at
+ *        boot.
+ */
+void report_crash_log(void) {
+    ensure_crash_log_recovered();
+    if (recovered_count == 0) {
+        return;
+    }
+    // Printed with info(), since warnings would be written to the crash log again
+    info("[!] Crash log: %d messages from before the last reset\n", recovered_count);
+    for (size_t i = 0; i < recovered_count; i++) {
+        const crash_log_record_t *const p_record = &recovered_records[i];
+        (void)p_record; // Only used by log output, which RELEASE builds compile out
+        info("[!]   #%u %s at tick %u: %s", p_record->sequence, p_record->kind == LOG_KIND_FATAL ? "FATAL" : "WARNING",
+             p_record->ticks, p_record->text);
+    }
+}
+
+/**
+ * \fn get_recovered_crash_log
+ *
+ * \brief Gives the records recovered from before the last reset, oldest first
+ *
+ * \param p_count set to the number of records
+ *
+ * \returns the records
+ */
+const crash_log_record_t *get_recovered_crash_log(size_t *const p_count) {
+    *p_count = recovered_count;
+    return recovered_records;
+}
+
+/**
+ * \fn crash_log_serialize
+ *
+ * \brief Writes the records recovered from before the last reset, oldest first, for downlink
+ *
+ * \param p_buffer Buffer to write the records into
+ * \param buffer_size Size of `p_buffer` in bytes
+ *
+ * \returns `size_t`, the number of bytes written (only whole records are written)
+ */
+size_t crash_log_serialize(uint8_t *const p_buffer, size_t buffer_size) {
+    size_t offset = 0;
+    for (size_t i = 0; i < recovered_count && offset + sizeof(crash_log_record_t) <= buffer_size; i++) {
+        memcpy(&p_buffer[offset], &recovered_records[i], sizeof(crash_log_record_t));
+        offset += sizeof(crash_log_record_t);
+    }
+    return offset;
+}
@@ -0,0 +1,51 @@
+#ifndef CRASH_LOG_H
+#define CRASH_LOG_H
+
+// Includes
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "log_tokens.h"
+
+// Constants
+#define CRASH_LOG_CAPACITY 32            // Records kept in backup RAM; the oldest is overwritten first (power of two)
+#define CRASH_LOG_TEXT_LENGTH 82         // Bytes of text per record, including the terminating NUL
+#define CRASH_LOG_RECORD_MAGIC 0xC1A5U   // Marks a slot that has been written (checked along with the CRC)
+#define CRASH_LOG_FORMAT_SLACK 16        // Extra room when formatting, for terminal colour codes that are stripped out
+#define CRASH_LOG_INDEX_MASK (CRASH_LOG_CAPACITY - 1)
+
+_Static_assert((CRASH_LOG_CAPACITY & (CRASH_LOG_CAPACITY - 1)) == 0, "crash log capacity must be a power of two");
+
+// One fatal error or warning, as kept in backup RAM and downlinked (see `crash_log_serialize()`). The CRC covers every
+// field after it, so a record torn by a reset part-way through writing it, or backup RAM that lost power, is rejected.
+typedef struct {
+    uint16_t magic;                    // `CRASH_LOG_RECORD_MAGIC`
+    uint16_t crc;                      // CRC-16/CCITT-FALSE of `sequence` through `text`
+    uint32_t sequence;                 // Records written before this one (continued across a reset from the last record kept)
+    uint32_t ticks;                    // Tick count when the message was logged
+    uint8_t kind;                      // `log_kind_t` (fatal or warning)
+    uint8_t length;                    // Characters in `text`, not counting the NUL
+    char text[CRASH_LOG_TEXT_LENGTH];  // The message with terminal colour codes removed, NUL-terminated and zero-padded
+} crash_log_record_t;
+
+_Static_assert(sizeof(crash_log_record_t) == 96, "crash log records are downlinked as 96-byte blocks");
+
+// Ring of records in backup RAM. Writers claim a slot by incrementing `next_sequence`, so tasks and interrupts (fault
+// handlers included) can record without locks.
+typedef struct {
+    uint32_t next_sequence; // Only meaningful after `crash_log_recover()`
+    crash_log_record_t records[CRASH_LOG_CAPACITY];
+} crash_log_t;
+
+uint16_t crash_log_crc16(const uint8_t *p_data, size_t length);
+void crash_log_write(crash_log_t *const p_log, log_kind_t kind, const char *file, uint32_t line, const char *format, va_list *p_args);
+size_t crash_log_recover(crash_log_t *const p_log, crash_log_record_t p_records[CRASH_LOG_CAPACITY]);
+
+void append_crash_log(log_kind_t kind, const char *file, uint32_t line, const char *format, va_list *p_args);
+void report_crash_log(void);
+const crash_log_record_t *get_recovered_crash_log(size_t *const p_count);
+size_t crash_log_serialize(uint8_t *const p_buffer, size_t buffer_size);
+
+#endif // CRASH_LOG_H
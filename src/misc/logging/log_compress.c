@@ -0,0 +1,217 @@
+/**
+ * log_compress.c
+ *
+ * Streaming compressor for downlinking logs. Log text repeats itself heavily (task loop banners, file names, the same
+ * few messages with different numbers), so a small LZ77 window removes much of it. The format is LZSS, in the style
+ * of heatshrink: a bit stream of tokens, most significant bit first, each either
+ *
+ *   1, then 8 bits              a literal byte
+ *   0, then W bits, then L bits  a copy of (L + LOG_COMPRESS_MIN_MATCH) bytes, starting (W + 1) bytes back
+ *
+ * where W has LOG_COMPRESS_WINDOW_BITS bits and L has LOG_COMPRESS_LENGTH_BITS. Each payload starts with a 3-byte
+ * header (the format byte, then the number of bytes it decompresses to), and back-references never reach into an
+ * earlier payload. Bits left over at the end of a payload are zero. scripts/log_decompress.py decompresses payloads on
+ * the ground.
+ *
+ * Everything lives in the caller's `log_compressor_t`; nothing is allocated. Matches are found by searching the
+ * window directly, which is slow per byte but needs no index memory, and logs are compressed off the critical path.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "log_compress.h"
+
+#include <string.h>
+
+_Static_assert(LOG_COMPRESS_BUFFER_SIZE <= UINT16_MAX, "log compressor buffer positions are 16 bits");
+_Static_assert(LOG_COMPRESS_PAYLOAD_SIZE > LOG_COMPRESS_HEADER_SIZE + 2, "log compression payloads are too small");
+
+/**
+ * \fn put_bits
+ *
+ * \brief Appends bits to the payload, most significant first. The caller has checked that they fit.
+ *
+ * \param p_compressor the compressor
+ * \param value the bits (in the low `count` bits)
+ * \param count number of bits
+ */
+static void put_bits(log_compressor_t *const p_compressor, uint32_t value, size_t count) {
+    uint8_t *const p_bits = &p_compressor->p_payload[LOG_COMPRESS_HEADER_SIZE];
+    while (count > 0) {
+        const size_t byte = p_compressor->bit_length / 8;
+        const size_t used = p_compressor->bit_length % 8;
+        const size_t room = 8 - used;
+        const size_t taken = count < room ? count : room;
+        const uint8_t bits = (uint8_t)((value >> (count - taken)) & ((1u << taken) - 1));
+
+        if (used == 0) {
+            p_bits[byte] = 0; // Unused bits stay zero, which also pads the final byte
+        }
+        p_bits[byte] |= (uint8_t)(bits << (room - taken));
+        p_compressor->bit_length += taken;
+        count -= taken;
+    }
+}
+
+/**
+ * \fn find_match
+ *
+ * \brief Finds the longest earlier copy, within this payload's history, of the bytes about to be compressed
+ *
+ * \param p_compressor the compressor
+ * \param available bytes buffered from the current position
+ * \param p_offset set to how far back the match starts
+ *
+ * \returns the length of the match (0 if there is none)
+ */
+static size_t find_match(const log_compressor_t *const p_compressor, size_t available, size_t *const p_offset) {
+    const uint8_t *const p_next = &p_compressor->buffer[p_compressor->position];
+    const size_t limit = available < LOG_COMPRESS_MAX_MATCH ? available : LOG_COMPRESS_MAX_MATCH;
+    size_t first = p_compressor->chunk_start;
+    if (p_compressor->position - first > LOG_COMPRESS_WINDOW_SIZE) {
+        first = p_compressor->position - LOG_COMPRESS_WINDOW_SIZE;
+    }
+
+    size_t best_length = 0;
+    // Search from the nearest candidate outwards, so that a tie goes to the closest copy
+    for (size_t candidate = p_compressor->position; candidate-- > first;) {
+        const uint8_t *const p_candidate = &p_compressor->buffer[candidate];
+        // Only a candidate that also matches the byte after the best match so far can beat it
+        if (p_candidate[best_length] != p_next[best_length] || p_candidate[0] != p_next[0]) {
+            continue;
+        }
+        size_t length = 1;
+        while (length < limit && p_candidate[length] == p_next[length]) {
+            length++;
+        }
+        if (length > best_length) {
+            best_length = length;
+            *p_offset = p_compressor->position - candidate;
+            if (length == limit) {
+                break;
+            }
+        }
+    }
+    return best_length;
+}
+
+/**
+ * \fn compress_buffered
+ *
+ * \brief Compresses buffered input into the payload, until the payload is full or (unless flushing) too few bytes are
+ *        buffered to be sure of finding the longest match
+ *
+ * \param p_compressor the compressor
+ * \param flush whether to compress every buffered byte
+ */
+static void compress_buffered(log_compressor_t *const p_compressor, bool flush) {
+    const size_t capacity_bits = (p_compressor->capacity - LOG_COMPRESS_HEADER_SIZE) * 8;
+    while (!p_compressor->full && p_compressor->position < p_compressor->end) {
+        const size_t available = p_compressor->end - p_compressor->position;
+        if (!flush && available < LOG_COMPRESS_MAX_MATCH) {
+            return;
+        }
+
+        size_t offset = 0;
+        size_t length = find_match(p_compressor, available, &offset);
+        const size_t token_bits = (length >= LOG_COMPRESS_MIN_MATCH) ? 1 + LOG_COMPRESS_WINDOW_BITS + LOG_COMPRESS_LENGTH_BITS : 9;
+        if (p_compressor->bit_length + token_bits > capacity_bits || p_compressor->chunk_length + LOG_COMPRESS_MAX_MATCH > UINT16_MAX) {
+            p_compressor->full = true;
+            return;
+        }
+
+        if (length >= LOG_COMPRESS_MIN_MATCH) {
+            put_bits(p_compressor, 0, 1);
+            put_bits(p_compressor, (uint32_t)(offset - 1), LOG_COMPRESS_WINDOW_BITS);
+            put_bits(p_compressor, (uint32_t)(length - LOG_COMPRESS_MIN_MATCH), LOG_COMPRESS_LENGTH_BITS);
+        } else {
+            length = 1;
+            put_bits(p_compressor, 0x100 | p_compressor->buffer[p_compressor->position], 9);
+        }
+        p_compressor->position += (uint16_t)length;
+        p_compressor->chunk_length += (uint32_t)length;
+    }
+}
+
+/**
+ * \fn log_compressor_start
+ *
+ * \brief Starts a new payload. Input given to the previous payload but not compressed into it (see
+ *        `log_compressor_pending()`) is carried over; zero-initialised storage is a compressor with no input.
+ *
+ * \param p_compressor the compressor
+ * \param p_payload buffer for the payload (at least `LOG_COMPRESS_HEADER_SIZE` + 2 bytes, normally
+ *        `LOG_COMPRESS_PAYLOAD_SIZE`)
+ * \param capacity size of `p_payload` in bytes
+ */
+void log_compressor_start(log_compressor_t *const p_compressor, uint8_t *const p_payload, size_t capacity) {
+    p_compressor->chunk_start = p_compressor->position;
+    p_compressor->full = false;
+    p_compressor->p_payload = p_payload;
+    p_compressor->capacity = capacity;
+    p_compressor->bit_length = 0;
+    p_compressor->chunk_length = 0;
+}
+
+/**
+ * \fn log_compressor_sink
+ *
+ * \brief Gives the compressor more input. Stops early once the payload is full.
+ *
+ * \param p_compressor the compressor
+ * \param p_input the input
+ * \param length number of bytes of input
+ *
+ * \returns the number of bytes taken; the rest must be given again after the next `log_compressor_start()`
+ */
+size_t log_compressor_sink(log_compressor_t *const p_compressor, const uint8_t *p_input, size_t length) {
+    size_t taken = 0;
+    while (taken < length && !p_compressor->full) {
+        // Slide the buffer down once it fills, keeping a window of history and the bytes not yet compressed
+        if (p_compressor->end == LOG_COMPRESS_BUFFER_SIZE && p_compressor->position > LOG_COMPRESS_WINDOW_SIZE) {
+            const size_t shift = p_compressor->position - LOG_COMPRESS_WINDOW_SIZE;
+            memmove(p_compressor->buffer, &p_compressor->buffer[shift], LOG_COMPRESS_BUFFER_SIZE - shift);
+            p_compressor->chunk_start = (uint16_t)(p_compressor->chunk_start > shift ? p_compressor->chunk_start - shift : 0);
+            p_compressor->position -= (uint16_t)shift;
+            p_compressor->end -= (uint16_t)shift;
+        }
+
+        const size_t room = LOG_COMPRESS_BUFFER_SIZE - p_compressor->end;
+        const size_t count = (length - taken) < room ? (length - taken) : room;
+        memcpy(&p_compressor->buffer[p_compressor->end], &p_input[taken], count);
+        p_compressor->end += (uint16_t)count;
+        taken += count;
+        compress_buffered(p_compressor, false);
+    }
+    return taken;
+}
+
+/**
+ * \fn log_compressor_finish
+ *
+ * \brief Compresses as much of the remaining input as fits and completes the payload's header
+ *
+ * \param p_compressor the compressor
+ *
+ * \returns the length of the payload in bytes
+ */
+size_t log_compressor_finish(log_compressor_t *const p_compressor) {
+    compress_buffered(p_compressor, true);
+    uint8_t *const p_payload = p_compressor->p_payload;
+    p_payload[0] = LOG_COMPRESS_FORMAT;
+    p_payload[1] = (uint8_t)(p_compressor->chunk_length & 0xFF);
+    p_payload[2] = (uint8_t)(p_compressor->chunk_length >> 8);
+    return LOG_COMPRESS_HEADER_SIZE + (p_compressor->bit_length + 7) / 8;
+}
+
+/**
+ * \fn log_compressor_pending
+ *
+ * \param p_compressor the compressor
+ *
+ * \returns the number of bytes taken as input but not yet compressed into a payload
+ */
+size_t log_compressor_pending(const log_compressor_t *const p_compressor) {
+    return p_compressor->end - p_compressor->position;
+}
@@ -0,0 +1,41 @@
+#ifndef LOG_COMPRESS_H
+#define LOG_COMPRESS_H
+
+// Includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ccsds/spp.h"
+
+// Constants
+#define LOG_COMPRESS_WINDOW_BITS 9  // Back-references reach up to 2^9 = 512 bytes back (within the same payload)
+#define LOG_COMPRESS_LENGTH_BITS 5  // Back-references copy up to 2^5 + 1 = 33 bytes
+#define LOG_COMPRESS_WINDOW_SIZE (1u << LOG_COMPRESS_WINDOW_BITS)
+#define LOG_COMPRESS_MIN_MATCH 2    // Shortest back-reference (15 bits, against 18 for two literals)
+#define LOG_COMPRESS_MAX_MATCH (LOG_COMPRESS_MIN_MATCH + (1u << LOG_COMPRESS_LENGTH_BITS) - 1)
+#define LOG_COMPRESS_BUFFER_SIZE (2 * LOG_COMPRESS_WINDOW_SIZE) // History and lookahead, slid down by a window at a time
+#define LOG_COMPRESS_HEADER_SIZE 3  // Format byte and uncompressed length (u16, little endian) at the start of a payload
+#define LOG_COMPRESS_FORMAT ((LOG_COMPRESS_WINDOW_BITS << 4) | LOG_COMPRESS_LENGTH_BITS)
+#define LOG_COMPRESS_PAYLOAD_SIZE SPP_STANDARD_PACKET_SIZE // Payload size used for downlink
+
+// State of a streaming compressor. Input is compressed into one payload at a time; each payload starts with an empty
+// history, so it can be decompressed on its own even if the payloads before it are lost.
+typedef struct {
+    uint8_t buffer[LOG_COMPRESS_BUFFER_SIZE]; // Input: this payload's history, then bytes not yet compressed
+    uint16_t chunk_start;                     // First byte of this payload's history in `buffer`
+    uint16_t position;                        // Next byte to compress
+    uint16_t end;                             // End of the input in `buffer`
+    bool full;                                // The payload has no room for another token
+    uint8_t *p_payload;                       // Payload being written
+    size_t capacity;                          // Size of `p_payload` in bytes
+    size_t bit_length;                        // Bits written after the header
+    uint32_t chunk_length;                    // Input bytes compressed into this payload
+} log_compressor_t;
+
+void log_compressor_start(log_compressor_t *const p_compressor, uint8_t *const p_payload, size_t capacity);
+size_t log_compressor_sink(log_compressor_t *const p_compressor, const uint8_t *p_input, size_t length);
+size_t log_compressor_finish(log_compressor_t *const p_compressor);
+size_t log_compressor_pending(const log_compressor_t *const p_compressor);
+
+#endif // LOG_COMPRESS_H
@@ -0,0 +1,181 @@
+/**
+ * log_ring.c
+ *
+ * Lock-free ring of pending log messages. Logging calls pack their arguments into a slot here, in a bounded time
+ * that doesn't depend on the consumer, and the Logger task formats and writes them out later (see logger_main.c).
+ *
+ * Each slot carries a sequence number that hands it back and forth between producers and the consumer, so producers
+ * only contend with each other on `enqueue_position`: a compare-and-swap that fails only if another producer (an
+ * interrupt, on this single core) claimed the same position in between. A producer that has claimed a slot but not
+ * yet published it holds up the consumer, never the other producers.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "log_ring.h"
+
+/**
+ * \fn cell_sequence
+ *
+ * \brief Reads a slot's sequence number (stored relative to the slot's index)
+ *
+ * \param p_cell the slot
+ * \param index the slot's index in the ring
+ *
+ * \returns the sequence number
+ */
+static inline uint32_t cell_sequence(const log_ring_cell_t *const p_cell, uint32_t index) {
+    return __atomic_load_n(&p_cell->sequence, __ATOMIC_ACQUIRE) + index;
+}
+
+/**
+ * \fn set_cell_sequence
+ *
+ * \brief Publishes a slot's new sequence number, handing the slot on
+ *
+ * \param p_cell the slot
+ * \param index the slot's index in the ring
+ * \param sequence the new sequence number
+ */
+static inline void set_cell_sequence(log_ring_cell_t *const p_cell, uint32_t index, uint32_t sequence) {
+    __atomic_store_n(&p_cell->sequence, sequence - index, __ATOMIC_RELEASE);
+}
+
+/**
+ * \fn log_ring_push
+ *
+ * \brief Adds a message to the ring, packing its arguments. Never blocks; safe from any task or interrupt.
+ *
+ * \param p_ring the ring
+ * \param kind what `p_source` refers to
+ * \param p_source the message's format string or call-site descriptor
+ * \param ticks tick count when the message was logged
+ * \param format the message's format string (used to pack the arguments)
+ * \param p_args the message's arguments
+ * \param p_was_empty set to true if the ring held no other message when this one was added (so the consumer may be
+ *        asleep and should be woken)
+ *
+ * \returns true if the message was added, false if the ring was full and it was dropped
+ */
+bool log_ring_push(log_ring_t *const p_ring, log_entry_kind_t kind, const void *p_source, uint32_t ticks, const char *format,
+                   va_list *p_args, bool *const p_was_empty) {
+    uint32_t position = __atomic_load_n(&p_ring->enqueue_position, __ATOMIC_RELAXED);
+    log_ring_cell_t *p_cell;
+    while (true) {
+        p_cell = &p_ring->cells[position & LOG_RING_INDEX_MASK];
+        const int32_t lag = (int32_t)(cell_sequence(p_cell, position & LOG_RING_INDEX_MASK) - position);
+        if (lag == 0) {
+            if (__atomic_compare_exchange_n(&p_ring->enqueue_position, &position, position + 1, true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+            // Another producer took this position; `position` now holds the next free one
+        } else if (lag < 0) {
+            // The slot still holds the message from a lap ago: the ring is full
+            __atomic_fetch_add(&p_ring->stats.dropped, 1, __ATOMIC_RELAXED);
+            *p_was_empty = false;
+            return false;
+        } else {
+            position = __atomic_load_n(&p_ring->enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Token records have a smaller payload limit of their own, which the decoder relies on
+    const size_t capacity = (kind == LOG_ENTRY_TOKEN) ? LOG_TOKEN_MAX_PAYLOAD : LOG_RING_MAX_PAYLOAD;
+    log_entry_t *const p_entry = &p_cell->entry;
+    bool truncated = false;
+    p_entry->p_source = p_source;
+    p_entry->ticks = ticks;
+    p_entry->kind = (uint8_t)kind;
+    p_entry->payload_length = (uint8_t)log_token_encode_args(format, p_args, p_entry->payload, capacity, &truncated);
+    set_cell_sequence(p_cell, position & LOG_RING_INDEX_MASK, position + 1);
+
+    const uint32_t depth = position + 1 - __atomic_load_n(&p_ring->dequeue_position, __ATOMIC_ACQUIRE);
+    *p_was_empty = depth == 1;
+    __atomic_fetch_add(&p_ring->stats.pushed, 1, __ATOMIC_RELAXED);
+    if (truncated) {
+        __atomic_fetch_add(&p_ring->stats.truncated, 1, __ATOMIC_RELAXED);
+    }
+    if (depth > __atomic_load_n(&p_ring->stats.max_depth, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&p_ring->stats.max_depth, depth, __ATOMIC_RELAXED); // A racing producer may undercount by one
+    }
+    return true;
+}
+
+/**
+ * \fn log_ring_pop
+ *
+ * \brief Takes the oldest message out of the ring. Only the context holding the consumer lock may call this.
+ *
+ * \param p_ring the ring
+ * \param p_entry where to copy the message
+ *
+ * \returns true if a message was taken, false if the ring is empty (or its oldest message is still being added)
+ */
+bool log_ring_pop(log_ring_t *const p_ring, log_entry_t *const p_entry) {
+    const uint32_t position = p_ring->dequeue_position;
+    const uint32_t index = position & LOG_RING_INDEX_MASK;
+    log_ring_cell_t *const p_cell = &p_ring->cells[index];
+    if ((int32_t)(cell_sequence(p_cell, index) - (position + 1)) < 0) {
+        return false;
+    }
+
+    *p_entry = p_cell->entry;
+    set_cell_sequence(p_cell, index, position + LOG_RING_CAPACITY);
+    __atomic_store_n(&p_ring->dequeue_position, position + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * \fn log_ring_is_empty
+ *
+ * \brief Checks whether any message is waiting (or being added)
+ *
+ * \param p_ring the ring
+ *
+ * \returns true if no message is waiting
+ */
+bool log_ring_is_empty(const log_ring_t *const p_ring) {
+    return __atomic_load_n(&p_ring->enqueue_position, __ATOMIC_ACQUIRE) == __atomic_load_n(&p_ring->dequeue_position, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * \fn log_ring_lock_consumer
+ *
+ * \brief Claims the consumer side of the ring. Normally the Logger task holds it while draining, but a context that is
+ *        about to reset the system (`fatal()`, a fault handler) drains the ring itself first.
+ *
+ * \param p_ring the ring
+ *
+ * \returns true if the caller is now the consumer, false if another context is draining the ring
+ */
+bool log_ring_lock_consumer(log_ring_t *const p_ring) {
+    return __atomic_exchange_n(&p_ring->consumer_busy, 1, __ATOMIC_ACQUIRE) == 0;
+}
+
+/**
+ * \fn log_ring_unlock_consumer
+ *
+ * \brief Releases the consumer side of the ring, claimed with `log_ring_lock_consumer()`
+ *
+ * \param p_ring the ring
+ */
+void log_ring_unlock_consumer(log_ring_t *const p_ring) {
+    __atomic_store_n(&p_ring->consumer_busy, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * \fn get_log_ring_stats
+ *
+ * \brief Copies the ring's totals
+ *
+ * \param p_ring the ring
+ * \param p_stats where to copy the totals
+ */
+void get_log_ring_stats(const log_ring_t *const p_ring, log_ring_stats_t *const p_stats) {
+    p_stats->pushed = __atomic_load_n(&p_ring->stats.pushed, __ATOMIC_RELAXED);
+    p_stats->dropped = __atomic_load_n(&p_ring->stats.dropped, __ATOMIC_RELAXED);
+    p_stats->truncated = __atomic_load_n(&p_ring->stats.truncated, __ATOMIC_RELAXED);
+    p_stats->max_depth = __atomic_load_n(&p_ring->stats.max_depth, __ATOMIC_RELAXED);
+}
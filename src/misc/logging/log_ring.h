@@ -0,0 +1,70 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+// Includes
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "log_tokens.h"
+
+// Constants
+#define LOG_RING_CAPACITY 32    // Messages the ring holds before new ones are dropped (power of two)
+#define LOG_RING_MAX_PAYLOAD 96 // Argument bytes kept per text message (text messages also carry the file name)
+#define LOG_RING_INDEX_MASK (LOG_RING_CAPACITY - 1)
+
+_Static_assert((LOG_RING_CAPACITY & (LOG_RING_CAPACITY - 1)) == 0, "log ring capacity must be a power of two");
+_Static_assert(LOG_RING_MAX_PAYLOAD >= LOG_TOKEN_MAX_PAYLOAD && LOG_RING_MAX_PAYLOAD <= UINT8_MAX, "log ring payload size out of range");
+
+// What a message's source pointer refers to
+typedef enum {
+    LOG_ENTRY_TEXT = 0, // A format string, printed as text
+    LOG_ENTRY_TOKEN,    // A call-site descriptor (log_site_t), sent as a tokenized record
+} log_entry_kind_t;
+
+// One message, with its arguments packed so that it can be formatted later
+typedef struct {
+    const void *p_source;                  // Format string or call-site descriptor (see `kind`); must outlive the message
+    uint32_t ticks;                        // Tick count when the message was logged
+    uint8_t kind;                          // log_entry_kind_t
+    uint8_t payload_length;                // Bytes used in `payload`
+    uint8_t payload[LOG_RING_MAX_PAYLOAD]; // Packed arguments (see log_tokens.c for the layout)
+} log_entry_t;
+
+// A slot in the ring. `sequence` says whose turn it is: a producer may fill the slot when it equals the producer's
+// position, and the consumer may empty it once it is one past. It is stored relative to the slot's index so that a
+// zeroed ring (as in .bss) is already empty and ready.
+typedef struct {
+    uint32_t sequence;
+    log_entry_t entry;
+} log_ring_cell_t;
+
+// Totals for a log ring
+typedef struct {
+    uint32_t pushed;    // Messages added
+    uint32_t dropped;   // Messages lost because the ring was full
+    uint32_t truncated; // Messages whose arguments did not all fit in the payload
+    uint32_t max_depth; // Most messages waiting at once
+} log_ring_stats_t;
+
+// Bounded multi-producer, single-consumer queue of log messages (after D. Vyukov's bounded MPMC queue). Producers in
+// any context, interrupts included, claim a slot with one compare-and-swap and never wait for each other or for the
+// consumer; a full ring drops the message. Zero-initialised storage is an empty ring.
+typedef struct {
+    log_ring_cell_t cells[LOG_RING_CAPACITY];
+    uint32_t enqueue_position; // Next position claimed by a producer
+    uint32_t dequeue_position; // Next position read by the consumer
+    uint32_t consumer_busy;    // Set while a context is draining the ring (see `log_ring_lock_consumer()`)
+    log_ring_stats_t stats;
+} log_ring_t;
+
+bool log_ring_push(log_ring_t *const p_ring, log_entry_kind_t kind, const void *p_source, uint32_t ticks, const char *format,
+                   va_list *p_args, bool *const p_was_empty);
+bool log_ring_pop(log_ring_t *const p_ring, log_entry_t *const p_entry);
+bool log_ring_is_empty(const log_ring_t *const p_ring);
+bool log_ring_lock_consumer(log_ring_t *const p_ring);
+void log_ring_unlock_consumer(log_ring_t *const p_ring);
+void get_log_ring_stats(const log_ring_t *const p_ring, log_ring_stats_t *const p_stats);
+
+#endif // LOG_RING_H
@@ -0,0 +1,242 @@
+/**
+ * log_tokens.c
+ *
+ * Tokenized logging for PVDXos. Instead of formatting text on the target, each logging call writes one short binary
+ * record to the log channel: the index of its call-site descriptor (built at compile time, see log_tokens.h), the tick
+ * count and the raw values of its arguments. scripts/rtt_logs.py rebuilds the text from the descriptors in the ELF.
+ *
+ * Record layout (little endian):
+ *   u8  LOG_TOKEN_SYNC_BYTE
+ *   u16 token, the index of the call site's descriptor in .pvdx_log_sites
+ *   u32 tick count when the message was logged
+ *   u8  payload length
+ *   payload, one entry per conversion in the format string: u32 for %c %d %u %x %X %p, and a u8 length followed by
+ *   that many characters (no terminator) for %s
+ *
+ * Once the Logger task is running, a call only packs its arguments into the log ring (log_ring.c) and the Logger task
+ * writes the record later, with the tick count of the original call.
+ *
+ * Each record goes to RTT in a single write, so in SEGGER_RTT_MODE_NO_BLOCK_SKIP a record is either sent whole or
+ * dropped whole, and the stream never loses its framing.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "log_tokens.h"
+
+#include <string.h>
+
+#include "atmel_start.h"
+#include "crash_log.h"
+#include "logging.h"
+#include "watchdog_task.h"
+
+// Start of .pvdx_log_sites, defined in src_ram.ld
+extern const log_site_t __log_sites_start[];
+
+static log_token_stats_t log_token_stats = {0};
+
+// Sent by `fatal()` after its own message, as the text build does
+static const log_site_t LOG_SITE_ATTRIBUTES fatal_restart_site = {
+    "FATAL ERROR OCCURRED! RESTARTING SYSTEM...\n", __FILENAME__, __LINE__, LOG_KIND_WARNING, 0};
+
+/**
+ * \fn put_u32
+ *
+ * \brief Stores a 32-bit value little endian
+ *
+ * \param p_bytes where to store the value (4 bytes)
+ * \param value the value to store
+ */
+static inline void put_u32(uint8_t *const p_bytes, uint32_t value) {
+    p_bytes[0] = (uint8_t)value;
+    p_bytes[1] = (uint8_t)(value >> 8);
+    p_bytes[2] = (uint8_t)(value >> 16);
+    p_bytes[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * \fn log_token_encode_args
+ *
+ * \brief Packs the arguments of a logging call into a record payload. The format string is parsed the way
+ *        SEGGER_RTT_vprintf parses it (flags, width, precision and the `l`/`h` modifiers are skipped), so a format
+ *        string prints the same whether the build is tokenized or not.
+ *
+ * \param format the call site's format string
+ * \param p_args the arguments, read in order
+ * \param p_payload where to pack the arguments
+ * \param capacity size of `p_payload` in bytes
+ * \param p_truncated set to true if an argument was dropped or a string cut short to fit, otherwise left unchanged
+ *
+ * \returns the number of bytes packed
+ */
+size_t log_token_encode_args(const char *format, va_list *p_args, uint8_t *const p_payload, size_t capacity, bool *const p_truncated) {
+    size_t length = 0;
+    while (*format != '\0') {
+        if (*format++ != '%') {
+            continue;
+        }
+        while (*format == '-' || *format == '0' || *format == '+' || *format == '#') {
+            format++;
+        }
+        while ((*format >= '0' && *format <= '9') || *format == '.') {
+            format++;
+        }
+        while (*format == 'l' || *format == 'h') {
+            format++;
+        }
+
+        const char conversion = *format;
+        if (conversion == '\0') {
+            break;
+        }
+        format++;
+
+        switch (conversion) {
+            case 'c':
+            case 'd':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'p':
+                if (capacity - length < sizeof(uint32_t)) {
+                    *p_truncated = true;
+                    return length;
+                }
+                put_u32(&p_payload[length], (uint32_t)va_arg(*p_args, int));
+                length += sizeof(uint32_t);
+                break;
+            case 's': {
+                const char *string = va_arg(*p_args, const char *);
+                if (capacity - length < 1) {
+                    *p_truncated = true;
+                    return length;
+                }
+                size_t max_length = capacity - length - 1;
+                if (max_length > LOG_TOKEN_MAX_STRING_LENGTH) {
+                    max_length = LOG_TOKEN_MAX_STRING_LENGTH;
+                }
+                size_t string_length = 0;
+                while (string != NULL && string_length <= max_length && string[string_length] != '\0') {
+                    string_length++;
+                }
+                if (string_length > max_length) {
+                    string_length = max_length;
+                    *p_truncated = true;
+                }
+                p_payload[length++] = (uint8_t)string_length;
+                memcpy(&p_payload[length], string, string_length);
+                length += string_length;
+                break;
+            }
+            default:
+                // '%%' and conversions SEGGER_RTT_vprintf doesn't know take no argument
+                break;
+        }
+    }
+    return length;
+}
+
+/**
+ * \fn log_token_write_record
+ *
+ * \brief Writes one record to the log channel, in a single write. Safe to call from interrupts.
+ *
+ * \param p_site the call site's descriptor (in .pvdx_log_sites)
+ * \param ticks tick count when the message was logged
+ * \param p_payload the packed arguments
+ * \param payload_length size of `p_payload` in bytes (at most LOG_TOKEN_MAX_PAYLOAD)
+ */
+void log_token_write_record(const log_site_t *const p_site, uint32_t ticks, const uint8_t *const p_payload, size_t payload_length) {
+    uint8_t record[LOG_TOKEN_MAX_RECORD_SIZE];
+    const uint16_t token = (uint16_t)(p_site - __log_sites_start);
+    record[0] = LOG_TOKEN_SYNC_BYTE;
+    record[1] = (uint8_t)token;
+    record[2] = (uint8_t)(token >> 8);
+    put_u32(&record[3], ticks);
+    record[7] = (uint8_t)payload_length;
+    if (payload_length > 0) {
+        memcpy(&record[LOG_TOKEN_HEADER_SIZE], p_payload, payload_length);
+    }
+
+    const unsigned record_length = LOG_TOKEN_HEADER_SIZE + payload_length;
+    const UBaseType_t interrupt_mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    const unsigned written = SEGGER_RTT_Write(LOGGING_RTT_OUTPUT_CHANNEL, record, record_length);
+    if (written == record_length) {
+        log_token_stats.records++;
+        log_token_stats.bytes_written += written;
+    } else {
+        log_token_stats.dropped++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(interrupt_mask);
+}
+
+/**
+ * \fn log_token_write_now
+ *
+ * \brief Packs and writes the record for one logging call straight away, after any messages still waiting for the
+ *        Logger task
+ *
+ * \param p_site the call site's descriptor (in .pvdx_log_sites)
+ * \param p_args the call's arguments
+ */
+static void log_token_write_now(const log_site_t *const p_site, va_list *p_args) {
+    uint8_t payload[LOG_TOKEN_MAX_PAYLOAD];
+    bool truncated = false;
+    const size_t payload_length = log_token_encode_args(p_site->format, p_args, payload, sizeof(payload), &truncated);
+    if (truncated) {
+        __atomic_fetch_add(&log_token_stats.truncated, 1, __ATOMIC_RELAXED);
+    }
+    drain_log_ring();
+    log_token_write_record(p_site, log_tick_count(), payload, payload_length);
+}
+
+/**
+ * \fn log_tokenized_impl
+ *
+ * \brief Logs one call (the logging macros have already checked its level). The record is left to the Logger task
+ *        once it is running, except for `fatal()`, which is written out straight away. Fatal errors and warnings are
+ *        also written to the crash log. Safe to call from interrupts.
+ *
+ * \param p_site the call site's descriptor (in .pvdx_log_sites)
+ * \param ... the call's arguments
+ */
+void log_tokenized_impl(const log_site_t *const p_site, ...) {
+    va_list args;
+    va_start(args, p_site);
+    if (p_site->kind == LOG_KIND_FATAL || p_site->kind == LOG_KIND_WARNING) {
+        va_list crash_args;
+        va_copy(crash_args, args);
+        append_crash_log((log_kind_t)p_site->kind, p_site->file, p_site->line, p_site->format, &crash_args);
+        va_end(crash_args);
+    }
+    if (p_site->kind != LOG_KIND_FATAL && logging_deferred()) {
+        log_deferred(LOG_ENTRY_TOKEN, p_site, p_site->format, &args);
+        va_end(args);
+        return;
+    }
+    log_token_write_now(p_site, &args);
+    va_end(args);
+
+    if (p_site->kind == LOG_KIND_FATAL) {
+        // The reason for the reset is kept in the crash log, so there's no need to wait for RTT to be read
+        log_token_write_record(&fatal_restart_site, log_tick_count(), NULL, 0);
+
+        // Force reboot
+        kick_watchdog();
+    }
+}
+
+/**
+ * \fn get_log_token_stats
+ *
+ * \brief Copies the totals for the tokenized records written so far
+ *
+ * \param p_stats where to copy the totals
+ */
+void get_log_token_stats(log_token_stats_t *const p_stats) {
+    taskENTER_CRITICAL();
+    *p_stats = log_token_stats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,63 @@
+#ifndef LOG_TOKENS_H
+#define LOG_TOKENS_H
+
+// Includes
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define LOG_TOKEN_SYNC_BYTE 0xA5       // Starts every record, so the decoder can find its place again after a gap
+#define LOG_TOKEN_HEADER_SIZE 8        // Sync byte, call-site token (u16), tick count (u32) and payload length (u8)
+#define LOG_TOKEN_MAX_PAYLOAD 64       // Most argument bytes kept per record; arguments past this are dropped
+#define LOG_TOKEN_MAX_STRING_LENGTH 32 // Longest `%s` argument kept; longer strings are cut short
+#define LOG_TOKEN_MAX_RECORD_SIZE (LOG_TOKEN_HEADER_SIZE + LOG_TOKEN_MAX_PAYLOAD)
+
+// Places a call-site descriptor in the flash section bounded by __log_sites_start/__log_sites_end in src_ram.ld. Not
+// marked `used`, so descriptors of calls that are compiled out (see LOG_MODULE_FLOOR in logging.h) don't take a token.
+#define LOG_SITE_ATTRIBUTES __attribute__((section(".pvdx_log_sites")))
+
+// Which logging macro a call site used; decides the level it is filtered at and the label the decoder prints
+typedef enum {
+    LOG_KIND_FATAL = 0,
+    LOG_KIND_WARNING,
+    LOG_KIND_EVENT,
+    LOG_KIND_INFO,
+    LOG_KIND_DEBUG,
+    LOG_KIND_TEST,
+} log_kind_t;
+
+// Everything about a logging call that is known at build time. One is placed in .pvdx_log_sites per call site, and
+// its index in that section is the token sent in place of the text (scripts/rtt_logs.py reads them back from the ELF).
+typedef struct {
+    const char *format; // printf-style format string (the SEGGER_RTT_printf subset: %c %d %u %x %X %p %s)
+    const char *file;   // __FILENAME__ of the call site
+    uint16_t line;      // __LINE__ of the call site
+    uint8_t kind;       // log_kind_t of the call site
+    uint8_t reserved;   // Padding, always zero
+} log_site_t;
+
+_Static_assert(sizeof(log_site_t) == 12, "scripts/rtt_logs.py assumes 12-byte call-site descriptors");
+
+// Logs through a descriptor for this call site (how the logging macros in logging.h expand in tokenized builds)
+#define log_tokenized(kind, msg, ...)                                                                                                      \
+    do {                                                                                                                                   \
+        static const log_site_t LOG_SITE_ATTRIBUTES log_site = {msg, __FILENAME__, __LINE__, kind, 0};                                     \
+        log_tokenized_impl(&log_site, ##__VA_ARGS__);                                                                                      \
+    } while (0)
+
+// Totals for the tokenized records written to the log channel
+typedef struct {
+    uint32_t records;       // Records written
+    uint32_t dropped;       // Records the RTT buffer had no room for (NO_BLOCK_SKIP mode drops the whole record)
+    uint32_t truncated;     // Records whose arguments did not all fit in LOG_TOKEN_MAX_PAYLOAD
+    uint64_t bytes_written; // Bytes written, headers included
+} log_token_stats_t;
+
+size_t log_token_encode_args(const char *format, va_list *p_args, uint8_t *const p_payload, size_t capacity, bool *const p_truncated);
+void log_token_write_record(const log_site_t *const p_site, uint32_t ticks, const uint8_t *const p_payload, size_t payload_length);
+void log_tokenized_impl(const log_site_t *const p_site, ...);
+void get_log_token_stats(log_token_stats_t *const p_stats);
+
+#endif // LOG_TOKENS_H
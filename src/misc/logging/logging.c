@@ -4,6 +4,9 @@
  * Logging functions for PVDXos. These functions allow for different log levels to be printed to the terminal
  * which can be filtered out based on the desired verbosity of the output.
  *
+ * Once the Logger task is running, messages are not written out by the caller: their arguments are packed into a
+ * lock-free ring (log_ring.c) and the Logger task formats and writes them out when nothing more important is running.
+ *
  * Created: February 25, 2024
  * Authors: Oren Kohavi, Guo Ma, Siddharta Laloux, Yi Liu
  */
@@ -12,26 +15,356 @@
 
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "SEGGER_RTT.h"
+#include "atmel_start.h"
+#include "crash_log.h"
 #include "watchdog_task.h"
 
 // Macros for debugging functions so that file and line number info can be included
+// The level checks happen in the macros (see logging.h), before the arguments are evaluated, so the *_impl functions
+// print whatever reaches them
+
+// Bounds of .pvdx_log_modules, defined in src_ram.ld
+extern log_module_t __log_modules_start[];
+extern log_module_t __log_modules_end[];
 
 log_level_t LOG_LEVEL = DEFAULT_LOG_LEVEL;
 uint8_t SEGGER_RTT_LOG_BUFFER[SEGGER_RTT_LOG_BUFFER_SIZE];
 
+// Messages waiting for the Logger task, and the task to wake when the first one arrives (NULL until it starts)
+static log_ring_t log_ring;
+static TaskHandle_t log_consumer = NULL;
+
+// Text of the message being written out (only used by the context holding the ring's consumer lock)
+static char log_text[LOG_TEXT_MAX_LENGTH];
+
+/**
+ * \fn log_tick_count
+ *
+ * \brief Reads the tick count from a task or an interrupt
+ *
+ * \returns the tick count
+ */
+uint32_t log_tick_count(void) {
+    return (__get_IPSR() != 0) ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+}
+
+/**
+ * \fn logging_deferred
+ *
+ * \brief Checks whether messages logged now should go through the ring. They are written out directly before the
+ *        Logger task starts, and from fault handlers and the NMI, after which no task will run again.
+ *
+ * \returns true if messages should be left to the Logger task
+ */
+bool logging_deferred(void) {
+    const uint32_t exception = __get_IPSR();
+    const bool in_fault = exception >= LOG_FIRST_FAULT_EXCEPTION && exception <= LOG_LAST_FAULT_EXCEPTION;
+    return !in_fault && log_consumer != NULL && xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED;
+}
+
+/**
+ * \fn log_deferred
+ *
+ * \brief Adds a message to the ring for the Logger task, waking it if the ring was empty
+ *
+ * \param kind what `p_source` refers to
+ * \param p_source the message's format string or call-site descriptor
+ * \param format the message's format string
+ * \param p_args the message's arguments
+ */
+void log_deferred(log_entry_kind_t kind, const void *p_source, const char *format, va_list *p_args) {
+    bool was_empty = false;
+    if (!log_ring_push(&log_ring, kind, p_source, log_tick_count(), format, p_args, &was_empty) || !was_empty) {
+        return;
+    }
+    // Read once, since a Logger being restarted is taken off it (see `stop_deferred_logging()`)
+    const TaskHandle_t consumer = log_consumer;
+    if (consumer == NULL) {
+        return;
+    }
+    if (__get_IPSR() != 0) {
+        // The Logger task is the lowest priority task, so there's no point asking for a context switch
+        vTaskNotifyGiveFromISR(consumer, NULL);
+    } else {
+        xTaskNotifyGive(consumer);
+    }
+}
+
+/**
+ * \fn start_deferred_logging
+ *
+ * \brief Sends messages logged from now on through the ring, for the given task to write out with
+ *        `drain_log_ring()` whenever it is notified. Called again by a restarted Logger task.
+ *
+ * \param consumer the Logger task
+ */
+void start_deferred_logging(TaskHandle_t consumer) {
+    log_consumer = consumer;
+}
+
+/**
+ * \fn stop_deferred_logging
+ *
+ * \brief Writes messages out directly again if the given task is the Logger, so that nothing notifies it once it is
+ *        deleted. Called by `task_manager_restart_task()` before deleting any task; the restarted Logger calls
+ *        `start_deferred_logging()` again.
+ *
+ * \param task the task about to be deleted
+ *
+ * \warning must be called with the scheduler suspended, so that the Logger can't run again before it is deleted
+ */
+void stop_deferred_logging(TaskHandle_t task) {
+    if (task == NULL || log_consumer != task) {
+        return;
+    }
+    log_consumer = NULL;
+    // A Logger deleted part-way through draining never releases the consumer side
+    log_ring_unlock_consumer(&log_ring);
+}
+
+/**
+ * \fn put_char
+ *
+ * \brief Appends a character to a bounded text buffer, dropping it if the buffer is full
+ */
+static inline void put_char(char *const p_text, size_t capacity, size_t *const p_length, char c) {
+    if (*p_length < capacity) {
+        p_text[(*p_length)++] = c;
+    }
+}
+
+/**
+ * \fn put_number
+ *
+ * \brief Appends a number the way SEGGER_RTT_vprintf prints it: upper-case hex digits, `precision` as the minimum
+ *        number of digits, padded to `width`
+ */
+static void put_number(char *const p_text, size_t capacity, size_t *const p_length, uint32_t magnitude, bool negative, uint32_t base,
+                       uint32_t precision, uint32_t width, uint32_t flags) {
+    char digits[10];
+    size_t num_digits = 0;
+    do {
+        digits[num_digits++] = "0123456789ABCDEF"[magnitude % base];
+        magnitude /= base;
+    } while (magnitude != 0);
+
+    const char sign = negative ? '-' : ((flags & LOG_FORMAT_FLAG_SIGN) ? '+' : '\0');
+    const size_t zeros = (precision > num_digits) ? precision - num_digits : 0;
+    const size_t used = num_digits + zeros + (sign != '\0' ? 1 : 0);
+    size_t padding = (width > used) ? width - used : 0;
+    const bool pad_with_zeros = (flags & LOG_FORMAT_FLAG_ZERO) && !(flags & LOG_FORMAT_FLAG_LEFT) && precision == 0;
+
+    if (!(flags & LOG_FORMAT_FLAG_LEFT) && !pad_with_zeros) {
+        for (; padding > 0; padding--) {
+            put_char(p_text, capacity, p_length, ' ');
+        }
+    }
+    if (sign != '\0') {
+        put_char(p_text, capacity, p_length, sign);
+    }
+    if (pad_with_zeros) {
+        for (; padding > 0; padding--) {
+            put_char(p_text, capacity, p_length, '0');
+        }
+    }
+    for (size_t i = 0; i < zeros; i++) {
+        put_char(p_text, capacity, p_length, '0');
+    }
+    while (num_digits > 0) {
+        put_char(p_text, capacity, p_length, digits[--num_digits]);
+    }
+    for (; padding > 0; padding--) {
+        put_char(p_text, capacity, p_length, ' ');
+    }
+}
+
+/**
+ * \fn log_format_payload
+ *
+ * \brief Prints a message from its format string and packed arguments (see `log_token_encode_args()`), giving the
+ *        same text SEGGER_RTT_vprintf would have given for the original arguments. Conversions whose argument didn't
+ *        fit in the payload print nothing.
+ *
+ * \param format the message's format string
+ * \param p_payload the packed arguments
+ * \param payload_length size of `p_payload` in bytes
+ * \param p_text where to print the text (not terminated)
+ * \param capacity size of `p_text`; text past it is cut off
+ *
+ * \returns the length of the text
+ */
+size_t log_format_payload(const char *format, const uint8_t *const p_payload, size_t payload_length, char *const p_text, size_t capacity) {
+    size_t length = 0;
+    size_t position = 0;
+    while (*format != '\0') {
+        const char c = *format++;
+        if (c != '%') {
+            put_char(p_text, capacity, &length, c);
+            continue;
+        }
+
+        uint32_t flags = 0;
+        while (*format == '-' || *format == '0' || *format == '+' || *format == '#') {
+            if (*format == '-') {
+                flags |= LOG_FORMAT_FLAG_LEFT;
+            } else if (*format == '0') {
+                flags |= LOG_FORMAT_FLAG_ZERO;
+            } else if (*format == '+') {
+                flags |= LOG_FORMAT_FLAG_SIGN;
+            }
+            format++;
+        }
+        uint32_t width = 0;
+        while (*format >= '0' && *format <= '9') {
+            width = width * 10 + (uint32_t)(*format++ - '0');
+        }
+        uint32_t precision = 0;
+        if (*format == '.') {
+            format++;
+            while (*format >= '0' && *format <= '9') {
+                precision = precision * 10 + (uint32_t)(*format++ - '0');
+            }
+        }
+        while (*format == 'l' || *format == 'h') {
+            format++;
+        }
+
+        const char conversion = *format;
+        if (conversion == '\0') {
+            break;
+        }
+        format++;
+
+        if (conversion == '%') {
+            put_char(p_text, capacity, &length, '%');
+        } else if (conversion == 's') {
+            if (position < payload_length) {
+                const size_t string_length = p_payload[position++];
+                for (size_t i = 0; i < string_length && position < payload_length; i++) {
+                    put_char(p_text, capacity, &length, (char)p_payload[position++]);
+                }
+            }
+        } else if (strchr("cduxXp", conversion) != NULL && position + sizeof(uint32_t) <= payload_length) {
+            const uint32_t value = (uint32_t)p_payload[position] | ((uint32_t)p_payload[position + 1] << 8) |
+                                   ((uint32_t)p_payload[position + 2] << 16) | ((uint32_t)p_payload[position + 3] << 24);
+            position += sizeof(uint32_t);
+            if (conversion == 'c') {
+                put_char(p_text, capacity, &length, (char)value);
+            } else if (conversion == 'd') {
+                const bool negative = (int32_t)value < 0;
+                put_number(p_text, capacity, &length, negative ? 0u - value : value, negative, 10, precision, width, flags);
+            } else if (conversion == 'u') {
+                put_number(p_text, capacity, &length, value, false, 10, precision, width, flags);
+            } else if (conversion == 'p') {
+                put_number(p_text, capacity, &length, value, false, 16, 8, 8, 0);
+            } else {
+                put_number(p_text, capacity, &length, value, false, 16, precision, width, flags);
+            }
+        }
+    }
+    return length;
+}
+
+/**
+ * \fn write_log_entry
+ *
+ * \brief Writes one message from the ring to the log channel
+ *
+ * \param p_entry the message
+ */
+static void write_log_entry(const log_entry_t *const p_entry) {
+    if (p_entry->kind == LOG_ENTRY_TOKEN) {
+        log_token_write_record(p_entry->p_source, p_entry->ticks, p_entry->payload, p_entry->payload_length);
+        return;
+    }
+    const size_t length = log_format_payload(p_entry->p_source, p_entry->payload, p_entry->payload_length, log_text, sizeof(log_text));
+    // One write per message, so that NO_BLOCK_SKIP mode drops whole messages rather than parts of them
+    SEGGER_RTT_Write(LOGGING_RTT_OUTPUT_CHANNEL, log_text, length);
+}
+
+/**
+ * \fn drain_log_ring
+ *
+ * \brief Writes out the messages waiting in the ring, oldest first, but no more than `LOG_RING_CAPACITY` of them, so
+ *        that a flood of new messages can't keep the caller here indefinitely. Called by the Logger task, and by
+ *        `fatal()` and direct writes so that earlier messages come out first. Does nothing if another context is
+ *        already draining.
+ *
+ * \returns the number of messages written (`LOG_RING_CAPACITY` if more may be waiting)
+ */
+size_t drain_log_ring(void) {
+    if (!log_ring_lock_consumer(&log_ring)) {
+        return 0;
+    }
+    log_entry_t entry;
+    size_t written = 0;
+    while (written < LOG_RING_CAPACITY && log_ring_pop(&log_ring, &entry)) {
+        write_log_entry(&entry);
+        written++;
+    }
+    log_ring_unlock_consumer(&log_ring);
+    return written;
+}
+
+/**
+ * \fn get_log_ring_totals
+ *
+ * \brief Copies the totals of the ring of messages waiting for the Logger task
+ *
+ * \param p_stats where to copy the totals
+ */
+void get_log_ring_totals(log_ring_stats_t *const p_stats) {
+    get_log_ring_stats(&log_ring, p_stats);
+}
+
+/**
+ * \fn log_text_message
+ *
+ * \brief Leaves a text message to the Logger task, or writes it out now if logging isn't deferred
+ *
+ * \param format the message's format string (must outlive the message, as string literals do)
+ * \param p_args the message's arguments
+ */
+static void log_text_message(const char *format, va_list *p_args) {
+    if (logging_deferred()) {
+        log_deferred(LOG_ENTRY_TEXT, format, format, p_args);
+    } else {
+        drain_log_ring();
+        SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, format, p_args);
+    }
+}
+
+/**
+ * \fn log_text_now
+ *
+ * \brief Writes a text message out straight away, after any messages still in the ring
+ */
+static void log_text_now(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    drain_log_ring();
+    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, format, &args);
+    va_end(args);
+}
+
 void fatal_impl(const char *string, ...) {
     // No log level checking here, since fatal should always be printed
     va_list args;
+    va_list crash_args;
     va_start(args, string);
-    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, string, &args); // Use vprintf to print with variable arguments
+    va_copy(crash_args, args);
 
-    // To make sure that the message is printed before the watchdog resets the system, print a few more.
-    warning_impl("FATAL ERROR OCCURRED! RESTARTING SYSTEM...\n");
-    warning_impl("FATAL ERROR OCCURRED! RESTARTING SYSTEM...\n");
-    warning_impl("FATAL ERROR OCCURRED! RESTARTING SYSTEM...\n");
-    vTaskDelay(pdMS_TO_TICKS(1000)); // Wait for the message to be printed
+    // The reason for the reset is kept in backup RAM for the next boot, so nothing depends on RTT being read in time
+    append_crash_log(LOG_KIND_FATAL, NULL, 0, string, &crash_args);
+    va_end(crash_args);
+
+    // The system is about to reset, so don't leave anything to the Logger task
+    drain_log_ring();
+    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, string, &args); // Use vprintf to print with variable arguments
+    log_text_now("FATAL ERROR OCCURRED! RESTARTING SYSTEM...\n");
 
     // Force reboot
     kick_watchdog();
@@ -40,55 +373,101 @@ void fatal_impl(const char *string, ...) {
     va_end(args);
 }
 
-void fatal_no_log_impl(void) {
+void fatal_no_log_impl(const char *file, uint32_t line, const char *string, ...) {
+    // Nothing is printed, but the reason for the reset is still kept in backup RAM for the next boot
+    va_list args;
+    va_start(args, string);
+    append_crash_log(LOG_KIND_FATAL, file, line, string, &args);
+
     // Force reboot
     kick_watchdog();
+
+    // This line should never be reached, but we include it to adhere to the va_list contract
+    va_end(args);
 }
 
 void warning_impl(const char *string, ...) {
     // No log level checking here, since warning should always be printed
     va_list args;
+    va_list crash_args;
     va_start(args, string);
-    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, string, &args); // Use vprintf to print with variable arguments
-
+    va_copy(crash_args, args);
+    append_crash_log(LOG_KIND_WARNING, NULL, 0, string, &crash_args);
+    va_end(crash_args);
+    log_text_message(string, &args);
     va_end(args);
 }
 
 void event_impl(const char *string, ...) {
-    // Check if the log level is high enough to print this message
-    if (EVENT < LOG_LEVEL) {
-        return;
-    }
     va_list args;
     va_start(args, string);
-    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, string, &args); // Use vprintf to print with variable arguments
+    log_text_message(string, &args);
     va_end(args);
 }
 
 void info_impl(char *string, ...) {
-    // Check if the log level is high enough to print this message
-    if (INFO < LOG_LEVEL) {
-        return;
-    }
     va_list args;
     va_start(args, string);
-    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, string, &args); // Use vprintf to print with variable arguments
+    log_text_message(string, &args);
     va_end(args);
 }
 
 void debug_impl(const char *string, ...) {
-    // Check if the log level is high enough to print this message
-    if (DEBUG < LOG_LEVEL) {
-        return;
-    }
     va_list args;
     va_start(args, string);
-    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, string, &args); // Use vprintf to print with variable arguments
+    log_text_message(string, &args);
     va_end(args);
 }
 
+/**
+ * \fn set_log_level
+ *
+ * \brief Sets the run-time log level of every module
+ *
+ * \param level the new level
+ */
 void set_log_level(log_level_t level) {
     LOG_LEVEL = level;
+    for (log_module_t *p_module = __log_modules_start; p_module < __log_modules_end; p_module++) {
+        p_module->level = (uint8_t)level;
+    }
+}
+
+/**
+ * \fn set_module_log_level
+ *
+ * \brief Sets the run-time log level of one module. Messages below the module's compile-time floor stay compiled out.
+ *
+ * \param name the module's file name, with or without the extension (e.g. "adcs_main.c" or "adcs_main")
+ * \param level the new level
+ *
+ * \returns the number of modules matched (0 if there is no such module)
+ */
+size_t set_module_log_level(const char *const name, log_level_t level) {
+    const size_t name_length = strlen(name);
+    size_t matched = 0;
+    for (log_module_t *p_module = __log_modules_start; p_module < __log_modules_end; p_module++) {
+        const char *const module_name = p_module->name;
+        if (strncmp(module_name, name, name_length) == 0 && (module_name[name_length] == '\0' || module_name[name_length] == '.')) {
+            p_module->level = (uint8_t)level;
+            matched++;
+        }
+    }
+    return matched;
+}
+
+/**
+ * \fn get_log_modules
+ *
+ * \brief Lists every module with its run-time log level (empty in builds without logging)
+ *
+ * \param p_count set to the number of modules
+ *
+ * \returns the first module
+ */
+const log_module_t *get_log_modules(size_t *const p_count) {
+    *p_count = (size_t)(__log_modules_end - __log_modules_start);
+    return __log_modules_start;
 }
 
 log_level_t get_log_level() {
@@ -3,8 +3,18 @@
 
 #include "SEGGER_RTT.h"
 #include "globals.h"
+#include "log_ring.h"
+#include "log_tokens.h"
 
 #define LOGGING_RTT_OUTPUT_CHANNEL 1
+#define LOG_TEXT_MAX_LENGTH 256        // Longest text message the Logger task writes out; longer ones are cut short
+#define LOG_FIRST_FAULT_EXCEPTION 2    // IPSR of the NMI; it and the faults up to UsageFault always log directly
+#define LOG_LAST_FAULT_EXCEPTION 6     // IPSR of UsageFault
+
+// Flags of a printf conversion, as SEGGER_RTT_vprintf understands them
+#define LOG_FORMAT_FLAG_LEFT (1u << 0) // '-': pad on the right
+#define LOG_FORMAT_FLAG_ZERO (1u << 1) // '0': pad numbers with zeros
+#define LOG_FORMAT_FLAG_SIGN (1u << 2) // '+': print a sign on positive numbers
 
 extern uint8_t SEGGER_RTT_LOG_BUFFER[SEGGER_RTT_LOG_BUFFER_SIZE];
 
@@ -26,25 +36,78 @@ DEBUG: Detailed information about the system for debugging (e.g. length of array
     #define __FILENAME__ "<Filename Resolved at Compile Time>"
 #endif
 
+/*
+Filtering happens in two places, both before any arguments are evaluated:
+- Compile time: messages below LOG_MODULE_FLOOR are compiled out of the file entirely. It defaults to LOG_BUILD_FLOOR
+  (`make dev LOG_FLOOR=<0-3>`), and a file can raise its own by defining LOG_MODULE_FLOOR before any includes.
+- Run time: each file (module) has its own level, checked inline at the call site. `set_log_level()` sets every module
+  and `set_module_log_level()` (the shell's `loglevel <module> <level>`) sets one.
+Fatal errors and warnings are never filtered.
+*/
+#ifndef LOG_BUILD_FLOOR
+    #define LOG_BUILD_FLOOR DEBUG
+#endif
+#ifndef LOG_MODULE_FLOOR
+    #define LOG_MODULE_FLOOR LOG_BUILD_FLOOR
+#endif
+
+// Run-time log level of one source file, kept in .pvdx_log_modules (see src_ram.ld) so the shell can find it by name
+typedef struct {
+    const char *name; // __FILENAME__ of the module
+    uint8_t level;    // log_level_t below which the module's messages are dropped
+} log_module_t;
+
 #if defined(DEVBUILD)
+// The including file's module; one per translation unit, since this header is only included once in each
+static log_module_t __attribute__((used, section(".pvdx_log_modules"))) log_module = {__FILENAME__, DEFAULT_LOG_LEVEL};
+
+    #define log_enabled(msg_level) (LOG_MODULE_FLOOR <= (msg_level) && (msg_level) >= log_module.level)
+    #define log_if_enabled(msg_level, call)                                                                                                \
+        do {                                                                                                                               \
+            if (log_enabled(msg_level)) {                                                                                                  \
+                call;                                                                                                                      \
+            }                                                                                                                              \
+        } while (0)
+#endif
+
+#if defined(DEVBUILD) && defined(TOKENIZED_LOGS)
+    /* Tokenized devbuild sends the call site's token and the raw arguments; scripts/rtt_logs.py adds the text back */
+    #define fatal(msg, ...) log_tokenized(LOG_KIND_FATAL, msg, ##__VA_ARGS__)
+    #define warning(msg, ...) log_tokenized(LOG_KIND_WARNING, msg, ##__VA_ARGS__)
+    #define event(msg, ...) log_if_enabled(EVENT, log_tokenized(LOG_KIND_EVENT, msg, ##__VA_ARGS__))
+    #define info(msg, ...) log_if_enabled(INFO, log_tokenized(LOG_KIND_INFO, msg, ##__VA_ARGS__))
+    #ifdef UNITTEST
+        #define test_log(msg, ...) log_if_enabled(DEBUG, log_tokenized(LOG_KIND_TEST, msg, ##__VA_ARGS__))
+        #define debug(msg, ...)
+    #else
+        #define test_log(msg, ...)
+        #define debug(msg, ...) log_if_enabled(DEBUG, log_tokenized(LOG_KIND_DEBUG, msg, ##__VA_ARGS__))
+    #endif
+#elif defined(DEVBUILD)
     /* Devbuild should include filenames and line numbers */
     #define fatal(msg, ...) fatal_impl(RTT_CTRL_TEXT_BRIGHT_RED "[FATAL|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__)
     #define warning(msg, ...)                                                                                                              \
         warning_impl(RTT_CTRL_TEXT_BRIGHT_RED "[WARNING|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__)
     #define event(msg, ...)                                                                                                                \
-        event_impl(RTT_CTRL_TEXT_BRIGHT_WHITE "[EVENT|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__)
-    #define info(msg, ...) info_impl(RTT_CTRL_TEXT_BRIGHT_WHITE "[INFO|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__)
+        log_if_enabled(EVENT,                                                                                                              \
+                       event_impl(RTT_CTRL_TEXT_BRIGHT_WHITE "[EVENT|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__))
+    #define info(msg, ...)                                                                                                                 \
+        log_if_enabled(INFO,                                                                                                               \
+                       info_impl(RTT_CTRL_TEXT_BRIGHT_WHITE "[INFO|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__))
     #ifdef UNITTEST
         #define test_log(msg, ...)                                                                                                         \
-            debug_impl(RTT_CTRL_TEXT_WHITE "[TEST|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__)
+            log_if_enabled(DEBUG,                                                                                                          \
+                           debug_impl(RTT_CTRL_TEXT_WHITE "[TEST|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__))
         #define debug(msg, ...)
     #else
         #define test_log(msg, ...)
-        #define debug(msg, ...) debug_impl(RTT_CTRL_TEXT_WHITE "[DEBUG|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__)
+        #define debug(msg, ...)                                                                                                            \
+            log_if_enabled(DEBUG,                                                                                                          \
+                           debug_impl(RTT_CTRL_TEXT_WHITE "[DEBUG|%s:%d]: " msg RTT_CTRL_RESET, __FILENAME__, __LINE__, ##__VA_ARGS__))
     #endif
 #else
-    /* Other build types (such as release or unittest) don't need filenames or line numbers */
-    #define fatal(msg, ...) fatal_no_log_impl()
+    /* Other build types (such as release or unittest) don't print logs, but still keep the reason for a fatal error */
+    #define fatal(msg, ...) fatal_no_log_impl(__FILENAME__, __LINE__, msg, ##__VA_ARGS__)
     #define warning(msg, ...)
     #define event(msg, ...)
     #define info(msg, ...)
@@ -53,7 +116,7 @@ DEBUG: Detailed information about the system for debugging (e.g. length of array
 #endif
 
 void fatal_impl(const char *string, ...);
-void fatal_no_log_impl(void);
+void fatal_no_log_impl(const char *file, uint32_t line, const char *string, ...);
 void warning_impl(const char *string, ...);
 void event_impl(const char *string, ...);
 void info_impl(char *string, ...);
@@ -61,6 +124,17 @@ void debug_impl(const char *string, ...);
 
 void set_log_level(log_level_t level);
 log_level_t get_log_level();
+size_t set_module_log_level(const char *const name, log_level_t level);
+const log_module_t *get_log_modules(size_t *const p_count);
+
+uint32_t log_tick_count(void);
+bool logging_deferred(void);
+void log_deferred(log_entry_kind_t kind, const void *p_source, const char *format, va_list *p_args);
+void start_deferred_logging(TaskHandle_t consumer);
+void stop_deferred_logging(TaskHandle_t task);
+size_t drain_log_ring(void);
+size_t log_format_payload(const char *format, const uint8_t *const p_payload, size_t payload_length, char *const p_text, size_t capacity);
+void get_log_ring_totals(log_ring_stats_t *const p_stats);
 
 #define fatal_on_error(status, msg)                                                                                                        \
     do {                                                                                                                                   \
@@ -0,0 +1,398 @@
+/**
+ * command_trace.c
+ *
+ * Allocation-free tracing of the command lifecycle. Every command passing through `enqueue_command()` is given a
+ * trace ID and timestamped when it is enqueued, when it is copied onto its target's lane, when the target dequeues it
+ * and when the target completes it. The most recent events are kept in a ring buffer, and the three intervals between
+ * them are folded into per-(target, operation) log2 latency histograms. Histograms are only kept for the pairs in
+ * the routing table, indexed by route number, since no other command reaches a target. The depth of every lane is
+ * also sampled on each send to keep queue high-water marks.
+ *
+ * Binary dump layout (little-endian, produced by `command_trace_serialize()`):
+ *   header (16 bytes)   magic u16, version u8, num_tasks u8, num_lanes u8, num_bins u8, bin_shift u8, reserved u8,
+ *                       tick count u32, num_histograms u16, num_events u16
+ *   high-water marks    num_tasks * num_lanes bytes, indexed [task][lane]
+ *   histograms          num_histograms records of task u8, operation u8, interval u8, reserved u8, max_us u32,
+ *                       num_bins * u16 counts (only histograms with at least one sample are included)
+ *   events              num_events `command_trace_event_t` records, oldest first
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "command_trace.h"
+
+#include <string.h>
+
+#include "command_routing.h"
+#include "cycle_counter.h"
+
+// Header at the start of a serialized trace dump
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t num_tasks;
+    uint8_t num_lanes;
+    uint8_t num_bins;
+    uint8_t bin_shift;
+    uint8_t reserved;
+    uint32_t ticks;
+    uint16_t num_histograms;
+    uint16_t num_events;
+} command_trace_dump_header_t;
+
+// Histogram record in a serialized trace dump
+typedef struct __attribute__((packed)) {
+    uint8_t task_index;
+    uint8_t operation;
+    uint8_t interval;
+    uint8_t reserved;
+    uint32_t max_us;
+    uint16_t bins[COMMAND_TRACE_HISTOGRAM_BINS];
+} command_trace_dump_histogram_t;
+
+_Static_assert(sizeof(command_trace_dump_header_t) == 16, "trace dump header must stay 16 bytes");
+_Static_assert(COMMAND_TRACE_RING_SIZE <= UINT16_MAX, "trace dump stores the event count in 16 bits");
+
+static command_trace_event_t trace_ring[COMMAND_TRACE_RING_SIZE];
+static uint32_t trace_events_written = 0; // Total events recorded; the next event goes to `% COMMAND_TRACE_RING_SIZE`
+static uint16_t next_trace_id = 0;
+static command_trace_histogram_t trace_histograms[NUM_COMMAND_ROUTES][NUM_TRACE_INTERVALS];
+static uint8_t trace_high_water_marks[NUM_TASKS][NUM_COMMAND_LANES];
+
+/**
+ * \fn get_trace_task_index
+ *
+ * \brief Returns the index that a task is traced under
+ *
+ * \param p_task Pointer to the `pvdx_task_t` to look up
+ *
+ * \returns `uint8_t`, the task's `task_index`, or `COMMAND_TRACE_NO_TASK` if it is NULL
+ */
+static inline uint8_t get_trace_task_index(const pvdx_task_t *const p_task) {
+    return p_task != NULL && p_task->task_index < NUM_TASKS ? (uint8_t)p_task->task_index : COMMAND_TRACE_NO_TASK;
+}
+
+/**
+ * \fn get_histogram_bin
+ *
+ * \brief Returns the log2 histogram bin that a latency falls into
+ *
+ * \param latency_us the latency in microseconds
+ *
+ * \returns `size_t`, the bin index (latencies beyond the last bin are clamped into it)
+ */
+static inline size_t get_histogram_bin(uint32_t latency_us) {
+    const uint32_t scaled = latency_us >> COMMAND_TRACE_BIN_SHIFT;
+    if (scaled == 0) {
+        return 0;
+    }
+    const size_t bin = 32 - __builtin_clz(scaled);
+    return bin < COMMAND_TRACE_HISTOGRAM_BINS ? bin : COMMAND_TRACE_HISTOGRAM_BINS - 1;
+}
+
+/**
+ * \fn record_trace_event
+ *
+ * \brief Appends an event to the trace ring, overwriting the oldest event once the ring is full, and folds the
+ *        interval ending at this stage (if any) into the command's latency histogram
+ *
+ * \param p_cmd Pointer to the traced command
+ * \param stage The lifecycle stage that was reached
+ * \param cycles Cycle count at which the stage was reached
+ * \param interval_start_cycles Cycle count at which the interval ending at this stage began
+ * \param has_interval Whether `interval_start_cycles` is valid
+ */
+static void record_trace_event(const command_t *const p_cmd, trace_stage_t stage, uint32_t cycles, uint32_t interval_start_cycles,
+                               bool has_interval) {
+    const uint8_t task_index = get_trace_task_index(p_cmd->target);
+    const command_trace_event_t event = {
+        .cycles = cycles,
+        .ticks = xTaskGetTickCount(),
+        .trace_id = p_cmd->trace_id,
+        .task_index = task_index,
+        .operation = p_cmd->operation,
+        .stage = stage,
+    };
+    const uint32_t latency_us = cycles_to_us(cycles - interval_start_cycles);
+
+    taskENTER_CRITICAL();
+    trace_ring[trace_events_written % COMMAND_TRACE_RING_SIZE] = event;
+    trace_events_written++;
+
+    const size_t route_index = get_command_route_index(task_index, p_cmd->operation);
+    if (has_interval && stage > TRACE_STAGE_ENQUEUE && route_index < NUM_COMMAND_ROUTES) {
+        command_trace_histogram_t *const p_histogram = &trace_histograms[route_index][stage - 1];
+        const size_t bin = get_histogram_bin(latency_us);
+        if (p_histogram->bins[bin] < UINT16_MAX) {
+            p_histogram->bins[bin]++;
+        }
+        if (latency_us > p_histogram->max_us) {
+            p_histogram->max_us = latency_us;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * \fn command_trace_enqueue
+ *
+ * \brief Assigns a command its trace ID and records that it was enqueued. Called by `enqueue_command()`.
+ *
+ * \param p_cmd Pointer to the command being enqueued
+ */
+void command_trace_enqueue(command_t *const p_cmd) {
+    taskENTER_CRITICAL();
+    next_trace_id++;
+    if (next_trace_id == 0) {
+        next_trace_id = 1; // 0 marks commands that never went through `enqueue_command()`
+    }
+    p_cmd->trace_id = next_trace_id;
+    taskEXIT_CRITICAL();
+
+    p_cmd->submitted_cycles = get_cycle_count();
+    p_cmd->dequeued_cycles = 0;
+    record_trace_event(p_cmd, TRACE_STAGE_ENQUEUE, p_cmd->submitted_cycles, 0, false);
+}
+
+/**
+ * \fn command_trace_dispatch
+ *
+ * \brief Records that a command was copied onto its target's lane. Called by `dispatch_command()`.
+ *
+ * \param p_cmd Pointer to the dispatched command, with `enqueued_cycles` set by the send
+ */
+void command_trace_dispatch(const command_t *const p_cmd) {
+    record_trace_event(p_cmd, TRACE_STAGE_DISPATCH, p_cmd->enqueued_cycles, p_cmd->submitted_cycles, p_cmd->trace_id != 0);
+}
+
+/**
+ * \fn command_trace_dequeue
+ *
+ * \brief Timestamps a command as it is taken off a lane by its target and records the event. Called by
+ *        `receive_command()`.
+ *
+ * \param p_cmd Pointer to the received copy of the command
+ */
+void command_trace_dequeue(command_t *const p_cmd) {
+    p_cmd->dequeued_cycles = get_cycle_count();
+    if (p_cmd->dequeued_cycles == 0) {
+        p_cmd->dequeued_cycles = 1; // 0 means "not dequeued" to `command_trace_complete()`
+    }
+    record_trace_event(p_cmd, TRACE_STAGE_DEQUEUE, p_cmd->dequeued_cycles, p_cmd->enqueued_cycles, p_cmd->enqueued_cycles != 0);
+}
+
+/**
+ * \fn command_trace_complete
+ *
+ * \brief Records that a command was completed. Commands that were rejected or dropped before reaching their target
+ *        are recorded in the ring but not in the execution-time histogram. Called by `complete_command()`.
+ *
+ * \param p_cmd Pointer to the completed command
+ */
+void command_trace_complete(const command_t *const p_cmd) {
+    record_trace_event(p_cmd, TRACE_STAGE_COMPLETE, get_cycle_count(), p_cmd->dequeued_cycles, p_cmd->dequeued_cycles != 0);
+}
+
+/**
+ * \fn command_trace_queue_depth
+ *
+ * \brief Updates the high-water mark of a lane with its current depth. Called after every successful send.
+ *
+ * \param p_task Pointer to the task owning the lane
+ * \param lane The lane that was sent to
+ * \param depth Number of commands currently waiting in the lane
+ */
+void command_trace_queue_depth(const pvdx_task_t *const p_task, command_lane_t lane, UBaseType_t depth) {
+    const uint8_t task_index = get_trace_task_index(p_task);
+    if (task_index == COMMAND_TRACE_NO_TASK || lane >= NUM_COMMAND_LANES) {
+        return;
+    }
+
+    const uint8_t clamped_depth = depth > UINT8_MAX ? UINT8_MAX : (uint8_t)depth;
+    taskENTER_CRITICAL();
+    if (clamped_depth > trace_high_water_marks[task_index][lane]) {
+        trace_high_water_marks[task_index][lane] = clamped_depth;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * \fn copy_trace_events
+ *
+ * \brief Copies the newest events of the trace ring, oldest first, to a (possibly unaligned) buffer
+ *
+ * \param p_dest Destination for the events
+ * \param max_events Maximum number of events to copy
+ *
+ * \returns `size_t`, the number of events copied
+ *
+ * \warning must be called inside a critical section
+ */
+static size_t copy_trace_events(uint8_t *const p_dest, size_t max_events) {
+    size_t count = trace_events_written < COMMAND_TRACE_RING_SIZE ? trace_events_written : COMMAND_TRACE_RING_SIZE;
+    if (count > max_events) {
+        count = max_events;
+    }
+
+    const uint32_t first = trace_events_written - count;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(p_dest + i * sizeof(command_trace_event_t), &trace_ring[(first + i) % COMMAND_TRACE_RING_SIZE],
+               sizeof(command_trace_event_t));
+    }
+    return count;
+}
+
+/**
+ * \fn command_trace_read_events
+ *
+ * \brief Copies the newest events of the trace ring, oldest first
+ *
+ * \param p_events Array to copy the events into
+ * \param max_events Length of `p_events`
+ *
+ * \returns `size_t`, the number of events copied
+ */
+size_t command_trace_read_events(command_trace_event_t *const p_events, size_t max_events) {
+    taskENTER_CRITICAL();
+    const size_t count = copy_trace_events((uint8_t *)p_events, max_events);
+    taskEXIT_CRITICAL();
+    return count;
+}
+
+/**
+ * \fn command_trace_get_histogram
+ *
+ * \brief Takes a consistent copy of one latency histogram
+ *
+ * \param task_index Index of the target task in `task_list`
+ * \param operation The operation the histogram is kept for
+ * \param interval The lifecycle interval the histogram is kept for
+ * \param p_histogram Destination for the copy
+ *
+ * \returns `bool`, true if the histogram has at least one sample (always false for pairs with no route)
+ */
+bool command_trace_get_histogram(size_t task_index, operation_t operation, trace_interval_t interval,
+                                 command_trace_histogram_t *const p_histogram) {
+    const size_t route_index = get_command_route_index(task_index, operation);
+    if (route_index >= NUM_COMMAND_ROUTES || interval >= NUM_TRACE_INTERVALS) {
+        memset(p_histogram, 0, sizeof(*p_histogram));
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    *p_histogram = trace_histograms[route_index][interval];
+    taskEXIT_CRITICAL();
+
+    for (size_t bin = 0; bin < COMMAND_TRACE_HISTOGRAM_BINS; bin++) {
+        if (p_histogram->bins[bin] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \fn command_trace_get_high_water_mark
+ *
+ * \brief Returns the largest number of commands seen waiting in a lane
+ *
+ * \param task_index Index of the task in `task_list`
+ * \param lane The lane to query
+ *
+ * \returns `uint8_t`, the high-water mark (0 if the lane was never sent to)
+ */
+uint8_t command_trace_get_high_water_mark(size_t task_index, command_lane_t lane) {
+    if (task_index >= NUM_TASKS || lane >= NUM_COMMAND_LANES) {
+        return 0;
+    }
+    return trace_high_water_marks[task_index][lane];
+}
+
+/**
+ * \fn command_trace_serialize
+ *
+ * \brief Writes the high-water marks, non-empty histograms and as many of the newest ring events as fit into a compact
+ *        binary dump suitable for downlink (see the layout at the top of this file)
+ *
+ * \param p_buffer Buffer to write the dump into
+ * \param buffer_size Size of `p_buffer` in bytes
+ *
+ * \returns `size_t`, the number of bytes written, or 0 if the buffer cannot hold the header and high-water marks
+ *
+ * \note Histograms that do not fit are left out and events are written only after all histograms
+ */
+size_t command_trace_serialize(uint8_t *const p_buffer, size_t buffer_size) {
+    const size_t fixed_size = sizeof(command_trace_dump_header_t) + sizeof(trace_high_water_marks);
+    if (p_buffer == NULL || buffer_size < fixed_size) {
+        return 0;
+    }
+
+    command_trace_dump_header_t header = {
+        .magic = COMMAND_TRACE_DUMP_MAGIC,
+        .version = COMMAND_TRACE_DUMP_VERSION,
+        .num_tasks = NUM_TASKS,
+        .num_lanes = NUM_COMMAND_LANES,
+        .num_bins = COMMAND_TRACE_HISTOGRAM_BINS,
+        .bin_shift = COMMAND_TRACE_BIN_SHIFT,
+        .reserved = 0,
+        .ticks = xTaskGetTickCount(),
+        .num_histograms = 0,
+        .num_events = 0,
+    };
+    size_t offset = sizeof(header);
+
+    taskENTER_CRITICAL();
+    memcpy(p_buffer + offset, trace_high_water_marks, sizeof(trace_high_water_marks));
+    taskEXIT_CRITICAL();
+    offset += sizeof(trace_high_water_marks);
+
+    for (size_t route = 0; route < NUM_COMMAND_ROUTES; route++) {
+        size_t task;
+        operation_t operation;
+        get_command_route_key(route, &task, &operation);
+        for (size_t interval = 0; interval < NUM_TRACE_INTERVALS; interval++) {
+            command_trace_histogram_t histogram;
+            if (!command_trace_get_histogram(task, operation, (trace_interval_t)interval, &histogram)) {
+                continue;
+            }
+            if (buffer_size - offset < sizeof(command_trace_dump_histogram_t)) {
+                break;
+            }
+
+            command_trace_dump_histogram_t record = {
+                .task_index = (uint8_t)task,
+                .operation = (uint8_t)operation,
+                .interval = (uint8_t)interval,
+                .reserved = 0,
+                .max_us = histogram.max_us,
+            };
+            memcpy(record.bins, histogram.bins, sizeof(record.bins));
+            memcpy(p_buffer + offset, &record, sizeof(record));
+            offset += sizeof(record);
+            header.num_histograms++;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    header.num_events = (uint16_t)copy_trace_events(p_buffer + offset, (buffer_size - offset) / sizeof(command_trace_event_t));
+    taskEXIT_CRITICAL();
+    offset += header.num_events * sizeof(command_trace_event_t);
+
+    memcpy(p_buffer, &header, sizeof(header));
+    return offset;
+}
+
+/**
+ * \fn command_trace_reset
+ *
+ * \brief Clears the trace ring, histograms and high-water marks (trace IDs keep counting)
+ */
+void command_trace_reset(void) {
+    taskENTER_CRITICAL();
+    trace_events_written = 0;
+    memset(trace_ring, 0, sizeof(trace_ring));
+    memset(trace_histograms, 0, sizeof(trace_histograms));
+    memset(trace_high_water_marks, 0, sizeof(trace_high_water_marks));
+    taskEXIT_CRITICAL();
+}
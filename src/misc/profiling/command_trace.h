@@ -0,0 +1,63 @@
+#ifndef COMMAND_TRACE_H
+#define COMMAND_TRACE_H
+
+#include "globals.h"
+
+// Constants
+#define COMMAND_TRACE_RING_SIZE 128     // Number of lifecycle events kept in the trace ring (oldest are overwritten)
+#define COMMAND_TRACE_HISTOGRAM_BINS 16 // Number of log2 latency bins per histogram
+#define COMMAND_TRACE_BIN_SHIFT 2       // Bin 0 holds latencies below 2^SHIFT us, bin i holds [2^(SHIFT+i-1), 2^(SHIFT+i)) us
+#define COMMAND_TRACE_NO_TASK 0xFF      // Task index recorded for commands whose target is not in `task_list`
+#define COMMAND_TRACE_DUMP_MAGIC 0x5443 // "CT" (little-endian), first two bytes of a serialized trace dump
+#define COMMAND_TRACE_DUMP_VERSION 1    // Version of the dump layout described in command_trace.c
+
+// The points in a command's lifecycle that are traced
+typedef enum {
+    TRACE_STAGE_ENQUEUE = 0, // `enqueue_command()` was called
+    TRACE_STAGE_DISPATCH,    // The command was copied onto the target's lane
+    TRACE_STAGE_DEQUEUE,     // The target task took the command off its lane
+    TRACE_STAGE_COMPLETE,    // The target task finished executing the command (or it was rejected/dropped)
+    NUM_TRACE_STAGES,
+} trace_stage_t;
+
+// The latency intervals that histograms are kept for, each ending at the stage of the same number
+typedef enum {
+    TRACE_INTERVAL_DISPATCH = 0, // ENQUEUE -> DISPATCH (time spent in the Command Dispatcher in hub mode)
+    TRACE_INTERVAL_QUEUE,        // DISPATCH -> DEQUEUE (time spent in the target's lane)
+    TRACE_INTERVAL_EXEC,         // DEQUEUE -> COMPLETE (time spent in `exec_command_*`)
+    NUM_TRACE_INTERVALS,
+} trace_interval_t;
+
+// One lifecycle event in the trace ring (12 bytes, same layout in the binary dump)
+typedef struct __attribute__((packed)) {
+    uint32_t cycles;       // DWT cycle count at the event
+    uint32_t ticks;        // RTOS tick count at the event
+    uint16_t trace_id;     // Identifies the command across its events (0 if it was never enqueued)
+    uint8_t task_index;    // Index of the command's target in `task_list`
+    uint8_t operation : 5; // operation_t
+    uint8_t stage : 3;     // trace_stage_t
+} command_trace_event_t;
+
+// Latency histogram for one (target, operation, interval)
+typedef struct {
+    uint16_t bins[COMMAND_TRACE_HISTOGRAM_BINS]; // Saturating sample counts
+    uint32_t max_us;                             // Largest latency seen (the last bin is open-ended)
+} command_trace_histogram_t;
+
+_Static_assert(NUM_OPERATIONS <= 32, "command_trace_event_t.operation is 5 bits wide");
+_Static_assert(NUM_TRACE_STAGES <= 8, "command_trace_event_t.stage is 3 bits wide");
+_Static_assert(sizeof(command_trace_event_t) == 12, "trace dump layout depends on the event size");
+
+void command_trace_enqueue(command_t *const p_cmd);
+void command_trace_dispatch(const command_t *const p_cmd);
+void command_trace_dequeue(command_t *const p_cmd);
+void command_trace_complete(const command_t *const p_cmd);
+void command_trace_queue_depth(const pvdx_task_t *const p_task, command_lane_t lane, UBaseType_t depth);
+size_t command_trace_read_events(command_trace_event_t *const p_events, size_t max_events);
+bool command_trace_get_histogram(size_t task_index, operation_t operation, trace_interval_t interval,
+                                 command_trace_histogram_t *const p_histogram);
+uint8_t command_trace_get_high_water_mark(size_t task_index, command_lane_t lane);
+size_t command_trace_serialize(uint8_t *const p_buffer, size_t buffer_size);
+void command_trace_reset(void);
+
+#endif // COMMAND_TRACE_H
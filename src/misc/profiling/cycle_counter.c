@@ -0,0 +1,76 @@
+/**
+ * cycle_counter.c
+ *
+ * Thin wrapper around the Cortex-M4 DWT cycle counter (CYCCNT). Used to timestamp events with CPU-cycle
+ * resolution when the 1 ms RTOS tick is too coarse (e.g. measuring command latency). The counter is 32 bits
+ * wide and wraps roughly every 35 seconds at 120 MHz, so only differences between nearby timestamps are meaningful.
+ * Also keeps a count of scheduler context switches, fed by the kernel's trace hook.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "cycle_counter.h"
+
+// Incremented by the kernel every time a task is switched in (`traceTASK_SWITCHED_IN` in FreeRTOSConfig.h)
+volatile uint32_t context_switch_count = 0;
+
+/**
+ * \fn init_cycle_counter
+ *
+ * \brief Enables the DWT cycle counter. Safe to call more than once.
+ */
+void init_cycle_counter(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // Enable the trace block (required for DWT access)
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+/**
+ * \fn advance_cycle_count
+ *
+ * \brief Moves the cycle counter forward by time during which it did not count because the core clock was stopped
+ *        (tickless idle sleep), so that cycle-count differences keep measuring real time
+ *
+ * \param cycles the number of cycles the core was asleep for
+ */
+void advance_cycle_count(uint32_t cycles) {
+    DWT->CYCCNT += cycles;
+}
+
+/**
+ * \fn get_cycle_count
+ *
+ * \brief Returns the current value of the DWT cycle counter
+ *
+ * \returns `uint32_t`, the number of CPU cycles elapsed (modulo 2^32) since the counter was enabled
+ */
+inline uint32_t get_cycle_count(void) {
+    return DWT->CYCCNT;
+}
+
+/**
+ * \fn cycles_to_us
+ *
+ * \brief Converts a cycle count into microseconds
+ *
+ * \param cycles a number of CPU cycles
+ *
+ * \returns `uint32_t`, the equivalent number of microseconds (rounded down)
+ */
+inline uint32_t cycles_to_us(uint32_t cycles) {
+    return cycles / CYCLES_PER_US;
+}
+
+/**
+ * \fn get_context_switch_count
+ *
+ * \brief Returns the number of context switches performed by the scheduler since boot
+ *
+ * \returns `uint32_t`, the number of times a task has been switched in (modulo 2^32)
+ */
+uint32_t get_context_switch_count(void) {
+    return context_switch_count;
+}
@@ -0,0 +1,16 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <atmel_start.h>
+
+#include "globals.h"
+
+#define CYCLES_PER_US (CONF_CPU_FREQUENCY / 1000000UL) // Number of CPU cycles in one microsecond
+
+void init_cycle_counter(void);
+uint32_t get_cycle_count(void);
+void advance_cycle_count(uint32_t cycles);
+uint32_t cycles_to_us(uint32_t cycles);
+uint32_t get_context_switch_count(void);
+
+#endif // CYCLE_COUNTER_H
@@ -0,0 +1,186 @@
+/**
+ * run_time_stats.c
+ *
+ * Run-time statistics backend for FreeRTOS (`configGENERATE_RUN_TIME_STATS`) driven by the DWT cycle counter, so that
+ * every task's CPU time is counted in CPU cycles rather than RTOS ticks. The kernel's switch-out and switch-in trace
+ * hooks additionally time each run slice, keeping the longest slice of every PVDX task.
+ *
+ * The kernel's counters are 32 bits wide and wrap with the cycle counter (roughly every 35 seconds), so usage is
+ * always measured as the difference between two samples taken a short window apart (see `run_time_stats_measure()`).
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "run_time_stats.h"
+
+#include <string.h>
+
+#include "cycle_counter.h"
+#include "task_list.h"
+
+// Cycle count at which the running task was switched in
+static volatile uint32_t slice_start_cycles = 0;
+// Longest run slice of each PVDX task (by task index) and of all other tasks together since the window started
+static volatile uint32_t worst_slice_cycles[NUM_TASKS + 1];
+// Task that ran the longest slice outside `task_list`
+static volatile TaskHandle_t worst_other_slice_handle = NULL;
+// The idle task, whose slices are not tracked (it runs whenever nothing else does)
+static volatile TaskHandle_t idle_task_handle = NULL;
+
+// Kernel task states at the start and end of a window; static to keep them off the caller's stack
+static TaskStatus_t window_start_states[RUN_TIME_STATS_MAX_TASKS];
+static TaskStatus_t window_end_states[RUN_TIME_STATS_MAX_TASKS];
+
+/**
+ * \fn vConfigureTimerForRunTimeStats
+ *
+ * \brief Starts the run-time stats counter (`portCONFIGURE_TIMER_FOR_RUN_TIME_STATS`, called by the kernel when the
+ *        scheduler starts)
+ */
+void vConfigureTimerForRunTimeStats(void) {
+    init_cycle_counter();
+    slice_start_cycles = get_cycle_count();
+}
+
+/**
+ * \fn vGetRunTimeCounterValue
+ *
+ * \brief Reads the run-time stats counter (`portGET_RUN_TIME_COUNTER_VALUE`)
+ *
+ * \returns `uint32_t`, the DWT cycle count
+ */
+uint32_t vGetRunTimeCounterValue(void) {
+    return get_cycle_count();
+}
+
+/**
+ * \fn run_time_task_switched_in
+ *
+ * \brief Starts timing the slice of the task that was just switched in (`traceTASK_SWITCHED_IN`)
+ *
+ * \warning runs inside the scheduler's context switch; must stay short and must not call the RTOS
+ */
+void run_time_task_switched_in(void) {
+    slice_start_cycles = get_cycle_count();
+}
+
+/**
+ * \fn run_time_task_switched_out
+ *
+ * \brief Ends the slice of the task being switched out (`traceTASK_SWITCHED_OUT`) and keeps it if it is the task's
+ *        longest so far
+ *
+ * \param handle the task being switched out
+ *
+ * \warning runs inside the scheduler's context switch; must stay short
+ */
+void run_time_task_switched_out(void *handle) {
+    if (handle == idle_task_handle) {
+        return;
+    }
+
+    const uint32_t slice_cycles = get_cycle_count() - slice_start_cycles;
+    const pvdx_task_t *const p_task = pvTaskGetThreadLocalStoragePointer((TaskHandle_t)handle, 0);
+    const size_t slot = p_task != NULL ? p_task->task_index : RUN_TIME_STATS_OTHER_TASKS;
+    if (slice_cycles > worst_slice_cycles[slot]) {
+        worst_slice_cycles[slot] = slice_cycles;
+        if (slot == RUN_TIME_STATS_OTHER_TASKS) {
+            worst_other_slice_handle = (TaskHandle_t)handle;
+        }
+    }
+}
+
+/**
+ * \fn find_task_state
+ *
+ * \returns `const TaskStatus_t *`, the state of the task with the given handle, or NULL if it is not in `p_states`
+ */
+static const TaskStatus_t *find_task_state(const TaskStatus_t *const p_states, size_t num_states, TaskHandle_t handle) {
+    for (size_t i = 0; i < num_states; i++) {
+        if (p_states[i].xHandle == handle) {
+            return &p_states[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \fn run_time_stats_measure
+ *
+ * \brief Measures how the CPU is shared between tasks over a window: each task's share of the cycles, the idle share,
+ *        the context switch rate and the longest single run slice. Blocks the caller for the length of the window.
+ *
+ * \param window_ms length of the window (in ms, at most `RUN_TIME_STATS_MAX_WINDOW_MS`)
+ * \param p_report where to store the results
+ *
+ * \returns `status_t`, SUCCESS, or ERROR_SANITY_CHECK_FAILED if the window is too long or there are more tasks than
+ *          `RUN_TIME_STATS_MAX_TASKS`
+ *
+ * \warning only one task may measure at a time, since the slice statistics are shared
+ */
+status_t run_time_stats_measure(uint32_t window_ms, run_time_report_t *const p_report) {
+    if (window_ms == 0 || window_ms > RUN_TIME_STATS_MAX_WINDOW_MS) {
+        return ERROR_SANITY_CHECK_FAILED;
+    }
+
+    uint32_t start_total_cycles;
+    const UBaseType_t num_start_states = uxTaskGetSystemState(window_start_states, RUN_TIME_STATS_MAX_TASKS, &start_total_cycles);
+    if (num_start_states == 0) {
+        return ERROR_SANITY_CHECK_FAILED; // More tasks than `RUN_TIME_STATS_MAX_TASKS`
+    }
+    for (size_t i = 0; i < num_start_states; i++) {
+        if (strcmp(window_start_states[i].pcTaskName, RUN_TIME_STATS_IDLE_TASK_NAME) == 0) {
+            idle_task_handle = window_start_states[i].xHandle;
+        }
+    }
+
+    // Start the window: reset the slice statistics and sample the context switch count
+    taskENTER_CRITICAL();
+    memset((void *)worst_slice_cycles, 0, sizeof(worst_slice_cycles));
+    worst_other_slice_handle = NULL;
+    taskEXIT_CRITICAL();
+    const uint32_t start_switches = get_context_switch_count();
+
+    vTaskDelay(pdMS_TO_TICKS(window_ms));
+
+    uint32_t end_total_cycles;
+    const UBaseType_t num_end_states = uxTaskGetSystemState(window_end_states, RUN_TIME_STATS_MAX_TASKS, &end_total_cycles);
+    const uint32_t switches = get_context_switch_count() - start_switches;
+    if (num_end_states == 0) {
+        return ERROR_SANITY_CHECK_FAILED;
+    }
+
+    memset(p_report, 0, sizeof(run_time_report_t));
+    p_report->window_cycles = end_total_cycles - start_total_cycles;
+    p_report->context_switches_per_s = (uint32_t)((uint64_t)switches * 1000 / window_ms);
+
+    // Tasks created or deleted during the window are left out, since only part of their run time is known
+    for (size_t i = 0; i < num_end_states; i++) {
+        const TaskStatus_t *const p_end = &window_end_states[i];
+        const TaskStatus_t *const p_start = find_task_state(window_start_states, num_start_states, p_end->xHandle);
+        if (p_start == NULL) {
+            continue;
+        }
+
+        run_time_task_stats_t *const p_stats = &p_report->tasks[p_report->num_tasks++];
+        p_stats->name = p_end->pcTaskName;
+        p_stats->p_task = pvTaskGetThreadLocalStoragePointer(p_end->xHandle, 0);
+        p_stats->run_cycles = p_end->ulRunTimeCounter - p_start->ulRunTimeCounter;
+        p_stats->cpu_permille =
+            p_report->window_cycles > 0 ? (uint16_t)((uint64_t)p_stats->run_cycles * 1000 / p_report->window_cycles) : 0;
+        if (p_stats->p_task != NULL) {
+            p_stats->worst_slice_cycles = worst_slice_cycles[p_stats->p_task->task_index];
+        } else if (p_end->xHandle == worst_other_slice_handle) {
+            p_stats->worst_slice_cycles = worst_slice_cycles[RUN_TIME_STATS_OTHER_TASKS];
+        }
+
+        if (p_end->xHandle == idle_task_handle) {
+            p_report->idle_permille = p_stats->cpu_permille;
+        } else if (p_stats->worst_slice_cycles > p_report->worst_slice_cycles) {
+            p_report->worst_slice_cycles = p_stats->worst_slice_cycles;
+            p_report->worst_slice_task = p_stats->name;
+        }
+    }
+    return SUCCESS;
+}
@@ -0,0 +1,38 @@
+#ifndef RUN_TIME_STATS_H
+#define RUN_TIME_STATS_H
+
+#include "globals.h"
+
+// Constants
+#define RUN_TIME_STATS_MAX_TASKS 16          // Most tasks (PVDX tasks, the idle task and any helpers) a report can hold
+#define RUN_TIME_STATS_MAX_WINDOW_MS 30000   // Longest measurement window (the cycle counter wraps after ~35 s)
+#define RUN_TIME_STATS_OTHER_TASKS NUM_TASKS // Slot in `worst_slice_cycles` shared by tasks outside `task_list`
+#define RUN_TIME_STATS_IDLE_TASK_NAME "IDLE" // Name FreeRTOS gives its idle task (`configIDLE_TASK_NAME`)
+
+// Where one task's cycles went during a measurement window
+typedef struct {
+    const char *name;            // Name of the task
+    const pvdx_task_t *p_task;   // The PVDX task, or NULL for tasks outside `task_list` (idle, benchmark, ...)
+    uint32_t run_cycles;         // Cycles the task spent running during the window
+    uint16_t cpu_permille;       // Share of the window the task spent running (in tenths of a percent)
+    uint32_t worst_slice_cycles; // Longest the task ran without being switched out (0 if not tracked)
+} run_time_task_stats_t;
+
+// CPU usage of every task over one measurement window (see `run_time_stats_measure()`)
+typedef struct {
+    run_time_task_stats_t tasks[RUN_TIME_STATS_MAX_TASKS]; // One entry per task that existed for the whole window
+    size_t num_tasks;                                      // Number of valid entries in `tasks`
+    uint32_t window_cycles;                                // Length of the window
+    uint16_t idle_permille;                                // Share of the window spent in the idle task
+    uint32_t context_switches_per_s;                       // Context switches per second during the window
+    uint32_t worst_slice_cycles;                           // Longest single run slice of any task except idle
+    const char *worst_slice_task;                          // Name of the task that ran it (NULL if none)
+} run_time_report_t;
+
+void vConfigureTimerForRunTimeStats(void);
+uint32_t vGetRunTimeCounterValue(void);
+void run_time_task_switched_in(void);
+void run_time_task_switched_out(void *handle);
+status_t run_time_stats_measure(uint32_t window_ms, run_time_report_t *const p_report);
+
+#endif // RUN_TIME_STATS_H
@@ -0,0 +1,103 @@
+/**
+ * stack_usage.c
+ *
+ * Run-time stack usage tracking for every PVDX task. FreeRTOS fills each new stack with a known pattern, so the
+ * deepest point a task's stack has ever reached can be found by scanning for the first overwritten word
+ * (`uxTaskGetStackHighWaterMark()`). The watchdog samples every task as it pets the hardware watchdog and the deepest
+ * use seen is kept in the task's `pvdx_task_t`, so it survives the task being restarted (which refills its stack).
+ *
+ * The measured peaks are the run-time half of stack sizing; `make stack_report` computes the static worst case of
+ * every task from the compiler's stack usage output and the call graph.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "stack_usage.h"
+
+#include <string.h>
+
+#include "logging.h"
+#include "task_list.h"
+
+/**
+ * \fn stack_usage_sample
+ *
+ * \brief Measures the stack high-water mark of every running PVDX task and keeps the deepest use seen. Warns the first
+ *        time a task's free stack falls below `1 / STACK_USAGE_LOW_FREE_DIVISOR` of its stack size.
+ *
+ * \note Each sample scans the unused part of every stack, so this should be called occasionally (e.g. once a second)
+ */
+void stack_usage_sample(void) {
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        pvdx_task_t *const p_task = task_list[i];
+        if (p_task->handle == NULL) {
+            continue;
+        }
+
+        const uint32_t free_words = (uint32_t)uxTaskGetStackHighWaterMark(p_task->handle);
+        const uint32_t used_words = free_words < p_task->stack_size ? p_task->stack_size - free_words : 0;
+
+        taskENTER_CRITICAL();
+        const uint32_t previous_peak_words = p_task->stack_peak_used_words;
+        if (used_words > previous_peak_words) {
+            p_task->stack_peak_used_words = used_words;
+        }
+        taskEXIT_CRITICAL();
+
+        const uint32_t low_used_words = p_task->stack_size - p_task->stack_size / STACK_USAGE_LOW_FREE_DIVISOR;
+        if (used_words > low_used_words && previous_peak_words <= low_used_words) {
+            warning("stack: %s has used %u of its %u stack words\n", p_task->name, used_words, p_task->stack_size);
+        }
+    }
+}
+
+/**
+ * \fn get_stack_usage_record
+ *
+ * \brief Condenses a task's stack usage into a packed telemetry record (sizes in words)
+ *
+ * \param p_task a pointer to the task
+ *
+ * \returns `stack_usage_record_t`, the record
+ */
+stack_usage_record_t get_stack_usage_record(pvdx_task_t *const p_task) {
+    const uint32_t peak_used_words = __atomic_load_n(&p_task->stack_peak_used_words, __ATOMIC_RELAXED);
+    const uint32_t low_used_words = p_task->stack_size - p_task->stack_size / STACK_USAGE_LOW_FREE_DIVISOR;
+
+    uint8_t flags = 0;
+    if (p_task->handle != NULL) {
+        flags |= STACK_USAGE_FLAG_RUNNING;
+    }
+    if (peak_used_words > low_used_words) {
+        flags |= STACK_USAGE_FLAG_LOW;
+    }
+
+    return (stack_usage_record_t){
+        .task_index = (uint8_t)p_task->task_index,
+        .flags = flags,
+        .stack_size_words = (uint16_t)p_task->stack_size,
+        .peak_used_words = (uint16_t)peak_used_words,
+        .min_free_words = (uint16_t)(p_task->stack_size - peak_used_words),
+    };
+}
+
+/**
+ * \fn stack_usage_serialize
+ *
+ * \brief Writes one `stack_usage_record_t` per task, in task list order, for downlink
+ *
+ * \param p_buffer Buffer to write the records into
+ * \param buffer_size Size of `p_buffer` in bytes
+ *
+ * \returns `size_t`, the number of bytes written (only whole records are written)
+ */
+size_t stack_usage_serialize(uint8_t *const p_buffer, size_t buffer_size) {
+    size_t offset = 0;
+    for (size_t i = 0; task_list[i] != NULL && offset + sizeof(stack_usage_record_t) <= buffer_size; i++) {
+        const stack_usage_record_t record = get_stack_usage_record(task_list[i]);
+        memcpy(&p_buffer[offset], &record, sizeof(record));
+        offset += sizeof(record);
+    }
+    return offset;
+}
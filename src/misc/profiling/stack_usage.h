@@ -0,0 +1,26 @@
+#ifndef STACK_USAGE_H
+#define STACK_USAGE_H
+
+#include "globals.h"
+
+// Constants
+#define STACK_USAGE_LOW_FREE_DIVISOR 8 // Warn once a task's free stack falls below 1/8 of its stack size
+#define STACK_USAGE_FLAG_RUNNING 0x01  // `stack_usage_record_t.flags`: the task existed when the record was made
+#define STACK_USAGE_FLAG_LOW 0x02      // `stack_usage_record_t.flags`: the task has come close to overflowing its stack
+
+// Packed telemetry record of one task's stack usage (see `stack_usage_serialize()`)
+typedef struct __attribute__((packed)) {
+    uint8_t task_index;
+    uint8_t flags;             // `STACK_USAGE_FLAG_*`
+    uint16_t stack_size_words; // Stack allocated to the task (excluding `TASK_STACK_OVERFLOW_PADDING`)
+    uint16_t peak_used_words;  // Deepest the stack has ever been, across restarts of the task
+    uint16_t min_free_words;   // Smallest amount of stack that has ever been left unused
+} stack_usage_record_t;
+
+_Static_assert(sizeof(stack_usage_record_t) == 8, "stack_usage_record_t is a fixed telemetry layout");
+
+void stack_usage_sample(void);
+stack_usage_record_t get_stack_usage_record(pvdx_task_t *const p_task);
+size_t stack_usage_serialize(uint8_t *const p_buffer, size_t buffer_size);
+
+#endif // STACK_USAGE_H
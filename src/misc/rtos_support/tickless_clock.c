@@ -0,0 +1,98 @@
+/**
+ * tickless_clock.c
+ *
+ * Tick arithmetic for tickless idle, kept free of hardware and RTOS dependencies so that sleeps and wakeups can be
+ * simulated in a test. While ticks are suppressed the 32.768 kHz RTC keeps time; a tick is 32.768 RTC counts, so time
+ * is tracked in units small enough that both RTC counts and ticks are whole numbers of units, and no fraction of a
+ * tick is ever rounded away between sleeps.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "tickless_clock.h"
+
+/**
+ * \fn tickless_clock_sleep_counts
+ *
+ * \brief Works out how long to sleep so that the core wakes just before the tick at which the kernel expects a task
+ *        to unblock (the RTC is programmed to wake slightly early rather than late)
+ *
+ * \param p_clock the tick clock
+ * \param expected_idle_ticks ticks until the kernel's next unblock time, counted from the current (unfinished) tick
+ *
+ * \returns `uint32_t`, the number of RTC counts to sleep for, or 0 if the kernel is already due (or owed) that many
+ *          ticks and should not sleep
+ */
+uint32_t tickless_clock_sleep_counts(const tickless_clock_t *const p_clock, uint32_t expected_idle_ticks) {
+    // Ticks that have already passed but not been stepped shorten the time left until the unblock time
+    if (expected_idle_ticks <= p_clock->owed_ticks + 1) {
+        return 0;
+    }
+    const uint32_t idle_ticks = expected_idle_ticks - p_clock->owed_ticks;
+
+    // Wake at the start of the last expected tick: the rest of the current tick, then all but one more
+    const uint64_t sleep_units =
+        (uint64_t)(TICKLESS_UNITS_PER_TICK - p_clock->units_into_tick) + (uint64_t)(idle_ticks - 1) * TICKLESS_UNITS_PER_TICK;
+    return (uint32_t)(sleep_units / TICKLESS_UNITS_PER_RTC_COUNT);
+}
+
+/**
+ * \fn tickless_clock_wakeup
+ *
+ * \brief Accounts for a sleep: works out how many ticks passed and how far into the current tick the core woke. The
+ *        kernel can be stepped to one tick short of its unblock time at most; the tick at the unblock time is left to
+ *        the tick interrupt so that it unblocks tasks as usual, and any ticks beyond that (only possible if the core
+ *        overslept) are owed and stepped after later sleeps, so the tick count never loses time.
+ *
+ * \param p_clock the tick clock; updated to the moment of wakeup
+ * \param slept_counts RTC counts that passed while asleep
+ * \param expected_idle_ticks the value passed to `tickless_clock_sleep_counts()` for this sleep
+ *
+ * \returns `tickless_step_t`, how to bring the tick count up to date
+ */
+tickless_step_t tickless_clock_wakeup(tickless_clock_t *const p_clock, uint32_t slept_counts, uint32_t expected_idle_ticks) {
+    const uint64_t units = (uint64_t)p_clock->units_into_tick + (uint64_t)slept_counts * TICKLESS_UNITS_PER_RTC_COUNT;
+    p_clock->units_into_tick = (uint32_t)(units % TICKLESS_UNITS_PER_TICK);
+    uint32_t due_ticks = (uint32_t)(units / TICKLESS_UNITS_PER_TICK) + p_clock->owed_ticks;
+
+    tickless_step_t step = {.ticks_to_step = 0, .tick_pending = false};
+    const uint32_t max_step = expected_idle_ticks > 0 ? expected_idle_ticks - 1 : 0;
+    step.ticks_to_step = due_ticks < max_step ? due_ticks : max_step;
+    due_ticks -= step.ticks_to_step;
+    if (due_ticks > 0) {
+        step.tick_pending = true;
+        due_ticks--;
+    }
+    p_clock->owed_ticks = due_ticks;
+    return step;
+}
+
+/**
+ * \fn tickless_clock_units_from_timer
+ *
+ * \brief Converts the part of a tick measured by the tick timer (e.g. SysTick counts) into tick clock units
+ *
+ * \param elapsed_timer_counts timer counts since the current tick started
+ * \param timer_counts_per_tick timer counts in one tick
+ *
+ * \returns `uint32_t`, the position in the current tick in units (less than `TICKLESS_UNITS_PER_TICK`)
+ */
+uint32_t tickless_clock_units_from_timer(uint32_t elapsed_timer_counts, uint32_t timer_counts_per_tick) {
+    const uint64_t units = (uint64_t)elapsed_timer_counts * TICKLESS_UNITS_PER_TICK / timer_counts_per_tick;
+    return units < TICKLESS_UNITS_PER_TICK ? (uint32_t)units : TICKLESS_UNITS_PER_TICK - 1;
+}
+
+/**
+ * \fn tickless_clock_timer_from_units
+ *
+ * \brief Converts tick clock units into tick timer counts (e.g. to restart SysTick part way through a tick)
+ *
+ * \param units time in units
+ * \param timer_counts_per_tick timer counts in one tick
+ *
+ * \returns `uint32_t`, the time in timer counts
+ */
+uint32_t tickless_clock_timer_from_units(uint32_t units, uint32_t timer_counts_per_tick) {
+    return (uint32_t)((uint64_t)units * timer_counts_per_tick / TICKLESS_UNITS_PER_TICK);
+}
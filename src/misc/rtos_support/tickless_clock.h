@@ -0,0 +1,33 @@
+#ifndef TICKLESS_CLOCK_H
+#define TICKLESS_CLOCK_H
+
+// Only standard headers, so that the tick arithmetic can be built and tested on a host
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants
+#define TICKLESS_RTC_HZ 32768UL // Rate of the RTC counter that keeps time while ticks are suppressed
+#define TICKLESS_TICK_RATE_HZ 1000UL // Must match `configTICK_RATE_HZ`
+// Time is tracked in units of 1 / TICKLESS_TICK_RATE_HZ RTC counts, so that one RTC count is TICKLESS_TICK_RATE_HZ units
+// and one tick is TICKLESS_RTC_HZ units and neither conversion rounds
+#define TICKLESS_UNITS_PER_TICK TICKLESS_RTC_HZ
+#define TICKLESS_UNITS_PER_RTC_COUNT TICKLESS_TICK_RATE_HZ
+
+// Where the tick clock stands relative to real time between sleeps
+typedef struct {
+    uint32_t units_into_tick; // How far into the current tick real time is (less than `TICKLESS_UNITS_PER_TICK`)
+    uint32_t owed_ticks;      // Ticks that have passed but could not yet be stepped (see `tickless_clock_wakeup()`)
+} tickless_clock_t;
+
+// What to do to the tick count after a sleep (see `tickless_clock_wakeup()`)
+typedef struct {
+    uint32_t ticks_to_step; // Ticks to add at once (`vTaskStepTick()`)
+    bool tick_pending;      // Whether one more tick is already due and must be processed normally (pend the tick interrupt)
+} tickless_step_t;
+
+uint32_t tickless_clock_sleep_counts(const tickless_clock_t *const p_clock, uint32_t expected_idle_ticks);
+tickless_step_t tickless_clock_wakeup(tickless_clock_t *const p_clock, uint32_t slept_counts, uint32_t expected_idle_ticks);
+uint32_t tickless_clock_units_from_timer(uint32_t elapsed_timer_counts, uint32_t timer_counts_per_tick);
+uint32_t tickless_clock_timer_from_units(uint32_t units, uint32_t timer_counts_per_tick);
+
+#endif // TICKLESS_CLOCK_H
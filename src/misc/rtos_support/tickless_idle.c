@@ -0,0 +1,152 @@
+/**
+ * tickless_idle.c
+ *
+ * Tickless idle for FreeRTOS (`portSUPPRESS_TICKS_AND_SLEEP`). When every task is blocked, the idle task stops the
+ * SysTick timer, arms the RTC's second compare channel to wake the core just before the kernel's next unblock time and
+ * sleeps (WFI) with only the CPU clock stopped. The 32.768 kHz RTC keeps time while asleep; on waking, the tick count
+ * is brought up to date (see tickless_clock.c) and SysTick restarts part way through the tick so that no time is lost.
+ *
+ * The RTC interrupt only ever wakes the core: interrupts stay masked from before the sleep until the compare match has
+ * been cleared, so the ASF RTC handler never sees it. Any other interrupt also ends the sleep early.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "tickless_idle.h"
+
+#include "atmel_start.h"
+#include "cycle_counter.h"
+#include "rtc_driver.h"
+
+// SysTick counts the CPU clock, one tick per reload
+#define TICKLESS_CYCLES_PER_TICK (configCPU_CLOCK_HZ / configTICK_RATE_HZ)
+
+_Static_assert(configTICK_RATE_HZ == TICKLESS_TICK_RATE_HZ, "tickless_clock.h assumes the kernel tick rate");
+
+static tickless_clock_t tick_clock = {0};
+static tickless_stats_t tickless_stats = {0};
+
+/**
+ * \fn init_tickless_idle
+ *
+ * \brief Starts the RTC and selects the sleep mode used by `tickless_idle_sleep()`. Must be called before the
+ *        scheduler starts.
+ */
+void init_tickless_idle(void) {
+    init_rtc_hardware();
+
+    // The write reaches the PM through a bridge; it must read back before the first WFI relies on it
+    hri_pm_write_SLEEPCFG_reg(PM, TICKLESS_IDLE_SLEEP_MODE);
+    while (hri_pm_read_SLEEPCFG_reg(PM) != TICKLESS_IDLE_SLEEP_MODE) {
+    }
+
+    reset_tickless_stats();
+}
+
+/**
+ * \fn tickless_idle_sleep
+ *
+ * \brief Sleeps until the kernel's next unblock time or the first interrupt, whichever is sooner, and accounts for the
+ *        ticks that passed (`portSUPPRESS_TICKS_AND_SLEEP`, called by the idle task with the scheduler suspended)
+ *
+ * \param expected_idle_ticks ticks until the next task unblocks
+ */
+void tickless_idle_sleep(TickType_t expected_idle_ticks) {
+    if (expected_idle_ticks > TICKLESS_IDLE_MAX_TICKS) {
+        expected_idle_ticks = TICKLESS_IDLE_MAX_TICKS;
+    }
+
+    __disable_irq();
+
+    // Stop SysTick where it is: its count is how far into the current tick we are. If it reached zero just before
+    // being stopped, its interrupt is already pending and the next tick must not be slept through.
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    const uint32_t timer_value = SysTick->VAL;
+    const bool tick_already_pending = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+    tick_clock.units_into_tick = tickless_clock_units_from_timer(TICKLESS_CYCLES_PER_TICK - 1 - timer_value, TICKLESS_CYCLES_PER_TICK);
+
+    const uint32_t sleep_counts = tickless_clock_sleep_counts(&tick_clock, expected_idle_ticks);
+    uint32_t slept_counts = 0;
+    uint32_t awake_cycles = 0;
+    bool slept = false;
+    if (!tick_already_pending && eTaskConfirmSleepModeStatus() != eAbortSleep && sleep_counts >= TICKLESS_IDLE_MIN_SLEEP_COUNTS) {
+        const uint32_t start_cycles = get_cycle_count();
+        const uint32_t start_count = read_rtc_count();
+        if (arm_rtc_wakeup(start_count + sleep_counts)) {
+            __DSB();
+            __WFI();
+            __ISB();
+            slept_counts = read_rtc_count() - start_count;
+            // The cycle counter stops with the CPU clock, so it only saw the parts of the sleep spent awake
+            awake_cycles = get_cycle_count() - start_cycles;
+            slept = true;
+        }
+    }
+
+    // Restart SysTick for the rest of the current tick, then let it reload whole ticks again
+    const tickless_step_t step = tickless_clock_wakeup(&tick_clock, slept_counts, expected_idle_ticks);
+    uint32_t reload = TICKLESS_CYCLES_PER_TICK - tickless_clock_timer_from_units(tick_clock.units_into_tick, TICKLESS_CYCLES_PER_TICK);
+    if (reload < 2) {
+        reload = 2; // A reload value of 0 would stop SysTick
+    }
+    SysTick->LOAD = reload - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = TICKLESS_CYCLES_PER_TICK - 1;
+    if (step.tick_pending) {
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    }
+
+    if (slept) {
+        disarm_rtc_wakeup();
+
+        // Keep cycle-count differences (run-time stats, period jitter) in real time across the sleep
+        const uint32_t slept_cycles = (uint32_t)((uint64_t)slept_counts * configCPU_CLOCK_HZ / TICKLESS_RTC_HZ);
+        if (slept_cycles > awake_cycles) {
+            advance_cycle_count(slept_cycles - awake_cycles);
+        }
+
+        tickless_stats.sleeps++;
+        tickless_stats.slept_counts += slept_counts;
+        if (slept_counts < sleep_counts) {
+            tickless_stats.early_wakeups++;
+        }
+    } else {
+        tickless_stats.aborted_sleeps++;
+    }
+    if (step.ticks_to_step > 0) {
+        vTaskStepTick(step.ticks_to_step);
+        tickless_stats.suppressed_ticks += step.ticks_to_step;
+    }
+
+    __enable_irq();
+}
+
+/**
+ * \fn get_tickless_stats
+ *
+ * \brief Copies the idle statistics
+ *
+ * \param p_stats where to copy the statistics
+ * \param p_elapsed_counts set to the RTC counts since the statistics were reset, for working out idle residency
+ *        (`slept_counts` out of the elapsed counts); wraps after about 36 hours
+ */
+void get_tickless_stats(tickless_stats_t *const p_stats, uint32_t *const p_elapsed_counts) {
+    taskENTER_CRITICAL();
+    *p_stats = tickless_stats;
+    *p_elapsed_counts = read_rtc_count() - tickless_stats.since_rtc_count;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * \fn reset_tickless_stats
+ *
+ * \brief Clears the idle statistics and starts measuring idle residency from now
+ */
+void reset_tickless_stats(void) {
+    taskENTER_CRITICAL();
+    tickless_stats = (tickless_stats_t){0};
+    tickless_stats.since_rtc_count = read_rtc_count();
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,27 @@
+#ifndef TICKLESS_IDLE_H
+#define TICKLESS_IDLE_H
+
+#include "globals.h"
+#include "tickless_clock.h"
+
+// Constants
+#define TICKLESS_IDLE_MAX_TICKS 10000     // Longest single sleep; keeps each sleep well inside one cycle counter wrap
+#define TICKLESS_IDLE_MIN_SLEEP_COUNTS 8  // Shorter sleeps (~250 us) cost more in setup than they save
+#define TICKLESS_IDLE_SLEEP_MODE PM_SLEEPCFG_SLEEPMODE_IDLE0 // Only the CPU clock stops, so DMA and peripherals run on
+
+// Idle behaviour since boot or the last `reset_tickless_stats()`
+typedef struct {
+    uint32_t sleeps;           // Sleeps that were entered
+    uint32_t aborted_sleeps;   // Times the kernel asked to sleep but it was not worth or safe to
+    uint32_t early_wakeups;    // Sleeps ended by an interrupt before the RTC wakeup
+    uint32_t suppressed_ticks; // Tick interrupts that did not happen because the core was asleep
+    uint64_t slept_counts;     // RTC counts spent asleep
+    uint32_t since_rtc_count;  // RTC count when the stats were reset
+} tickless_stats_t;
+
+void init_tickless_idle(void);
+void tickless_idle_sleep(TickType_t expected_idle_ticks);
+void get_tickless_stats(tickless_stats_t *const p_stats, uint32_t *const p_elapsed_counts);
+void reset_tickless_stats(void);
+
+#endif // TICKLESS_IDLE_H
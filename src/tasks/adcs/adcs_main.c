@@ -4,7 +4,7 @@
  * Main loop of the ADCS task which handles sun sensing for ADCS and RTC timer
  *
  * Created: September 20, 2025
- * Modified: November 24, 2025
+ * Modified: October 17, 2026
  * Authors: Avinash Patel, Yi Lyo, Alexander Thaep
  */
 
@@ -12,6 +12,7 @@
 #include "command_dispatcher_task.h"
 #include "globals.h"
 #include "logging.h"
+#include "task_period.h"
 #include "watchdog_task.h"
 
 // ADCS Task memory structures
@@ -69,45 +70,28 @@ void main_adcs(void *pvParameters) {
 
     // Obtain a pointer to the current task within the global task list
     pvdx_task_t *const current_task = get_current_task();
-    // Cache the watchdog checkin command to avoid creating it every iteration
-    command_t cmd_checkin = get_watchdog_checkin_command(current_task);
-    // Calculate the maximum time this task should block (and thus be unable to check in with the watchdog)
-    const TickType_t queue_block_time_ticks = get_command_queue_block_time_ticks(current_task);
-    // Variable to hold commands popped off the queue
-    command_t cmd;
 
     info("photodiodes: Initialized with %d photodiodes\n", PHOTODIODE_COUNT);
     info("magnetometer: Initialized with %d cycle count\n", INITIAL_CC);
 
+    // Releases are on a fixed `ADCS_TASK_PERIOD_MS` schedule from here on, and each one runs the control loop once
+    start_task_period(current_task);
     while (true) {
-        debug_impl("\n---------- Magnetometer & Photodiode & RTC & Processing Run ----------\n");
+        debug("\n---------- Magnetometer & Photodiode & RTC & Processing Run ----------\n");
 
-        // Block waiting for at least one command to appear in the command queue
-        if (xQueueReceive(p_adcs_task->command_queue, &cmd, queue_block_time_ticks) == pdPASS) {
-            // Once there is at least one command in the queue, empty the entire queue
-            info("adcs: performing command\n");
-            do {
-                switch (cmd.operation) {
-                    case OPERATION_READ:
-                        debug("photo/mag/rtc: Command popped off queue. Target: %d, Operation: %d\n", cmd.target, cmd.operation);
-                        break;
-                    case OPERATION_PROCESS:
-                        debug("adcs processing: Command popped off queue. Target: %d, Operation: %d\n", cmd.target, cmd.operation);
-                        exec_command_adcs_process(&cmd);
-                        break;
-                    default:
-                        fatal("adcs: Invalid operation!\n");
-                        cmd.result = ERROR_SANITY_CHECK_FAILED;
-                        break;
-                }
-            } while (xQueueReceive(p_adcs_task->command_queue, &cmd, 0) == pdPASS);
+        // Read the sensors and process the readings at the start of the release
+        const status_t result = run_adcs_control_step(current_task->period_ms);
+        if (result != SUCCESS) {
+            debug("adcs: processing run failed (status %d)\n", result);
         }
-        debug("adcs: No more commands queued.\n");
 
-        // Check in with the watchdog task
+        // Check in with the watchdog task once per period
         if (should_checkin(current_task)) {
-            enqueue_command(&cmd_checkin);
-            debug("adcs: Enqueued watchdog checkin command\n");
+            checkin_with_watchdog(current_task);
+            debug("adcs: Checked in with watchdog\n");
         }
+
+        // Execute commands (urgent lane first) until the next period starts
+        wait_for_next_release(current_task);
     }
 }
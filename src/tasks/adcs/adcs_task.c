@@ -18,7 +18,7 @@
 #include "task_list.h"
 
 float K_VALUE = 1.0e9; // B-dot gain constant
-float DT_VALUE = 1.0;  // Time step for B-dot control
+float DT_VALUE = 1.0;  // Time step for B-dot control (the ADCS release period, see `run_adcs_control_step()`)
 
 /* ---------- DATA MANAGEMENT ------------------------ */
 
@@ -197,19 +197,46 @@ command_t get_photomagrtc_read_command() {
 /* ---------- NON-DISPATCHABLE FUNCTIONS (do not go through the command dispatcher) ---------- */
 
 /**
- * \fn exec_command_adcs_process
+ * \fn read_adcs_sensors
  *
- * \brief Executes function corresponding to the command
+ * \brief Reads the ADCS sensors. Only the RTC is read for now: the photodiode and magnetometer hardware is not
+ *        initialised yet (see `init_adcs()`), so a read that gets the RTC time still reports `ERROR_NOT_READY` rather
+ *        than claiming a full set of readings.
  *
- * \param p_cmd a pointer to a command containing information for processing
+ * \param data the buffers that receive the readings, newest first
+ *
+ * \returns `status_t`, the status of the read
  */
-void exec_command_adcs_process(command_t *const p_cmd) {
-    if (p_cmd->target != p_adcs_task) {
-        fatal("adcs processing: command target is not adcs! target: %d operation: %d\n", p_cmd->target, p_cmd->operation);
+status_t read_adcs_sensors(adcs_data_t *const data) {
+    if (data == NULL || data->rtc_buffer == NULL || data->rtc_buffer_len == 0) {
+        return ERROR_SANITY_CHECK_FAILED;
+    }
+
+    // first move previous rtc data backwards in the array
+    for (size_t i = data->rtc_buffer_len - 1; i > 0; i--) {
+        data->rtc_buffer[i] = data->rtc_buffer[i - 1];
+    }
+
+    const status_t rtc_status = get_rtc_values(&data->rtc_buffer[0]);
+    if (rtc_status != SUCCESS) {
+        return rtc_status;
     }
 
+    // TODO: read the photodiodes and magnetometer too once `init_adcs()` initialises their hardware
+    return ERROR_NOT_READY;
+}
+
+/**
+ * \fn process_adcs_readings
+ *
+ * \brief Runs ADCS processing on the latest readings
+ *
+ * \param data the readings to process
+ *
+ * \returns `status_t`, the status of the processing run
+ */
+status_t process_adcs_readings(const adcs_data_t *const data) {
     rtc_data_t temp;
-    const adcs_data_t *data = p_cmd->data.adcs_data;
     status_t rtc_status = get_rtc_values(&temp);
 
     if (data == NULL) {
@@ -222,9 +249,53 @@ void exec_command_adcs_process(command_t *const p_cmd) {
     info("ADCS seconds count: %lu\n", temp.seconds_count);
     info("ADCS mag reading [x,y,z]: [%f,%f,%f]\n", mag_data_buffer[0].x, mag_data_buffer[0].y, mag_data_buffer[0].z);
 
-    if (rtc_status == SUCCESS)
-        p_cmd->result = SUCCESS;
-    p_cmd->result = ERROR_PROCESSING_FAILED;
+    return rtc_status == SUCCESS ? SUCCESS : ERROR_PROCESSING_FAILED;
+}
+
+/**
+ * \fn run_adcs_control_step
+ *
+ * \brief One job of the periodic ADCS task: reads the sensors, then processes the readings. The B-dot time step is
+ *        the release period, so the controller's model stays in step with how often it actually runs.
+ *
+ * \param period_ms the ADCS task's release period
+ *
+ * \returns `status_t`, the status of the processing run
+ */
+status_t run_adcs_control_step(uint32_t period_ms) {
+    DT_VALUE = period_ms / 1000.0f;
+
+    const status_t read_status = read_adcs_sensors(&latest_adcs_data_reading);
+    if (read_status != SUCCESS) {
+        debug("adcs: sensor read incomplete (status %d)\n", read_status);
+    }
+    return process_adcs_readings(&latest_adcs_data_reading);
+}
+
+/**
+ * \fn exec_command_adcs_read
+ *
+ * \brief Executes an `OPERATION_READ` command (routed by `exec_command()`), for reads requested outside the ADCS
+ *        task's own releases
+ *
+ * \param p_cmd a pointer to a command whose `data.adcs_data` receives the readings, newest first
+ */
+void exec_command_adcs_read(command_t *const p_cmd) {
+    debug("photo/mag/rtc: Command popped off queue. Target: %d, Operation: %d\n", p_cmd->target, p_cmd->operation);
+    p_cmd->result = read_adcs_sensors(p_cmd->data.adcs_data);
+}
+
+/**
+ * \fn exec_command_adcs_process
+ *
+ * \brief Executes an `OPERATION_PROCESS` command (routed by `exec_command()`), for processing requested outside the
+ *        ADCS task's own releases
+ *
+ * \param p_cmd a pointer to a command containing information for processing
+ */
+void exec_command_adcs_process(command_t *const p_cmd) {
+    debug("adcs processing: Command popped off queue. Target: %d, Operation: %d\n", p_cmd->target, p_cmd->operation);
+    p_cmd->result = process_adcs_readings(p_cmd->data.adcs_data);
 }
 
 float_3d_t compute_sun_vector(photodiode_data_t *input) {
@@ -24,6 +24,7 @@
 
 // Constants
 #define ADCS_TASK_STACK_SIZE 1024 // Size of the stack in words (multiply by 4 to get bytes)
+#define ADCS_TASK_PERIOD_MS 1000  // Period the ADCS loop is released at (also the B-dot control time step)
 
 // Placed in a struct to ensure that the TCB is placed higher than the stack in memory
 //^ This ensures that stack overflows do not corrupt the TCB (since the stack grows downwards)
@@ -32,6 +33,7 @@ typedef struct {
     StackType_t adcs_task_stack[ADCS_TASK_STACK_SIZE];
     uint8_t adcs_command_queue_buffer[COMMAND_QUEUE_MAX_COMMANDS * COMMAND_QUEUE_ITEM_SIZE];
     StaticQueue_t adcs_task_queue;
+    command_queue_set_memory_t adcs_queue_set_mem;
     StaticTask_t adcs_task_tcb;
 } adcs_task_memory_t;
 
@@ -55,6 +57,10 @@ QueueHandle_t init_adcs(void);
 void main_adcs(void *pvParameters);
 command_t get_photomagrtc_read_command(void);
 command_t get_adcs_process_command(adcs_data_t *const data);
+status_t read_adcs_sensors(adcs_data_t *const data);
+status_t process_adcs_readings(const adcs_data_t *const data);
+status_t run_adcs_control_step(uint32_t period_ms);
+void exec_command_adcs_read(command_t *const p_cmd);
 void exec_command_adcs_process(command_t *const p_cmd);
 sun_vector_t compute_sun_vector(photodiode_data_t *input);
 bool tumbling(SCH1_result_t *gyro_data);         // TODO define
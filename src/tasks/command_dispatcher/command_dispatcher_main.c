@@ -28,33 +28,34 @@ void main_command_dispatcher(void *pvParameters) {
 
     // Obtain a pointer to the current task within the global task list
     pvdx_task_t *const current_task = get_current_task();
-    // Cache the watchdog checkin command to avoid creating it every iteration
-    command_t cmd_checkin = get_watchdog_checkin_command(current_task);
     // Calculate the maximum time the command dispatcher should block (and thus be unable to check in with the watchdog)
     const TickType_t queue_block_time_ticks = get_command_queue_block_time_ticks(current_task);
-    // Varible to hold commands popped off the queue
-    command_t cmd;
+    // Absolute tick count at which the next watchdog checkin is due (due immediately on startup)
+    TickType_t next_checkin_ticks = xTaskGetTickCount();
+    // Commands popped off the queue, forwarded together so that each target is woken at most once per batch
+    static command_t batch[COMMAND_DISPATCH_BATCH_MAX];
 
     while (true) {
         debug("\n---------- Command Dispatcher Task Loop ----------\n");
 
-        // Block waiting for at least one command to appear in the command queue
-        if (xQueueReceive(p_command_dispatcher_task->command_queue, &cmd, queue_block_time_ticks) == pdPASS) {
-            // Once there is at least one command in the queue, empty the entire queue
-            do {
-                debug("command_dispatcher: Command popped off queue. Target: %d, Operation: %d\n", cmd.target, cmd.operation);
-                dispatch_command(&cmd);
-            } while (xQueueReceive(p_command_dispatcher_task->command_queue, &cmd, 0) == pdPASS);
+        // Sleep until a command arrives or the next checkin is due; there is no fixed polling delay
+        if (receive_command(current_task, &batch[0], ticks_until(next_checkin_ticks))) {
+            // Drain whatever else arrived in the same burst without blocking
+            size_t batch_size = 1;
+            while (batch_size < COMMAND_DISPATCH_BATCH_MAX && receive_command(current_task, &batch[batch_size], 0)) {
+                batch_size++;
+            }
+            debug("command_dispatcher: %d commands popped off queue\n", batch_size);
+            dispatch_commands(batch, batch_size);
         }
-        debug("command_dispatcher: No more commands queued.\n");
 
         // Check in with the watchdog task
-        if (should_checkin(current_task)) {
-            enqueue_command(&cmd_checkin);
-            debug("command_dispatcher: Enqueued watchdog checkin command\n");
+        if (ticks_until(next_checkin_ticks) == 0) {
+            if (should_checkin(current_task)) {
+                checkin_with_watchdog(current_task);
+                debug("command_dispatcher: Checked in with watchdog\n");
+            }
+            next_checkin_ticks = xTaskGetTickCount() + queue_block_time_ticks;
         }
-
-        // Guarantee other tasks get time to run
-        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
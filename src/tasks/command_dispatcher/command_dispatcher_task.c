@@ -12,8 +12,42 @@
 
 #include "command_dispatcher_task.h"
 
+#include "command_encoding.h"
+#include "command_schedule.h"
+#include "command_trace.h"
+#include "cycle_counter.h"
 #include "task_list.h"
 
+// How `enqueue_command()` currently delivers commands (see `dispatch_mode_t`)
+static dispatch_mode_t dispatch_mode = COMMAND_DISPATCHER_DEFAULT_MODE;
+
+// Running totals kept by the audit hook
+static command_dispatcher_stats_t dispatcher_stats = {0};
+
+// What happens to each operation when it is sent to a full lane (see `overflow_policy_t`)
+static overflow_policy_config_t overflow_policies[NUM_OPERATIONS] = {
+    [OPERATION_POWER_OFF] = {OVERFLOW_POLICY_BOUNDED_WAIT, OVERFLOW_DEFAULT_WAIT_MS},
+    [OPERATION_CHECKIN] = {OVERFLOW_POLICY_COALESCE, OVERFLOW_DEFAULT_WAIT_MS},
+    [OPERATION_INIT_SUBTASKS] = {OVERFLOW_POLICY_COALESCE, OVERFLOW_DEFAULT_WAIT_MS},
+    [OPERATION_ENABLE_SUBTASK] = {OVERFLOW_POLICY_BOUNDED_WAIT, OVERFLOW_DEFAULT_WAIT_MS},
+    [OPERATION_DISABLE_SUBTASK] = {OVERFLOW_POLICY_BOUNDED_WAIT, OVERFLOW_DEFAULT_WAIT_MS},
+    [OPERATION_SET_MODE] = {OVERFLOW_POLICY_BOUNDED_WAIT, OVERFLOW_DEFAULT_WAIT_MS},
+    [OPERATION_DISPLAY_IMAGE] = {OVERFLOW_POLICY_DROP_OLDEST, 0}, // Only the most recent image matters
+    [OPERATION_CLEAR_IMAGE] = {OVERFLOW_POLICY_DROP_OLDEST, 0},
+    [OPERATION_READ] = {OVERFLOW_POLICY_DROP_OLDEST, 0}, // Stale sensor reads are worthless
+    [OPERATION_PROCESS] = {OVERFLOW_POLICY_COALESCE, 0},
+    [TEST_OP] = {OVERFLOW_POLICY_DROP_NEWEST, 0},
+};
+
+// Where a command is being sent from, which decides whether a full lane may block the sender
+typedef enum {
+    SEND_CONTEXT_TASK = 0, // An ordinary task, which may block for the overflow policy's bounded wait
+    SEND_CONTEXT_BATCH,    // A task that has suspended the scheduler for a batch (see `enqueue_commands()`)
+    SEND_CONTEXT_NO_WAIT,  // A context that must never block, such as a timer callback (see `enqueue_command_no_wait()`)
+} send_context_t;
+
+static status_t forward_to_lane(command_t *const p_cmd, send_context_t context);
+
 /* ---------- DISPATCHABLE FUNCTIONS (sent as commands through the command dispatcher task) ---------- */
 
 // NOTE: No dispatchable functions for the command dispatcher task. Its sole purpose is to
@@ -39,52 +73,674 @@ QueueHandle_t init_command_dispatcher(void) {
         fatal("Failed to create command queue!\n");
     }
 
+    // Periodic commands are emitted into the dispatcher, so tasks initialised later can schedule theirs
+    init_command_schedule();
+
     return command_dispatcher_command_queue_handle;
 }
 
+/**
+ * \fn set_dispatch_mode
+ *
+ * \brief Selects how `enqueue_command()` delivers commands to their target task
+ *
+ * \param mode `DISPATCH_MODE_HUB` to route through the Command Dispatcher queue, or `DISPATCH_MODE_DIRECT`
+ *      to write straight into the target's queue
+ */
+void set_dispatch_mode(dispatch_mode_t mode) {
+    dispatch_mode = mode;
+}
+
+/**
+ * \fn get_dispatch_mode
+ *
+ * \returns `dispatch_mode_t`, the mode currently used by `enqueue_command()`
+ */
+dispatch_mode_t get_dispatch_mode(void) {
+    return dispatch_mode;
+}
+
+/**
+ * \fn get_command_dispatcher_stats
+ *
+ * \returns `command_dispatcher_stats_t`, a snapshot of the audit counters
+ */
+command_dispatcher_stats_t get_command_dispatcher_stats(void) {
+    taskENTER_CRITICAL();
+    command_dispatcher_stats_t snapshot = dispatcher_stats;
+    taskEXIT_CRITICAL();
+    return snapshot;
+}
+
+/**
+ * \fn audit_command
+ *
+ * \brief Logging/audit hook called for every command that passes through the dispatcher, regardless of
+ *        the dispatch mode. This is the single place where the hub-and-spoke architecture observes traffic.
+ *
+ * \param p_cmd a pointer to the command being forwarded
+ * \param status the outcome of validating the command (`SUCCESS` if it will be forwarded)
+ */
+void audit_command(const command_t *const p_cmd, status_t status) {
+    taskENTER_CRITICAL();
+    if (status == SUCCESS) {
+        dispatcher_stats.commands_forwarded++;
+    } else {
+        dispatcher_stats.commands_rejected++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (status == SUCCESS) {
+        debug("command-dispatcher: Forwarding operation %d to %s task\n", p_cmd->operation, p_cmd->target->name);
+    } else {
+        debug("command-dispatcher: Rejected operation %d (status %d)\n", p_cmd->operation, status);
+    }
+}
+
+/**
+ * \fn get_command_lane
+ *
+ * \brief Chooses which lane of the target's command queue an operation is placed on
+ *
+ * \param operation the operation being dispatched
+ *
+ * \returns `command_lane_t`, `COMMAND_LANE_URGENT` for operations that must not wait behind bulk work
+ */
+command_lane_t get_command_lane(operation_t operation) {
+    switch (operation) {
+        case OPERATION_CHECKIN:
+        case OPERATION_POWER_OFF:
+            return COMMAND_LANE_URGENT;
+        default:
+            return COMMAND_LANE_NORMAL;
+    }
+}
+
+/**
+ * \fn set_overflow_policy
+ *
+ * \brief Changes what happens when an operation is sent to a full lane
+ *
+ * \param operation the operation to configure
+ * \param policy the new overflow policy
+ * \param wait_ms the maximum time to block the sender (bounded wait and coalesce only)
+ *
+ * \returns `status_t`, `ERROR_SANITY_CHECK_FAILED` if the operation does not exist
+ */
+status_t set_overflow_policy(operation_t operation, overflow_policy_t policy, uint32_t wait_ms) {
+    if (operation >= NUM_OPERATIONS) {
+        return ERROR_SANITY_CHECK_FAILED;
+    }
+
+    taskENTER_CRITICAL();
+    overflow_policies[operation] = (overflow_policy_config_t){.policy = policy, .wait_ms = wait_ms};
+    taskEXIT_CRITICAL();
+    return SUCCESS;
+}
+
+/**
+ * \fn get_overflow_policy
+ *
+ * \returns `overflow_policy_config_t`, the overflow policy of the given operation
+ */
+overflow_policy_config_t get_overflow_policy(operation_t operation) {
+    if (operation >= NUM_OPERATIONS) {
+        return (overflow_policy_config_t){.policy = OVERFLOW_POLICY_DROP_NEWEST, .wait_ms = 0};
+    }
+
+    taskENTER_CRITICAL();
+    overflow_policy_config_t config = overflow_policies[operation];
+    taskEXIT_CRITICAL();
+    return config;
+}
+
+/**
+ * \fn pending_command_matches
+ *
+ * \returns `bool`, whether a pending-command slot holds a command identical to `p_cmd`
+ */
+static inline bool pending_command_matches(const pending_command_key_t *const p_key, const command_t *const p_cmd) {
+    return p_key->in_use && p_key->target == p_cmd->target && p_key->operation == p_cmd->operation && p_key->data == p_cmd->data.raw;
+}
+
+/**
+ * \fn claim_pending_command
+ *
+ * \brief Records that `p_cmd` is about to be queued for `p_task`, unless an identical command is already queued
+ *
+ * \param p_task the task whose lane the command is sent to
+ * \param p_cmd a pointer to the command being sent
+ *
+ * \returns `bool`, false if an identical command is already pending (so `p_cmd` should be coalesced into it)
+ *
+ * \note If the table is full the command is simply not tracked, so a later duplicate is queued instead of coalesced
+ */
+static bool claim_pending_command(pvdx_task_t *const p_task, const command_t *const p_cmd) {
+    pending_command_key_t *p_free_slot = NULL;
+    bool claimed = true;
+
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < COMMAND_COALESCE_TABLE_SIZE; i++) {
+        pending_command_key_t *const p_key = &p_task->pending_commands[i];
+        if (pending_command_matches(p_key, p_cmd)) {
+            claimed = false;
+            break;
+        }
+        if (!p_key->in_use && p_free_slot == NULL) {
+            p_free_slot = p_key;
+        }
+    }
+    if (claimed && p_free_slot != NULL) {
+        *p_free_slot = (pending_command_key_t){
+            .target = p_cmd->target, .data = p_cmd->data.raw, .operation = (uint8_t)p_cmd->operation, .in_use = true};
+    }
+    taskEXIT_CRITICAL();
+
+    return claimed;
+}
+
+/**
+ * \fn release_pending_command
+ *
+ * \brief Forgets a coalescable command once it has left `p_task`'s lane, so that the next identical command is queued
+ *        again. Called by `receive_command()` for every dequeued command.
+ *
+ * \param p_task the task whose lane the command left
+ * \param p_cmd a pointer to the command that left the lane
+ */
+void release_pending_command(pvdx_task_t *const p_task, const command_t *const p_cmd) {
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < COMMAND_COALESCE_TABLE_SIZE; i++) {
+        if (pending_command_matches(&p_task->pending_commands[i], p_cmd)) {
+            p_task->pending_commands[i].in_use = false;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * \fn drop_oldest_command
+ *
+ * \brief Discards the oldest command in a lane to make room for a new one. The requester of the discarded command (if
+ *        any) is completed with `ERROR_QUEUE_FULL`.
+ *
+ * \param p_task the task owning the lane
+ * \param lane_queue the lane to discard from
+ *
+ * \returns `bool`, true if a command was discarded
+ *
+ * \note Reading a lane directly leaves an extra entry in the task's queue set, which `receive_command()` later skips.
+ *       At most `COMMAND_QUEUE_SET_SLACK` such entries may be outstanding, otherwise the set could overflow.
+ */
+static bool drop_oldest_command(pvdx_task_t *const p_task, QueueHandle_t lane_queue) {
+    packed_command_t packed;
+    command_t dropped;
+    bool room_in_set = true;
+
+    taskENTER_CRITICAL();
+    if (p_task->command_queue_set != NULL) {
+        room_in_set = p_task->queue_set_surplus < COMMAND_QUEUE_SET_SLACK;
+        if (room_in_set) {
+            p_task->queue_set_surplus++;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (!room_in_set) {
+        return false;
+    }
+    if (xQueueReceive(lane_queue, &packed, 0) != pdPASS) {
+        // The lane was drained in the meantime, so no set entry was orphaned
+        taskENTER_CRITICAL();
+        if (p_task->command_queue_set != NULL) {
+            p_task->queue_set_surplus--;
+        }
+        taskEXIT_CRITICAL();
+        return true;
+    }
+
+    unpack_command(&packed, &dropped);
+
+    taskENTER_CRITICAL();
+    dispatcher_stats.dropped_oldest++;
+    taskEXIT_CRITICAL();
+
+    release_pending_command(p_task, &dropped);
+    dropped.result = ERROR_QUEUE_FULL;
+    complete_command(&dropped);
+    warning("command-dispatcher: %s lane full, dropped oldest command (operation %d)\n", p_task->name, dropped.operation);
+    return true;
+}
+
+/**
+ * \fn send_to_lane
+ *
+ * \brief Timestamps a command and copies it onto the lane of `p_task`'s command queue chosen by its operation. Tasks
+ *        without an urgent lane receive every command on their normal lane. If the lane is full, the operation's
+ *        overflow policy decides what happens (see `overflow_policy_t`).
+ *
+ * \param p_task the task whose command queue the command is copied onto
+ * \param p_cmd a pointer to the command struct to be sent
+ * \param context where the command is sent from. A bounded wait cannot block with the scheduler suspended, so a
+ *        batch is paused while it waits; a sender that must not block skips the wait and the command is dropped.
+ *
+ * \returns `status_t`, `SUCCESS` if the command was queued or coalesced, `ERROR_QUEUE_FULL` if it was dropped
+ */
+static status_t send_to_lane(pvdx_task_t *const p_task, command_t *const p_cmd, send_context_t context) {
+    command_lane_t lane = COMMAND_LANE_NORMAL;
+    QueueHandle_t lane_queue = p_task->command_queue;
+    if (p_task->urgent_command_queue != NULL && get_command_lane(p_cmd->operation) == COMMAND_LANE_URGENT) {
+        lane = COMMAND_LANE_URGENT;
+        lane_queue = p_task->urgent_command_queue;
+    }
+    if (lane_queue == NULL) {
+        fatal("command-dispatcher: %s task has no command queue!\n", p_task->name);
+    }
+
+    const overflow_policy_config_t config = get_overflow_policy(p_cmd->operation);
+
+    // Commands with a waiting requester need their own result, so they are never merged into another command
+    const bool coalescable = config.policy == OVERFLOW_POLICY_COALESCE && p_cmd->requester == NULL;
+    if (coalescable && !claim_pending_command(p_task, p_cmd)) {
+        taskENTER_CRITICAL();
+        dispatcher_stats.coalesced++;
+        taskEXIT_CRITICAL();
+        return SUCCESS;
+    }
+
+    // Never 0, which marks a command that arrived without metadata (see `unpack_command()`)
+    p_cmd->enqueued_cycles = get_cycle_count() | 1;
+    packed_command_t packed;
+    if (!pack_command(p_cmd, &packed) && p_cmd->requester != NULL) {
+        // The requester could never be completed, so the command is refused instead of sent without metadata
+        if (coalescable) {
+            release_pending_command(p_task, p_cmd);
+        }
+        warning("command-dispatcher: command metadata pool exhausted, dropped operation %d\n", p_cmd->operation);
+        return ERROR_QUEUE_FULL;
+    }
+
+    if (xQueueSendToBack(lane_queue, &packed, 0) == pdTRUE) {
+        command_trace_queue_depth(p_task, lane, uxQueueMessagesWaiting(lane_queue));
+        return SUCCESS;
+    }
+
+    // The lane is full
+    BaseType_t sent = pdFALSE;
+    switch (config.policy) {
+        case OVERFLOW_POLICY_BOUNDED_WAIT:
+        case OVERFLOW_POLICY_COALESCE:
+            if (config.wait_ms > 0 && context != SEND_CONTEXT_NO_WAIT) {
+                taskENTER_CRITICAL();
+                dispatcher_stats.overflow_waits++;
+                taskEXIT_CRITICAL();
+                if (context == SEND_CONTEXT_BATCH) {
+                    xTaskResumeAll();
+                }
+                sent = xQueueSendToBack(lane_queue, &packed, pdMS_TO_TICKS(config.wait_ms));
+                if (context == SEND_CONTEXT_BATCH) {
+                    vTaskSuspendAll();
+                }
+            }
+            if (sent != pdTRUE) {
+                taskENTER_CRITICAL();
+                dispatcher_stats.overflow_timeouts++;
+                taskEXIT_CRITICAL();
+            }
+            break;
+        case OVERFLOW_POLICY_DROP_OLDEST:
+            if (drop_oldest_command(p_task, lane_queue)) {
+                sent = xQueueSendToBack(lane_queue, &packed, 0);
+            }
+            // Falls back to dropping the new command if room could not be made
+            break;
+        case OVERFLOW_POLICY_DROP_NEWEST:
+        default:
+            break;
+    }
+
+    if (sent == pdTRUE) {
+        command_trace_queue_depth(p_task, lane, uxQueueMessagesWaiting(lane_queue));
+        return SUCCESS;
+    }
+
+    if (config.policy == OVERFLOW_POLICY_DROP_NEWEST || config.policy == OVERFLOW_POLICY_DROP_OLDEST) {
+        taskENTER_CRITICAL();
+        dispatcher_stats.dropped_newest++;
+        taskEXIT_CRITICAL();
+    }
+    release_command_meta(&packed);
+    if (coalescable) {
+        release_pending_command(p_task, p_cmd);
+    }
+    warning("command-dispatcher: %s lane full, dropped operation %d\n", p_task->name, p_cmd->operation);
+    return ERROR_QUEUE_FULL;
+}
+
+/**
+ * \fn submit_command
+ *
+ * \brief Traces and validates a command and hands it to the Command Dispatcher queue or, in `DISPATCH_MODE_DIRECT`,
+ *        straight to the target's lane
+ *
+ * \param p_cmd a pointer to the command struct to be enqueued
+ * \param context where the command is sent from (see `send_to_lane()`)
+ *
+ * \return status_t, see `enqueue_command()`
+ */
+static status_t submit_command(command_t *const p_cmd, send_context_t context) {
+    command_trace_enqueue(p_cmd);
+
+    // Reject commands the target cannot execute here, rather than as a fatal error inside the target task
+    const status_t validity = validate_command(p_cmd);
+    if (validity != SUCCESS) {
+        audit_command(p_cmd, validity);
+        p_cmd->result = validity;
+        return validity;
+    }
+
+    if (dispatch_mode == DISPATCH_MODE_DIRECT) {
+        return forward_to_lane(p_cmd, context);
+    }
+
+    return send_to_lane(p_command_dispatcher_task, p_cmd, context);
+}
+
 /**
  * \fn enqueue_command
  *
- * \brief Enqueue a command to be forwarded by the command dispatcher
+ * \brief Enqueue a command to be forwarded by the command dispatcher. In `DISPATCH_MODE_HUB` the command is
+ *        copied onto the Command Dispatcher queue; in `DISPATCH_MODE_DIRECT` it is validated, audited and
+ *        written straight into the target's queue from the caller's context.
  *
  * \param p_cmd a pointer to the command struct to be enqueued
+ *
+ * \return status_t, `SUCCESS` if the command was queued, `ERROR_QUEUE_FULL` if the overflow policy dropped it,
+ *         `ERROR_INVALID_COMMAND` if the target has no route for it (see `command_routing.c`), or the reason it was
+ *         rejected (direct mode only)
+ */
+status_t enqueue_command(command_t *const p_cmd) {
+    return submit_command(p_cmd, SEND_CONTEXT_TASK);
+}
+
+/**
+ * \fn enqueue_command_no_wait
+ *
+ * \brief Form of `enqueue_command()` that never blocks: where the overflow policy would make the sender wait for room
+ *        in a full lane, the command is dropped straight away. For callers that must not block, such as software timer
+ *        callbacks running in the timer service task.
+ *
+ * \param p_cmd a pointer to the command struct to be enqueued; must not have a requester waiting on it
+ *
+ * \return status_t, see `enqueue_command()`
+ */
+status_t enqueue_command_no_wait(command_t *const p_cmd) {
+    return submit_command(p_cmd, SEND_CONTEXT_NO_WAIT);
+}
+
+/**
+ * \fn enqueue_commands
+ *
+ * \brief Enqueues a burst of commands with the scheduler suspended, so that no target (or, in hub mode, the Command
+ *        Dispatcher) preempts the caller part-way through. Each woken task becomes ready only once, when the whole
+ *        burst has been queued, and then drains all of its commands in one go.
+ *
+ * \param p_cmds array of commands to enqueue, in order
+ * \param num_cmds number of commands in `p_cmds`
+ *
+ * \return status_t, `SUCCESS` if every command was queued, otherwise the first failure (the remaining commands are
+ *         still enqueued)
+ *
+ * \note The commands are copied before they are sent, so `p_cmds` is not updated with trace IDs or results, and
+ *       none of them may have a requester waiting on it
+ * \warning must not be called with the scheduler already suspended
+ */
+status_t enqueue_commands(const command_t *const p_cmds, size_t num_cmds) {
+    status_t first_failure = SUCCESS;
+
+    vTaskSuspendAll();
+    for (size_t i = 0; i < num_cmds; i++) {
+        command_t cmd = p_cmds[i];
+        const status_t status = submit_command(&cmd, SEND_CONTEXT_BATCH);
+        if (status != SUCCESS && first_failure == SUCCESS) {
+            first_failure = status;
+        }
+    }
+    xTaskResumeAll();
+
+    return first_failure;
+}
+
+/**
+ * \fn enqueue_command_and_wait
+ *
+ * \brief Enqueues a command and blocks the calling task (only) until the target task has executed it and published
+ *        its result with `complete_command()`, or until the timeout expires
+ *
+ * \param p_cmd a pointer to the command struct to be enqueued; its `result` is updated before returning
+ * \param timeout_ticks the maximum time to wait for the result
+ *
+ * \return status_t, the result of the command, the reason it was rejected, or `ERROR_TIMEOUT`
+ *
+ * \warning must be called from a PVDX task, and a task may not wait on a command targeting itself (that would
+ *          deadlock); both are rejected with `ERROR_BAD_TARGET`
+ */
+status_t enqueue_command_and_wait(command_t *const p_cmd, TickType_t timeout_ticks) {
+    pvdx_task_t *const p_requester = get_current_task();
+    if (p_requester == NULL || p_cmd->target == p_requester) {
+        p_cmd->result = ERROR_BAD_TARGET;
+        return ERROR_BAD_TARGET;
+    }
+
+    // Tag this wait so that a completion for an earlier wait that timed out is not mistaken for this one
+    p_requester->completion_sequence = (p_requester->completion_sequence + 1) & COMPLETION_SEQUENCE_MASK;
+    p_cmd->requester = p_requester;
+    p_cmd->completion_sequence = p_requester->completion_sequence;
+
+    const uint32_t start_cycles = get_cycle_count();
+    const TickType_t deadline_ticks = xTaskGetTickCount() + timeout_ticks;
+
+    status_t status = enqueue_command(p_cmd);
+    if (status != SUCCESS) {
+        p_cmd->result = status;
+        return status;
+    }
+
+    uint32_t notification_value;
+    do {
+        if (xTaskNotifyWait(0, UINT32_MAX, &notification_value, ticks_until(deadline_ticks)) != pdTRUE) {
+            taskENTER_CRITICAL();
+            dispatcher_stats.completion_timeouts++;
+            taskEXIT_CRITICAL();
+            warning("command-dispatcher: %s task timed out waiting for operation %d\n", p_requester->name, p_cmd->operation);
+            p_cmd->result = ERROR_TIMEOUT;
+            return ERROR_TIMEOUT;
+        }
+    } while ((notification_value >> COMPLETION_RESULT_BITS) != p_cmd->completion_sequence);
+
+    const uint32_t latency_us = cycles_to_us(get_cycle_count() - start_cycles);
+    taskENTER_CRITICAL();
+    dispatcher_stats.commands_completed++;
+    dispatcher_stats.last_completion_us = latency_us;
+    if (latency_us > dispatcher_stats.max_completion_us) {
+        dispatcher_stats.max_completion_us = latency_us;
+    }
+    taskEXIT_CRITICAL();
+
+    p_cmd->result = (status_t)(notification_value & COMPLETION_RESULT_MASK);
+    return p_cmd->result;
+}
+
+/**
+ * \fn complete_command
+ *
+ * \brief Publishes the result of an executed command back to the task waiting in `enqueue_command_and_wait()`.
+ *        Every task calls this after executing each command it receives.
+ *
+ * \param p_cmd a pointer to the executed command, with `result` set
+ *
+ * \note Does nothing for commands that were enqueued without waiting, or whose requester has since given up and
+ *       started waiting on another command (the late result would overwrite the one it is waiting for)
+ */
+void complete_command(const command_t *const p_cmd) {
+    command_trace_complete(p_cmd);
+
+    if (p_cmd->requester == NULL || p_cmd->requester->handle == NULL) {
+        return;
+    }
+
+    const uint32_t notification_value =
+        (p_cmd->completion_sequence << COMPLETION_RESULT_BITS) | ((uint32_t)p_cmd->result & COMPLETION_RESULT_MASK);
+
+    // Checked and sent as one step, so the requester can't start its next wait in between
+    taskENTER_CRITICAL();
+    const bool stale = p_cmd->completion_sequence != p_cmd->requester->completion_sequence;
+    if (stale) {
+        dispatcher_stats.stale_completions++;
+    } else {
+        xTaskNotify(p_cmd->requester->handle, notification_value, eSetValueWithOverwrite);
+    }
+    taskEXIT_CRITICAL();
+
+    if (stale) {
+        debug("command-dispatcher: Discarded late result of operation %d for %s task\n", p_cmd->operation, p_cmd->requester->name);
+    }
+}
+
+/**
+ * \fn reject_forwarded_command
+ *
+ * \brief Audits a command that could not be forwarded and fails it back to its requester
+ *
+ * \param p_cmd a pointer to the rejected command
+ * \param status why it was rejected
+ *
+ * \return status_t, `status`
+ */
+static status_t reject_forwarded_command(command_t *const p_cmd, status_t status) {
+    audit_command(p_cmd, status);
+    p_cmd->result = status;
+    complete_command(p_cmd);
+    return status;
+}
+
+/**
+ * \fn forward_to_lane
+ *
+ * \brief Audits and copies a command onto its target's lane, unless the target is missing or disabled
+ *
+ * \param p_cmd a pointer to the command struct to be dispatched
+ * \param context where the command is sent from (see `send_to_lane()`)
+ *
+ * \return status_t, see `dispatch_command()`
  */
-void enqueue_command(command_t *const p_cmd) {
-    if (xQueueSendToBack(p_command_dispatcher_task->command_queue, p_cmd, 0) != pdTRUE) {
-        fatal("%s task failed to enqueue command onto Command Dispatcher queue!\n", get_current_task()->name);
+static status_t forward_to_lane(command_t *const p_cmd, send_context_t context) {
+    if (p_cmd->target == NULL) {
+        return reject_forwarded_command(p_cmd, ERROR_BAD_TARGET);
     }
+
+    // Check if the task to dispatch to was disabled
+    if (!p_cmd->target->enabled) {
+        return reject_forwarded_command(p_cmd, ERROR_TASK_DISABLED);
+    }
+
+    const status_t status = send_to_lane(p_cmd->target, p_cmd, context);
+    audit_command(p_cmd, status);
+    if (status == SUCCESS) {
+        command_trace_dispatch(p_cmd);
+    } else {
+        p_cmd->result = status;
+        complete_command(p_cmd);
+    }
+
+    return status;
+}
+
+/**
+ * \fn forward_command
+ *
+ * \brief Validates a command against the routing table, then audits and forwards it to the appropriate task and lane
+ *        for execution. Commands taken off the Command Dispatcher queue were checked by `submit_command()`, but
+ *        `dispatch_command()` can also be called directly, so they are checked again here.
+ *
+ * \param p_cmd a pointer to the command struct to be dispatched
+ * \param context where the command is sent from (see `send_to_lane()`)
+ *
+ * \return status_t, see `dispatch_command()`
+ */
+static status_t forward_command(command_t *const p_cmd, send_context_t context) {
+    const status_t validity = validate_command(p_cmd);
+    if (validity != SUCCESS) {
+        return reject_forwarded_command(p_cmd, validity);
+    }
+
+    return forward_to_lane(p_cmd, context);
 }
 
 /**
  * \fn dispatch_command
  *
- * \brief Forward a dequeued command to the appropriate task for execution
+ * \brief Forward a command to the appropriate task and lane for execution. Called by the Command Dispatcher task
+ *        for every dequeued command, or directly by `enqueue_command()` in `DISPATCH_MODE_DIRECT`.
  *
  * \param p_cmd a pointer to the command struct to be dispatched
  *
  * \return status_t, whether the forwarding was successful or not
  *
  * \warning produces `ERROR_BAD_TARGET` if target null
+ * \warning produces `ERROR_INVALID_COMMAND` if the target has no route for the operation or the data type is wrong
  * \warning produces `ERROR_TASK_DISABLED` if target disabled
- * \warning `fatal` error if command cannot be forwarded to queue
+ * \warning produces `ERROR_QUEUE_FULL` if the target's lane is full and the overflow policy dropped the command
  */
 status_t dispatch_command(command_t *const p_cmd) {
-    // Check if the task is non-NULL
-    // TODO: make this check exhaustive 
-    if (p_cmd->target == NULL) {
-        return ERROR_BAD_TARGET;
-    }
+    return forward_command(p_cmd, SEND_CONTEXT_TASK);
+}
 
-    // Check if the task to dispatch to was disabled
-    if (!p_cmd->target->enabled) {
-        return ERROR_TASK_DISABLED;
-    }
+/**
+ * \fn dispatch_commands
+ *
+ * \brief Batch form of `dispatch_command()`: forwards a burst of commands with the scheduler suspended so that each
+ *        target is woken at most once. Used by the Command Dispatcher task to drain its queue.
+ *
+ * \param p_cmds array of commands to dispatch, in order
+ * \param num_cmds number of commands in `p_cmds`
+ *
+ * \return status_t, `SUCCESS` if every command was forwarded, otherwise the first failure
+ *
+ * \warning must not be called with the scheduler already suspended
+ */
+status_t dispatch_commands(command_t *const p_cmds, size_t num_cmds) {
+    status_t first_failure = SUCCESS;
 
-    if (xQueueSendToBack(p_cmd->target->command_queue, p_cmd, 0) != pdTRUE) {
-        fatal("command-dispatcher: Failed to forward command to %s task\n", p_cmd->target->name);
+    vTaskSuspendAll();
+    for (size_t i = 0; i < num_cmds; i++) {
+        const status_t status = forward_command(&p_cmds[i], SEND_CONTEXT_BATCH);
+        if (status != SUCCESS && first_failure == SUCCESS) {
+            first_failure = status;
+        }
     }
+    xTaskResumeAll();
 
-    debug("command-dispatcher: Forwarded a command to %s task\n", p_cmd->target->name);
+    return first_failure;
+}
 
-    return SUCCESS;
+/**
+ * \fn dispatch_unrouted_command
+ *
+ * \brief Test-only form of `dispatch_command()` that skips the routing table in UNITTEST builds, so that lane tests
+ *        can queue operations no task executes (such as `TEST_OP`, or `OPERATION_POWER_OFF` to fill an urgent lane).
+ *        Every command queued this way must be received back by the test before the scheduler starts, since the
+ *        target would treat it as a fatal error. Other builds validate as `dispatch_command()` does.
+ *
+ * \param p_cmd a pointer to the command struct to be dispatched
+ *
+ * \return status_t, see `dispatch_command()`
+ */
+status_t dispatch_unrouted_command(command_t *const p_cmd) {
+#ifdef UNITTEST
+    return forward_to_lane(p_cmd, SEND_CONTEXT_TASK);
+#else
+    return forward_command(p_cmd, SEND_CONTEXT_TASK);
+#endif
 }
@@ -2,6 +2,7 @@
 #define COMMAND_DISPATCHER_H
 
 // Includes
+#include "command_routing.h"
 #include "globals.h"
 #include "logging.h"
 #include "queue.h"
@@ -9,6 +10,51 @@
 
 // Constants
 #define COMMAND_DISPATCHER_TASK_STACK_SIZE 1024 // Size of the stack in words (multiply by 4 to get bytes)
+#define COMMAND_DISPATCHER_DEFAULT_MODE DISPATCH_MODE_DIRECT // Dispatch mode used from boot (see `dispatch_mode_t`)
+#define COMMAND_DISPATCH_BATCH_MAX 8                         // Most commands the dispatcher drains and forwards as one batch
+
+// A completion is delivered as a task notification whose value packs the requester's sequence number above the result
+#define COMPLETION_RESULT_BITS 8
+#define COMPLETION_RESULT_MASK ((1UL << COMPLETION_RESULT_BITS) - 1)
+#define COMPLETION_SEQUENCE_MASK (UINT32_MAX >> COMPLETION_RESULT_BITS)
+
+#define OVERFLOW_DEFAULT_WAIT_MS 100 // How long bounded-wait operations block a sender when the target lane is full
+
+// What `send_to_lane()` does when a command is sent to a full lane (configured per operation)
+typedef enum {
+    OVERFLOW_POLICY_BOUNDED_WAIT = 0, // Block the sender for up to `wait_ms`, then drop the new command
+    OVERFLOW_POLICY_DROP_OLDEST,      // Discard the oldest command in the lane to make room for the new one
+    OVERFLOW_POLICY_DROP_NEWEST,      // Discard the new command immediately
+    OVERFLOW_POLICY_COALESCE,         // Merge into an identical command that is already queued, otherwise bounded wait
+} overflow_policy_t;
+
+// Overflow behaviour of one operation
+typedef struct {
+    overflow_policy_t policy;
+    uint32_t wait_ms; // Maximum time to block the sender (bounded wait and coalesce only)
+} overflow_policy_config_t;
+
+// How `enqueue_command()` delivers a command to its target task
+typedef enum {
+    DISPATCH_MODE_HUB = 0, // Copy onto the Command Dispatcher queue; the dispatcher task forwards it later
+    DISPATCH_MODE_DIRECT,  // Validate and audit in the caller's context, then copy straight into the target's queue
+} dispatch_mode_t;
+
+// Counters maintained by the dispatcher's audit hook and completion API
+typedef struct {
+    uint32_t commands_forwarded;  // Commands that passed validation and were placed on a target queue
+    uint32_t commands_rejected;   // Commands dropped because of a bad or disabled target, or no route
+    uint32_t commands_completed;  // Results delivered to a task blocked in `enqueue_command_and_wait()`
+    uint32_t completion_timeouts; // Waits in `enqueue_command_and_wait()` that gave up before the result arrived
+    uint32_t stale_completions;   // Results discarded because their requester had already timed out and moved on
+    uint32_t last_completion_us;  // Enqueue-to-result latency of the most recent completed wait
+    uint32_t max_completion_us;   // Longest enqueue-to-result latency seen
+    uint32_t overflow_waits;      // Sends that found the lane full and had to block (bounded wait and coalesce)
+    uint32_t overflow_timeouts;   // Commands dropped because the lane was still full after their bounded wait (if any)
+    uint32_t dropped_oldest;      // Queued commands discarded to make room (drop-oldest)
+    uint32_t dropped_newest;      // New commands discarded because the lane was full (drop-newest)
+    uint32_t coalesced;           // New commands merged into an identical queued command (coalesce)
+} command_dispatcher_stats_t;
 
 // Placed in a struct to ensure that the TCB is placed higher than the stack in memory
 //^ This ensures that stack overflows do not corrupt the TCB (since the stack grows downwards)
@@ -17,6 +63,7 @@ typedef struct {
     StackType_t command_dispatcher_task_stack[COMMAND_DISPATCHER_TASK_STACK_SIZE];
     uint8_t command_dispatcher_command_queue_buffer[COMMAND_QUEUE_MAX_COMMANDS * COMMAND_QUEUE_ITEM_SIZE];
     StaticQueue_t command_dispatcher_task_queue;
+    command_queue_set_memory_t command_dispatcher_queue_set_mem;
     StaticTask_t command_dispatcher_task_tcb;
 } command_dispatcher_task_memory_t;
 
@@ -25,6 +72,20 @@ extern command_dispatcher_task_memory_t command_dispatcher_mem;
 QueueHandle_t init_command_dispatcher(void);
 void main_command_dispatcher(void *pvParameters);
 status_t dispatch_command(command_t *const p_cmd);
-void enqueue_command(command_t *const p_cmd);
+status_t dispatch_commands(command_t *const p_cmds, size_t num_cmds);
+status_t dispatch_unrouted_command(command_t *const p_cmd); // Tests only (see its definition)
+status_t enqueue_command(command_t *const p_cmd);
+status_t enqueue_command_no_wait(command_t *const p_cmd);
+status_t enqueue_commands(const command_t *const p_cmds, size_t num_cmds);
+status_t enqueue_command_and_wait(command_t *const p_cmd, TickType_t timeout_ticks);
+void complete_command(const command_t *const p_cmd);
+command_lane_t get_command_lane(operation_t operation);
+status_t set_overflow_policy(operation_t operation, overflow_policy_t policy, uint32_t wait_ms);
+overflow_policy_config_t get_overflow_policy(operation_t operation);
+void release_pending_command(pvdx_task_t *const p_task, const command_t *const p_cmd);
+void audit_command(const command_t *const p_cmd, status_t status);
+void set_dispatch_mode(dispatch_mode_t mode);
+dispatch_mode_t get_dispatch_mode(void);
+command_dispatcher_stats_t get_command_dispatcher_stats(void);
 
 #endif // COMMAND_DISPATCHER_H
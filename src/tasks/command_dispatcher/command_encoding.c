@@ -0,0 +1,134 @@
+/**
+ * command_encoding.c
+ *
+ * Conversion between `command_t`, the form every task works with, and `packed_command_t`, the 8-byte form that is
+ * copied through command queues. The packed form replaces the target pointer with its task index and keeps the data
+ * pointer as a 32-bit payload. The timing and completion fields of a queued command go into a small pool of
+ * metadata slots, which is freed as soon as the command is unpacked by its receiver. If the pool is exhausted, a
+ * command is sent without metadata: it is still delivered, but it is left out of the lane wait statistics and
+ * the latency histograms.
+ *
+ * The pool is sized from the queue depths (see `COMMAND_META_POOL_SIZE`) rather than for every queue slot at once,
+ * which would cost more than packing saves. Running out only loses timing, except for a command whose requester is
+ * waiting for its result, so `COMMAND_META_RESERVED_SLOTS` slots are kept for those: each task waits on at most one
+ * command at a time, so a waited-on command always gets a slot.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "command_encoding.h"
+
+#include <string.h>
+
+#include "task_list.h"
+
+static command_meta_t command_meta_pool[COMMAND_META_POOL_SIZE];
+static uint64_t command_meta_free_mask = (COMMAND_META_POOL_SIZE == 64) ? UINT64_MAX : ((uint64_t)1 << COMMAND_META_POOL_SIZE) - 1;
+static uint32_t command_meta_free_slots = COMMAND_META_POOL_SIZE; // Number of bits set in `command_meta_free_mask`
+static uint32_t command_meta_exhaustions = 0; // Commands sent without metadata because every slot was in use
+
+/**
+ * \fn pack_command
+ *
+ * \brief Encodes a command into its queue form, moving its metadata into a pool slot
+ *
+ * \param p_cmd Pointer to the command to encode
+ * \param p_packed Pointer to the packed command to fill in
+ *
+ * \returns `bool`, true if the metadata was stored; false if the pool was full (or, for a command nobody waits on, down
+ *          to its reserved slots) and the command carries none
+ *
+ * \note A packed command that is not successfully queued must be passed to `release_command_meta()`
+ */
+bool pack_command(const command_t *const p_cmd, packed_command_t *const p_packed) {
+    p_packed->target_index = p_cmd->target != NULL ? (uint8_t)p_cmd->target->task_index : COMMAND_TARGET_NONE;
+    p_packed->operation = (uint8_t)p_cmd->operation;
+    p_packed->data_type = (uint8_t)p_cmd->data_type;
+    p_packed->payload = (uint32_t)(uintptr_t)p_cmd->data.raw;
+
+    const uint32_t needed_slots = p_cmd->requester != NULL ? 1 : COMMAND_META_RESERVED_SLOTS + 1;
+    taskENTER_CRITICAL();
+    if (command_meta_free_slots < needed_slots) {
+        command_meta_exhaustions++;
+        taskEXIT_CRITICAL();
+        p_packed->meta_slot = COMMAND_META_NONE;
+        return false;
+    }
+    const uint8_t slot = (uint8_t)__builtin_ctzll(command_meta_free_mask);
+    command_meta_free_mask &= ~((uint64_t)1 << slot);
+    command_meta_free_slots--;
+    taskEXIT_CRITICAL();
+
+    command_meta_pool[slot] = (command_meta_t){
+        .requester = p_cmd->requester,
+        .completion_sequence = p_cmd->completion_sequence,
+        .enqueued_cycles = p_cmd->enqueued_cycles,
+        .submitted_cycles = p_cmd->submitted_cycles,
+        .trace_id = p_cmd->trace_id,
+    };
+    p_packed->meta_slot = slot;
+    return true;
+}
+
+/**
+ * \fn release_command_meta
+ *
+ * \brief Frees the metadata slot of a packed command, if it has one
+ *
+ * \param p_packed Pointer to the packed command
+ */
+void release_command_meta(const packed_command_t *const p_packed) {
+    if (p_packed->meta_slot >= COMMAND_META_POOL_SIZE) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    command_meta_free_mask |= (uint64_t)1 << p_packed->meta_slot;
+    command_meta_free_slots++;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * \fn unpack_command
+ *
+ * \brief Decodes a command taken off a queue and frees its metadata slot
+ *
+ * \param p_packed Pointer to the packed command
+ * \param p_cmd Pointer to the command to fill in. Its `result` is reset to `PROCESSING`. A command that carried no
+ *        metadata has `enqueued_cycles` of 0 (untimed) and no requester.
+ */
+void unpack_command(const packed_command_t *const p_packed, command_t *const p_cmd) {
+    command_meta_t meta = {0};
+    if (p_packed->meta_slot < COMMAND_META_POOL_SIZE) {
+        meta = command_meta_pool[p_packed->meta_slot];
+        release_command_meta(p_packed);
+    }
+
+    // `command_t` has const members, so it is built whole and copied out
+    const command_t cmd = {
+        .target = p_packed->target_index < NUM_TASKS ? task_list[p_packed->target_index] : NULL,
+        .data.raw = (const void *)(uintptr_t)p_packed->payload,
+        .data_type = (command_data_type_t)p_packed->data_type,
+        .operation = (operation_t)p_packed->operation,
+        .result = PROCESSING,
+        .enqueued_cycles = meta.enqueued_cycles,
+        .requester = meta.requester,
+        .completion_sequence = meta.completion_sequence,
+        .trace_id = meta.trace_id,
+        .submitted_cycles = meta.submitted_cycles,
+        .dequeued_cycles = 0,
+    };
+    memcpy(p_cmd, &cmd, sizeof(command_t));
+}
+
+/**
+ * \fn get_command_meta_exhaustions
+ *
+ * \brief Returns how many commands were queued without metadata because the pool was full
+ *
+ * \returns `uint32_t`, the number of exhaustions since boot
+ */
+uint32_t get_command_meta_exhaustions(void) {
+    return command_meta_exhaustions;
+}
@@ -0,0 +1,32 @@
+#ifndef COMMAND_ENCODING_H
+#define COMMAND_ENCODING_H
+
+// Includes
+#include "globals.h"
+
+// Constants
+#define COMMAND_TARGET_NONE 0xFF // `packed_command_t.target_index` of a command with a NULL target
+#define COMMAND_META_NONE 0xFF   // `packed_command_t.meta_slot` of a command that carries no metadata
+
+// Metadata that follows a queued command through the side pool instead of the queue itself
+typedef struct {
+    pvdx_task_t *requester;       // See `command_t.requester`
+    uint32_t completion_sequence; // See `command_t.completion_sequence`
+    uint32_t enqueued_cycles;     // See `command_t.enqueued_cycles`
+    uint32_t submitted_cycles;    // See `command_t.submitted_cycles`
+    uint16_t trace_id;            // See `command_t.trace_id`
+} command_meta_t;
+
+_Static_assert(COMMAND_META_POOL_SIZE <= 64, "the metadata pool free list is a 64-bit mask");
+_Static_assert(COMMAND_META_POOL_SIZE - COMMAND_META_RESERVED_SLOTS >= COMMAND_QUEUE_MAX_COMMANDS + COMMAND_QUEUE_URGENT_MAX_COMMANDS,
+               "every command in one task's full lanes must be able to carry metadata");
+_Static_assert(COMMAND_META_POOL_SIZE < COMMAND_META_NONE, "metadata slots must fit in packed_command_t.meta_slot");
+_Static_assert(NUM_TASKS < COMMAND_TARGET_NONE && NUM_OPERATIONS <= UINT8_MAX && NUM_CMD_DATA_TYPES <= UINT8_MAX,
+               "task indices, operations and data types must fit in one byte each");
+
+bool pack_command(const command_t *const p_cmd, packed_command_t *const p_packed);
+void unpack_command(const packed_command_t *const p_packed, command_t *const p_cmd);
+void release_command_meta(const packed_command_t *const p_packed);
+uint32_t get_command_meta_exhaustions(void);
+
+#endif // COMMAND_ENCODING_H
@@ -0,0 +1,145 @@
+/**
+ * command_routing.c
+ *
+ * Static routing table mapping every (target task, operation) pair that PVDXos accepts to the handler that executes
+ * it and the data type it must carry. Commands are validated against this table when they are enqueued, and each
+ * task executes the commands it receives with a single indexed call through `exec_command()`.
+ *
+ * To add an operation to a task, write an `exec_command_<task>_<operation>()` handler in the task's helper file and
+ * add one `ROUTE()` line to `COMMAND_ROUTES` in command_routing.h. Each route is checked at compile time: out-of-range indices fail a
+ * static assert, a handler with the wrong signature fails to type-check, and a duplicate route is a
+ * -Woverride-init error.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "command_routing.h"
+
+#include "adcs_task.h"
+#include "display_task.h"
+#include "logging.h"
+#include "task_manager_task.h"
+#include "watchdog_task.h"
+
+#define CHECK_ROUTE(task, operation, type, handler_fn)                                                                                     \
+    _Static_assert((task) < NUM_TASKS, #handler_fn ": target task index out of range");                                                    \
+    _Static_assert((operation) < NUM_OPERATIONS, #handler_fn ": operation out of range");                                                  \
+    _Static_assert((type) < NUM_CMD_DATA_TYPES, #handler_fn ": data type out of range");
+COMMAND_ROUTES(CHECK_ROUTE)
+#undef CHECK_ROUTE
+
+#define DEFINE_ROUTE(task, operation, type, handler_fn)                                                                                    \
+    [task][operation] = {.handler = handler_fn, .data_type = type, .index = COMMAND_ROUTE_##handler_fn},
+static const command_route_t command_routes[NUM_TASKS][NUM_OPERATIONS] = {COMMAND_ROUTES(DEFINE_ROUTE)};
+#undef DEFINE_ROUTE
+
+// The (target task, operation) pair of each route, indexed by route number
+typedef struct {
+    uint8_t task_index;
+    uint8_t operation;
+} command_route_key_t;
+
+#define DEFINE_ROUTE_KEY(task, op, type, handler_fn) [COMMAND_ROUTE_##handler_fn] = {.task_index = task, .operation = op},
+static const command_route_key_t command_route_keys[NUM_COMMAND_ROUTES] = {COMMAND_ROUTES(DEFINE_ROUTE_KEY)};
+#undef DEFINE_ROUTE_KEY
+
+/**
+ * \fn get_command_route
+ *
+ * \brief Looks up how a target task executes an operation
+ *
+ * \param p_target Pointer to the target task
+ * \param operation The operation to look up
+ *
+ * \returns `const command_route_t *`, the route, or NULL if the target does not accept the operation
+ */
+const command_route_t *get_command_route(const pvdx_task_t *const p_target, operation_t operation) {
+    if (p_target == NULL || p_target->task_index >= NUM_TASKS || operation >= NUM_OPERATIONS) {
+        return NULL;
+    }
+
+    const command_route_t *const p_route = &command_routes[p_target->task_index][operation];
+    return p_route->handler != NULL ? p_route : NULL;
+}
+
+/**
+ * \fn get_command_route_index
+ *
+ * \brief Looks up the route number of a (target task, operation) pair
+ *
+ * \param task_index Index of the target task in `task_list`
+ * \param operation The operation to look up
+ *
+ * \returns `size_t`, the route number, or `NUM_COMMAND_ROUTES` if the target does not accept the operation
+ */
+size_t get_command_route_index(size_t task_index, operation_t operation) {
+    if (task_index >= NUM_TASKS || operation >= NUM_OPERATIONS || command_routes[task_index][operation].handler == NULL) {
+        return NUM_COMMAND_ROUTES;
+    }
+    return command_routes[task_index][operation].index;
+}
+
+/**
+ * \fn get_command_route_key
+ *
+ * \brief Looks up the (target task, operation) pair that a route number stands for
+ *
+ * \param route_index The route number
+ * \param p_task_index Set to the index of the target task in `task_list`
+ * \param p_operation Set to the operation
+ *
+ * \returns `bool`, false if `route_index` is out of range (the outputs are left unchanged)
+ */
+bool get_command_route_key(size_t route_index, size_t *const p_task_index, operation_t *const p_operation) {
+    if (route_index >= NUM_COMMAND_ROUTES) {
+        return false;
+    }
+    *p_task_index = command_route_keys[route_index].task_index;
+    *p_operation = (operation_t)command_route_keys[route_index].operation;
+    return true;
+}
+
+/**
+ * \fn validate_command
+ *
+ * \brief Checks a command against the routing table before it is enqueued
+ *
+ * \param p_cmd Pointer to the command to check
+ *
+ * \returns `status_t`, `SUCCESS` if the target accepts the operation with the command's data type
+ *
+ * \warning produces `ERROR_BAD_TARGET` if the target is NULL
+ * \warning produces `ERROR_INVALID_COMMAND` if the target has no route for the operation or the data type is wrong
+ */
+status_t validate_command(const command_t *const p_cmd) {
+    if (p_cmd->target == NULL) {
+        return ERROR_BAD_TARGET;
+    }
+
+    const command_route_t *const p_route = get_command_route(p_cmd->target, p_cmd->operation);
+    if (p_route == NULL || p_route->data_type != p_cmd->data_type) {
+        return ERROR_INVALID_COMMAND;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * \fn exec_command
+ *
+ * \brief Executes a received command by calling its handler from the routing table
+ *
+ * \param p_cmd Pointer to the received command; its `result` is set by the handler
+ *
+ * \warning fatal error if the command has no route (it should have been rejected by `validate_command()`)
+ */
+void exec_command(command_t *const p_cmd) {
+    const command_route_t *const p_route = get_command_route(p_cmd->target, p_cmd->operation);
+    if (p_route == NULL) {
+        fatal("%s: Invalid operation! operation: %d\n", p_cmd->target ? p_cmd->target->name : "NULL", p_cmd->operation);
+        return;
+    }
+
+    p_route->handler(p_cmd);
+}
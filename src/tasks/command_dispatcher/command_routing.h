@@ -0,0 +1,45 @@
+#ifndef COMMAND_ROUTING_H
+#define COMMAND_ROUTING_H
+
+// Includes
+#include "globals.h"
+
+// ROUTE(target task index, operation, expected data type, handler), one line per (target task, operation) pair that
+// PVDXos accepts (see command_routing.c)
+#define COMMAND_ROUTES(ROUTE)                                                                                                              \
+    ROUTE(TASK_INDEX_WATCHDOG, OPERATION_CHECKIN, CMD_DATA_PVDX_TASK, exec_command_watchdog_checkin)                                       \
+    ROUTE(TASK_INDEX_TASK_MANAGER, OPERATION_INIT_SUBTASKS, CMD_DATA_NONE, exec_command_task_manager_init_subtasks)                        \
+    ROUTE(TASK_INDEX_TASK_MANAGER, OPERATION_ENABLE_SUBTASK, CMD_DATA_PVDX_TASK, exec_command_task_manager_enable_subtask)                 \
+    ROUTE(TASK_INDEX_TASK_MANAGER, OPERATION_DISABLE_SUBTASK, CMD_DATA_PVDX_TASK, exec_command_task_manager_disable_subtask)               \
+    ROUTE(TASK_INDEX_TASK_MANAGER, OPERATION_SET_MODE, CMD_DATA_MODE_PROFILE, exec_command_task_manager_set_mode)                          \
+    ROUTE(TASK_INDEX_ADCS, OPERATION_READ, CMD_DATA_ADCS, exec_command_adcs_read)                                                          \
+    ROUTE(TASK_INDEX_ADCS, OPERATION_PROCESS, CMD_DATA_ADCS, exec_command_adcs_process)                                                    \
+    ROUTE(TASK_INDEX_DISPLAY, OPERATION_DISPLAY_IMAGE, CMD_DATA_DISPLAY, exec_command_display_image)                                       \
+    ROUTE(TASK_INDEX_DISPLAY, OPERATION_CLEAR_IMAGE, CMD_DATA_NONE, exec_command_display_clear)
+
+// Compact route numbers, one per line of `COMMAND_ROUTES` in order, for per-route state that should not be sized
+// [NUM_TASKS][NUM_OPERATIONS]
+#define DEFINE_ROUTE_INDEX(task, operation, type, handler_fn) COMMAND_ROUTE_##handler_fn,
+typedef enum {
+    COMMAND_ROUTES(DEFINE_ROUTE_INDEX)
+    NUM_COMMAND_ROUTES, // Number of routes (must stay last)
+} command_route_index_t;
+#undef DEFINE_ROUTE_INDEX
+
+// Executes one operation on its target task and sets `p_cmd->result`
+typedef void (*command_handler_t)(command_t *const p_cmd);
+
+// How one (target task, operation) pair is executed
+typedef struct {
+    command_handler_t handler;     // NULL if the target does not accept the operation
+    command_data_type_t data_type; // The data type the operation must be sent with
+    command_route_index_t index;   // The route's number
+} command_route_t;
+
+const command_route_t *get_command_route(const pvdx_task_t *const p_target, operation_t operation);
+size_t get_command_route_index(size_t task_index, operation_t operation);
+bool get_command_route_key(size_t route_index, size_t *const p_task_index, operation_t *const p_operation);
+status_t validate_command(const command_t *const p_cmd);
+void exec_command(command_t *const p_cmd);
+
+#endif // COMMAND_ROUTING_H
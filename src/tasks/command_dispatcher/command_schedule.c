@@ -0,0 +1,397 @@
+/**
+ * command_schedule.c
+ *
+ * Central scheduler for periodic commands. Instead of a task loop per periodic request, a pre-built command is
+ * scheduled once with a period and a phase offset and is emitted into the Command Dispatcher on that schedule by a
+ * single FreeRTOS software timer. Commands with the same period but different phases are released on different
+ * ticks, so their work is spread out rather than arriving all at once.
+ *
+ * Entries sit in a timer wheel with one bucket per tick (modulo `COMMAND_SCHEDULE_WHEEL_SLOTS`), so each expiry only
+ * looks at the buckets of the ticks that have passed. The timer is one-shot and is re-armed for the next due entry
+ * every time rather than ticking through empty slots, so it never wakes the core from tickless idle for nothing.
+ *
+ * Releases stay on a fixed grid (`phase + n * period` ticks from tick 0); how late each one is actually emitted is
+ * recorded as drift, and releases that were missed entirely are skipped rather than emitted back-to-back. Commands
+ * are emitted from the timer service task, which must never block, so they are sent with `enqueue_command_no_wait()`.
+ * A task can schedule its commands while it is still disabled: releases due while the target is disabled are counted
+ * but not emitted, so they don't show up as dispatcher errors.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "command_schedule.h"
+
+#include <string.h>
+
+#include "command_dispatcher_task.h"
+#include "logging.h"
+
+// One periodic command (see `schedule_periodic_command()`)
+typedef struct {
+    bool in_use;                    // Whether this entry holds a scheduled command
+    uint8_t next;                   // Next entry in the same wheel bucket (`COMMAND_SCHEDULE_NO_ENTRY` if last)
+    pvdx_task_t *target;            // Target of the emitted command
+    command_data_t data;            // Data of the emitted command
+    command_data_type_t data_type;  // Data type of the emitted command
+    operation_t operation;          // Operation of the emitted command
+    uint32_t period_ticks;          // Release period
+    uint32_t phase_ticks;           // Offset of the releases from tick 0 (less than the period)
+    TickType_t due_ticks;           // Nominal time of the next release
+    command_schedule_stats_t stats; // Release statistics
+} command_schedule_entry_t;
+
+static command_schedule_entry_t schedule_entries[COMMAND_SCHEDULE_MAX_ENTRIES];
+// First entry due on each tick (modulo the wheel size); entries due on the same bucket are chained through `next`
+static uint8_t wheel[COMMAND_SCHEDULE_WHEEL_SLOTS];
+// Tick at which the timer last expired; the buckets after it are the ones still to be looked at
+static TickType_t last_expiry_ticks = 0;
+
+static StaticTimer_t schedule_timer_buffer;
+static TimerHandle_t schedule_timer = NULL;
+
+static void command_schedule_expired(TimerHandle_t timer);
+
+/**
+ * \fn wheel_insert
+ *
+ * \brief Adds an entry to the bucket of its due tick (call from a critical section)
+ *
+ * \param entry index of the entry
+ */
+static void wheel_insert(size_t entry) {
+    uint8_t *const p_head = &wheel[schedule_entries[entry].due_ticks & (COMMAND_SCHEDULE_WHEEL_SLOTS - 1)];
+    schedule_entries[entry].next = *p_head;
+    *p_head = (uint8_t)entry;
+}
+
+/**
+ * \fn wheel_remove
+ *
+ * \brief Removes an entry from the bucket of its due tick (call from a critical section)
+ *
+ * \param entry index of the entry
+ */
+static void wheel_remove(size_t entry) {
+    uint8_t *p_link = &wheel[schedule_entries[entry].due_ticks & (COMMAND_SCHEDULE_WHEEL_SLOTS - 1)];
+    while (*p_link != COMMAND_SCHEDULE_NO_ENTRY) {
+        if (*p_link == entry) {
+            *p_link = schedule_entries[entry].next;
+            return;
+        }
+        p_link = &schedule_entries[*p_link].next;
+    }
+}
+
+/**
+ * \fn next_due_ticks
+ *
+ * \brief Finds the release due soonest (call from a critical section)
+ *
+ * \param p_due_ticks set to the nominal time of that release
+ *
+ * \returns bool true if any command is scheduled
+ */
+static bool next_due_ticks(TickType_t *const p_due_ticks) {
+    bool found = false;
+    for (size_t i = 0; i < COMMAND_SCHEDULE_MAX_ENTRIES; i++) {
+        if (schedule_entries[i].in_use && (!found || (int32_t)(schedule_entries[i].due_ticks - *p_due_ticks) < 0)) {
+            *p_due_ticks = schedule_entries[i].due_ticks;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * \fn rearm_schedule_timer
+ *
+ * \brief Sets the timer to expire at the release due soonest, or leaves it stopped if nothing is scheduled
+ *
+ * \param wait_ticks how long to wait for room in the timer command queue (must be 0 in the timer service task)
+ */
+static void rearm_schedule_timer(TickType_t wait_ticks) {
+    // Until the scheduler starts, the expiry queued by `init_command_schedule()` is still pending and covers everything
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return;
+    }
+
+    TickType_t due_ticks = 0;
+    taskENTER_CRITICAL();
+    const bool any_due = next_due_ticks(&due_ticks);
+    const int32_t delay_ticks = (int32_t)(due_ticks - xTaskGetTickCount());
+    taskEXIT_CRITICAL();
+
+    if (!any_due) {
+        return;
+    }
+    // A release that is already due is handled at the next tick
+    if (xTimerChangePeriod(schedule_timer, delay_ticks > 0 ? (TickType_t)delay_ticks : 1, wait_ticks) != pdPASS) {
+        warning("command-schedule: Timer command queue full, periodic commands are stalled until the next change\n");
+    }
+}
+
+/**
+ * \fn entry_command
+ *
+ * \brief Builds the command an entry emits on every release
+ *
+ * \param entry index of the entry
+ *
+ * \returns `command_t`, a fresh copy of the scheduled command
+ */
+static command_t entry_command(size_t entry) {
+    taskENTER_CRITICAL();
+    const command_t cmd = {
+        .target = schedule_entries[entry].target,
+        .data = schedule_entries[entry].data,
+        .data_type = schedule_entries[entry].data_type,
+        .operation = schedule_entries[entry].operation,
+        .result = PROCESSING,
+    };
+    taskEXIT_CRITICAL();
+    return cmd;
+}
+
+/**
+ * \fn command_schedule_expired
+ *
+ * \brief Timer callback: emits every command whose release is due, moves each to the bucket of its next release and
+ *        re-arms the timer for the release due soonest
+ *
+ * \param timer the schedule timer
+ *
+ * \warning runs in the timer service task and must never block
+ */
+static void command_schedule_expired(TimerHandle_t timer) {
+    size_t due_entries[COMMAND_SCHEDULE_MAX_ENTRIES];
+    uint32_t late_ticks[COMMAND_SCHEDULE_MAX_ENTRIES];
+    size_t num_due = 0;
+
+    taskENTER_CRITICAL();
+    const TickType_t now_ticks = xTaskGetTickCount();
+
+    // Look at the bucket of every tick since the last expiry (every bucket once if a whole turn of the wheel passed)
+    const TickType_t elapsed_ticks = now_ticks - last_expiry_ticks;
+    const TickType_t first_ticks = elapsed_ticks >= COMMAND_SCHEDULE_WHEEL_SLOTS ? now_ticks - (COMMAND_SCHEDULE_WHEEL_SLOTS - 1)
+                                                                                  : last_expiry_ticks + 1;
+    for (TickType_t ticks = first_ticks; ticks != now_ticks + 1; ticks++) {
+        // Entries in the bucket may be due on a later turn of the wheel
+        for (uint8_t i = wheel[ticks & (COMMAND_SCHEDULE_WHEEL_SLOTS - 1)]; i != COMMAND_SCHEDULE_NO_ENTRY; i = schedule_entries[i].next) {
+            if ((int32_t)(schedule_entries[i].due_ticks - now_ticks) <= 0) {
+                due_entries[num_due++] = i;
+            }
+        }
+    }
+    last_expiry_ticks = now_ticks;
+
+    // Keep releases on their grid; any that were missed entirely are skipped
+    for (size_t k = 0; k < num_due; k++) {
+        command_schedule_entry_t *const p_entry = &schedule_entries[due_entries[k]];
+        late_ticks[k] = now_ticks - p_entry->due_ticks;
+        const uint32_t missed = late_ticks[k] / p_entry->period_ticks;
+        p_entry->stats.skipped += missed;
+
+        wheel_remove(due_entries[k]);
+        p_entry->due_ticks += (missed + 1) * p_entry->period_ticks;
+        wheel_insert(due_entries[k]);
+    }
+    taskEXIT_CRITICAL();
+
+    for (size_t k = 0; k < num_due; k++) {
+        command_t cmd = entry_command(due_entries[k]);
+        command_schedule_stats_t *const p_stats = &schedule_entries[due_entries[k]].stats;
+        if (cmd.target == NULL || !cmd.target->enabled) {
+            taskENTER_CRITICAL();
+            p_stats->disabled++;
+            taskEXIT_CRITICAL();
+            continue;
+        }
+        const status_t status = enqueue_command_no_wait(&cmd);
+
+        taskENTER_CRITICAL();
+        p_stats->releases++;
+        if (status != SUCCESS) {
+            p_stats->failures++;
+        }
+        p_stats->last_drift_ms = late_ticks[k] * portTICK_PERIOD_MS;
+        p_stats->total_drift_ms += p_stats->last_drift_ms;
+        if (p_stats->last_drift_ms > p_stats->max_drift_ms) {
+            p_stats->max_drift_ms = p_stats->last_drift_ms;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    rearm_schedule_timer(0);
+}
+
+/**
+ * \fn init_command_schedule
+ *
+ * \brief Creates the schedule timer. Called when the Command Dispatcher is initialised (before the scheduler starts), so
+ *        that tasks initialised after it can schedule their periodic commands.
+ */
+void init_command_schedule(void) {
+    memset(wheel, COMMAND_SCHEDULE_NO_ENTRY, sizeof(wheel));
+    last_expiry_ticks = xTaskGetTickCount();
+
+    schedule_timer = xTimerCreateStatic("CmdSchedule", 1, pdFALSE, NULL, command_schedule_expired, &schedule_timer_buffer);
+    if (schedule_timer == NULL) {
+        fatal("Failed to create command schedule timer!\n");
+    }
+
+    // Expire on the first tick, by when the tasks initialised before the scheduler started have scheduled their commands
+    if (xTimerStart(schedule_timer, 0) != pdPASS) {
+        fatal("Failed to start command schedule timer!\n");
+    }
+}
+
+/**
+ * \fn schedule_periodic_command
+ *
+ * \brief Emits a copy of a command into the Command Dispatcher every `period_ms`, on the ticks that are `phase_ms`
+ *        past a multiple of the period. Scheduling a command that is already scheduled (same target, operation and
+ *        data) changes its period and phase instead of adding it twice, so a task can schedule its commands whenever
+ *        it is initialised.
+ *
+ * \param p_cmd the command to emit; only its target, operation and data are used, and it may not have a requester
+ * \param period_ms release period (at least one tick, at most `COMMAND_SCHEDULE_MAX_PERIOD_MS`)
+ * \param phase_ms offset of the releases within the period (less than `period_ms`)
+ * \param p_entry set to the entry now holding the command, for `cancel_periodic_command()` (may be NULL)
+ *
+ * \returns `status_t`, SUCCESS; ERROR_NOT_READY before `init_command_schedule()`; ERROR_SANITY_CHECK_FAILED for a bad
+ *          period, phase or requester; the reason the command was refused by `validate_command()`; or ERROR_QUEUE_FULL
+ *          if `COMMAND_SCHEDULE_MAX_ENTRIES` commands are already scheduled
+ */
+status_t schedule_periodic_command(const command_t *const p_cmd, uint32_t period_ms, uint32_t phase_ms, size_t *const p_entry) {
+    const uint32_t period_ticks = pdMS_TO_TICKS(period_ms);
+    const uint32_t phase_ticks = pdMS_TO_TICKS(phase_ms);
+    if (schedule_timer == NULL) {
+        return ERROR_NOT_READY;
+    }
+    if (period_ticks == 0 || period_ms > COMMAND_SCHEDULE_MAX_PERIOD_MS || phase_ticks >= period_ticks || p_cmd->requester != NULL) {
+        return ERROR_SANITY_CHECK_FAILED;
+    }
+    const status_t validity = validate_command(p_cmd);
+    if (validity != SUCCESS) {
+        return validity;
+    }
+
+    taskENTER_CRITICAL();
+    size_t entry = COMMAND_SCHEDULE_MAX_ENTRIES;
+    for (size_t i = 0; i < COMMAND_SCHEDULE_MAX_ENTRIES; i++) {
+        const command_schedule_entry_t *const p_existing = &schedule_entries[i];
+        if (p_existing->in_use && p_existing->target == p_cmd->target && p_existing->operation == p_cmd->operation &&
+            p_existing->data.raw == p_cmd->data.raw) {
+            wheel_remove(i);
+            entry = i;
+            break;
+        }
+        if (!p_existing->in_use && entry == COMMAND_SCHEDULE_MAX_ENTRIES) {
+            entry = i;
+        }
+    }
+    if (entry == COMMAND_SCHEDULE_MAX_ENTRIES) {
+        taskEXIT_CRITICAL();
+        return ERROR_QUEUE_FULL;
+    }
+
+    command_schedule_entry_t *const p_new = &schedule_entries[entry];
+    if (!p_new->in_use) {
+        p_new->stats = (command_schedule_stats_t){0};
+    }
+    p_new->in_use = true;
+    p_new->target = p_cmd->target;
+    p_new->data = p_cmd->data;
+    p_new->data_type = p_cmd->data_type;
+    p_new->operation = p_cmd->operation;
+    p_new->period_ticks = period_ticks;
+    p_new->phase_ticks = phase_ticks;
+
+    // The first release is the first point on the grid after now
+    const TickType_t now_ticks = xTaskGetTickCount();
+    if (now_ticks < phase_ticks) {
+        p_new->due_ticks = phase_ticks;
+    } else {
+        p_new->due_ticks = now_ticks + (period_ticks - (now_ticks - phase_ticks) % period_ticks);
+    }
+    wheel_insert(entry);
+    taskEXIT_CRITICAL();
+
+    if (p_entry != NULL) {
+        *p_entry = entry;
+    }
+
+    rearm_schedule_timer(pdMS_TO_TICKS(COMMAND_SCHEDULE_REARM_WAIT_MS));
+    return SUCCESS;
+}
+
+/**
+ * \fn cancel_periodic_command
+ *
+ * \brief Stops emitting a scheduled command
+ *
+ * \param entry the entry holding the command (see `schedule_periodic_command()`)
+ *
+ * \returns `status_t`, SUCCESS, or ERROR_SANITY_CHECK_FAILED if the entry holds no command
+ */
+status_t cancel_periodic_command(size_t entry) {
+    if (entry >= COMMAND_SCHEDULE_MAX_ENTRIES) {
+        return ERROR_SANITY_CHECK_FAILED;
+    }
+
+    taskENTER_CRITICAL();
+    const bool was_in_use = schedule_entries[entry].in_use;
+    if (was_in_use) {
+        wheel_remove(entry);
+        schedule_entries[entry].in_use = false;
+    }
+    taskEXIT_CRITICAL();
+
+    // The timer may still expire for the cancelled entry; it then finds nothing due and re-arms for the rest
+    return was_in_use ? SUCCESS : ERROR_SANITY_CHECK_FAILED;
+}
+
+/**
+ * \fn get_command_schedule_entry
+ *
+ * \brief Copies one scheduled command and its release statistics
+ *
+ * \param entry index of the entry (0 to `COMMAND_SCHEDULE_MAX_ENTRIES` - 1)
+ * \param p_info where to copy the entry
+ *
+ * \returns bool true if the entry holds a scheduled command (`p_info` is only written if so)
+ */
+bool get_command_schedule_entry(size_t entry, command_schedule_info_t *const p_info) {
+    if (entry >= COMMAND_SCHEDULE_MAX_ENTRIES) {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    const command_schedule_entry_t *const p_entry = &schedule_entries[entry];
+    const bool in_use = p_entry->in_use;
+    if (in_use) {
+        const int32_t until_due_ticks = (int32_t)(p_entry->due_ticks - xTaskGetTickCount());
+        p_info->target = p_entry->target;
+        p_info->operation = p_entry->operation;
+        p_info->period_ms = p_entry->period_ticks * portTICK_PERIOD_MS;
+        p_info->phase_ms = p_entry->phase_ticks * portTICK_PERIOD_MS;
+        p_info->next_release_ms = until_due_ticks > 0 ? (uint32_t)until_due_ticks * portTICK_PERIOD_MS : 0;
+        p_info->stats = p_entry->stats;
+    }
+    taskEXIT_CRITICAL();
+    return in_use;
+}
+
+/**
+ * \fn reset_command_schedule_stats
+ *
+ * \brief Clears the release statistics of every scheduled command (the schedule itself is kept)
+ */
+void reset_command_schedule_stats(void) {
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < COMMAND_SCHEDULE_MAX_ENTRIES; i++) {
+        schedule_entries[i].stats = (command_schedule_stats_t){0};
+    }
+    taskEXIT_CRITICAL();
+}
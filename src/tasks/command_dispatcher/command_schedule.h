@@ -0,0 +1,45 @@
+#ifndef COMMAND_SCHEDULE_H
+#define COMMAND_SCHEDULE_H
+
+// Includes
+#include "globals.h"
+#include "timers.h"
+
+// Constants
+#define COMMAND_SCHEDULE_MAX_ENTRIES 8          // Most periodic commands that can be scheduled at once
+#define COMMAND_SCHEDULE_WHEEL_SLOTS 64         // Buckets in the timer wheel, one per tick (must be a power of two)
+#define COMMAND_SCHEDULE_MAX_PERIOD_MS 86400000 // Longest period (one day, well inside the range of tick differences)
+#define COMMAND_SCHEDULE_REARM_WAIT_MS 10       // How long a task scheduling a command waits for room in the timer queue
+#define COMMAND_SCHEDULE_NO_ENTRY UINT8_MAX     // Ends a wheel bucket's list of entries
+
+_Static_assert((COMMAND_SCHEDULE_WHEEL_SLOTS & (COMMAND_SCHEDULE_WHEEL_SLOTS - 1)) == 0, "wheel slots must be a power of two");
+_Static_assert(COMMAND_SCHEDULE_MAX_ENTRIES < COMMAND_SCHEDULE_NO_ENTRY, "entry indices must fit in a bucket link");
+
+// Release statistics of one scheduled command
+typedef struct {
+    uint32_t releases;       // Times the command was emitted
+    uint32_t failures;       // Emissions the dispatcher rejected or dropped (e.g. lane full)
+    uint32_t skipped;        // Releases missed entirely because the timer service ran more than a period late
+    uint32_t disabled;       // Releases not emitted because the target task was disabled
+    uint32_t last_drift_ms;  // How late the latest release was emitted, relative to its nominal time
+    uint32_t max_drift_ms;   // Latest any release was emitted
+    uint32_t total_drift_ms; // Lateness of every release added up (for the mean)
+} command_schedule_stats_t;
+
+// A copy of one scheduled command, as reported by `get_command_schedule_entry()`
+typedef struct {
+    pvdx_task_t *target;            // Target of the command
+    operation_t operation;          // Operation of the command
+    uint32_t period_ms;             // Release period
+    uint32_t phase_ms;              // Offset of the releases from the schedule's epoch
+    uint32_t next_release_ms;       // Time until the next release
+    command_schedule_stats_t stats; // Release statistics
+} command_schedule_info_t;
+
+void init_command_schedule(void);
+status_t schedule_periodic_command(const command_t *const p_cmd, uint32_t period_ms, uint32_t phase_ms, size_t *const p_entry);
+status_t cancel_periodic_command(size_t entry);
+bool get_command_schedule_entry(size_t entry, command_schedule_info_t *const p_info);
+void reset_command_schedule_stats(void);
+
+#endif // COMMAND_SCHEDULE_H
@@ -26,10 +26,6 @@ void main_display(void *pvParameters) {
 
     // Obtain a pointer to the current task within the global task list
     pvdx_task_t *const current_task = get_current_task();
-    // Cache the watchdog checkin command to avoid creating it every iteration
-    command_t cmd_checkin = get_watchdog_checkin_command(current_task);
-    // Calculate the maximum time the command dispatcher should block (and thus be unable to check in with the watchdog)
-    const TickType_t queue_block_time_ticks = get_command_queue_block_time_ticks(current_task);
     // Varible to hold commands popped off the queue
     command_t cmd;
 
@@ -41,44 +37,39 @@ void main_display(void *pvParameters) {
     while (true) {
         debug("\n---------- Display Task Loop ----------\n");
 
-        (void)queue_block_time_ticks;
-        // Execute all commands contained in the queue
+        // Calculate the maximum time this task should block (and thus be unable to check in with the watchdog); a mode
+        // change can change the watchdog timeout, so this is recalculated on every pass
+        const TickType_t queue_block_time_ticks = get_command_queue_block_time_ticks(current_task);
+        // Execute all commands contained in the queue (urgent lane first)
 
-        if (xQueueReceive(p_display_task->command_queue, &cmd, queue_block_time_ticks) == pdPASS) {
+        if (receive_command(current_task, &cmd, queue_block_time_ticks)) {
             do {
                 debug("display: Command popped off queue. Target: %d, Operation: %d\n", cmd.target, cmd.operation);
-                exec_command_display(&cmd);
-            } while (xQueueReceive(p_display_task->command_queue, &cmd, 0) == pdPASS);
+                exec_command(&cmd);
+                complete_command(&cmd);
+            } while (receive_command(current_task, &cmd, 0));
         }
         debug("display: No more commands queued.\n");
 
-        // TODO: is this a correct modification?
-        // Set the display buffer to the first image
-
-        {
-            // TODO: Add logic for blocking on the result of the display_image command
-            command_t display_image_command = get_display_image_command(IMAGE_BUFFER_PVDX);
-            enqueue_command(&display_image_command);
+        // The display task owns the display, so it draws the default images directly instead of sending itself
+        // commands (it could never wait on their results, since it is the task that would execute them)
 
-            if (display_image_command.result != SUCCESS) {
-                warning("display: Failed to display image. Error code: %d\n", display_image_command.result);
-            }
+        // Set the display buffer to the first image
+        status = display_image(IMAGE_BUFFER_PVDX);
+        if (status != SUCCESS) {
+            warning("display: Failed to display image. Error code: %d\n", status);
         }
-        {
-            // Set the display buffer to the second image
-            // TODO: Add logic for blocking on the result of the display_image command
-            command_t display_image_command = get_display_image_command(IMAGE_BUFFER_BROWNLOGO);
-            enqueue_command(&display_image_command);
 
-            if (display_image_command.result != SUCCESS) {
-                warning("display: Failed to display image. Error code: %d\n", display_image_command.result);
-            }
+        // Set the display buffer to the second image
+        status = display_image(IMAGE_BUFFER_BROWNLOGO);
+        if (status != SUCCESS) {
+            warning("display: Failed to display image. Error code: %d\n", status);
         }
 
         // Check in with the watchdog task
         if (should_checkin(current_task)) {
-            enqueue_command(&cmd_checkin);
-            debug("display: Enqueued watchdog checkin command\n");
+            checkin_with_watchdog(current_task);
+            debug("display: Checked in with watchdog\n");
         }
     }
 }
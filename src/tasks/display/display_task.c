@@ -74,29 +74,25 @@ inline command_t get_display_image_command(const color_t *const p_buffer) {
 }
 
 /**
- * \fn exec_command_display
+ * \fn exec_command_display_image
  *
- * \brief Calls the correct function for the command
- *
- * \param p_cmd the pointer to the cmd we want to execute
+ * \brief Executes an `OPERATION_DISPLAY_IMAGE` command (routed by `exec_command()`)
  *
+ * \param p_cmd the pointer to the cmd we want to execute, whose `data.display_data` is the image buffer
  */
-void exec_command_display(command_t *const p_cmd) {
-    if (p_cmd->target != p_display_task) {
-        fatal("display: command target is not display! target: %s operation: %d\n", p_cmd->target->name, p_cmd->operation);
-    }
+void exec_command_display_image(command_t *const p_cmd) {
+    p_cmd->result = display_image((const color_t *)p_cmd->data.display_data);
+}
 
-    switch (p_cmd->operation) {
-        case OPERATION_DISPLAY_IMAGE:
-            p_cmd->result = display_image((const color_t *)p_cmd->data.display_data);
-            break;
-        case OPERATION_CLEAR_IMAGE:
-            p_cmd->result = clear_image();
-            break;
-        default:
-            fatal("display: Invalid operation! target: %d operation: %d\n", p_cmd->target, p_cmd->operation);
-            break;
-    }
+/**
+ * \fn exec_command_display_clear
+ *
+ * \brief Executes an `OPERATION_CLEAR_IMAGE` command (routed by `exec_command()`)
+ *
+ * \param p_cmd the pointer to the cmd we want to execute
+ */
+void exec_command_display_clear(command_t *const p_cmd) {
+    p_cmd->result = clear_image();
 }
 
 /**
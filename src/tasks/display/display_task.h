@@ -20,6 +20,7 @@ typedef struct {
     StackType_t display_task_stack[DISPLAY_TASK_STACK_SIZE];
     uint8_t display_command_queue_buffer[COMMAND_QUEUE_MAX_COMMANDS * COMMAND_QUEUE_ITEM_SIZE];
     StaticQueue_t display_task_queue;
+    command_queue_set_memory_t display_queue_set_mem;
     StaticTask_t display_task_tcb;
 } display_task_memory_t;
 
@@ -33,6 +34,7 @@ status_t display_update(void);
 void display_set_buffer(const color_t *const p_buffer);
 void display_clear_buffer(void);
 command_t get_display_image_command(const color_t *const p_buffer);
-void exec_command_display(command_t *const p_cmd);
+void exec_command_display_image(command_t *const p_cmd);
+void exec_command_display_clear(command_t *const p_cmd);
 
 #endif // DISPLAY_TASK_H
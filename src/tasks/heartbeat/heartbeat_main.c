@@ -27,8 +27,6 @@ void main_heartbeat(void *pvParameters)
 
     // Obtain a pointer to the current task within the global task list
     pvdx_task_t *const current_task = get_current_task()                                             ;
-    // Cache the watchdog checkin command to avoid creating it every iteration
-    command_t cmd_checkin = get_watchdog_checkin_command(current_task)                               ;
 
 // NOTE: false is on for some reason on the orange LEDs
 // In release build, make sure orange LEDs are off
@@ -81,5 +79,5 @@ void main_heartbeat(void *pvParameters)
 
         // Check in with the watchdog task
         if (should_checkin(current_task))                                                            {
-            enqueue_command(&cmd_checkin)                                                            ;
-            debug("heartbeat: Enqueued watchdog checkin command\n")                                  ;}}}
+            checkin_with_watchdog(current_task)                                                      ;
+            debug("heartbeat: Checked in with watchdog\n")                                           ;}}}
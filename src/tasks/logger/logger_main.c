@@ -0,0 +1,50 @@
+/**
+ * logger_main.c
+ *
+ * Main loop of the Logger task, which writes out the messages that other tasks and interrupts have left in the log
+ * ring (see log_ring.c). It runs at the lowest task priority, so formatting text and copying it into the RTT buffer
+ * only ever uses time that no other task wanted. It is a service task rather than an OS task: if it ever stops
+ * checking in, the watchdog has the task manager restart it, so logging can never be the reason the satellite resets.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "tasks/logger/logger_task.h"
+
+#include "logging.h"
+
+logger_task_memory_t logger_mem;
+
+/**
+ * \fn main_logger
+ *
+ * \param pvParameters a void pointer to the parametres required by the
+ *      logger task; not currently set by config
+ *
+ * \warning should never return
+ */
+void main_logger(void *pvParameters) {
+    // Obtain a pointer to the current task within the global task list
+    pvdx_task_t *const current_task = get_current_task();
+
+    // From here on, logging calls leave their messages in the ring and notify this task when it was empty
+    start_deferred_logging(xTaskGetCurrentTaskHandle());
+    info("logger: Task Started!\n");
+
+    while (true) {
+        // Each pass writes at most one ring's worth, so a flood of messages can't keep the Logger from checking in
+        const size_t written = drain_log_ring();
+
+        // Check in with the watchdog task
+        if (should_checkin(current_task)) {
+            checkin_with_watchdog(current_task);
+        }
+
+        // Sleep until a message arrives in an empty ring, or until it is time to check in again. After a full pass more
+        // messages may be waiting, so go straight round again.
+        if (written < LOG_RING_CAPACITY) {
+            ulTaskNotifyTake(pdTRUE, get_command_queue_block_time_ticks(current_task));
+        }
+    }
+}
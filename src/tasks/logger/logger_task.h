@@ -0,0 +1,26 @@
+#ifndef LOGGER_TASK_H
+#define LOGGER_TASK_H
+
+// Includes
+#include <atmel_start.h>
+#include <driver_init.h>
+
+#include "globals.h"
+#include "tasks/watchdog/watchdog_task.h"
+
+// Memory for the logger task
+#define LOGGER_TASK_STACK_SIZE 512 // Size of the stack in words (multiply by 4 to get bytes)
+
+// Placed in a struct to ensure that the TCB is placed higher than the stack in memory
+//^ This ensures that stack overflows do not corrupt the TCB (since the stack grows downwards)
+typedef struct {
+    StackType_t overflow_buffer[TASK_STACK_OVERFLOW_PADDING];
+    StackType_t logger_task_stack[LOGGER_TASK_STACK_SIZE];
+    StaticTask_t logger_task_tcb;
+} logger_task_memory_t;
+
+extern logger_task_memory_t logger_mem;
+
+void main_logger(void *pvParameters);
+
+#endif // LOGGER_TASK_H
@@ -12,11 +12,22 @@
 #include <atmel_start.h>
 
 #include "command_dispatcher_task.h"
+#include "command_schedule.h"
+#include "command_trace.h"
+#include "crash_log.h"
+#include "cycle_counter.h"
 #include "display_task.h"
 #include "image_buffers/image_buffer_BrownLogo.h"
 #include "image_buffers/image_buffer_PVDX.h"
+#include "log_compress.h"
 #include "logging.h"
+#include "run_time_stats.h"
 #include "shell_helpers.h"
+#include "stack_usage.h"
+#include "task_list.h"
+#include "task_manager_task.h"
+#include "task_period.h"
+#include "tickless_idle.h"
 #include "watchdog_task.h"
 shell_command_t shell_commands[] = {
     {"help", shell_help, help_help},
@@ -25,6 +36,17 @@ shell_command_t shell_commands[] = {
     {"loglevel", shell_loglevel, help_loglevel},
     {"reboot", shell_reboot, help_reboot},
     {"display", shell_display, help_display},
+    {"lanes", shell_lanes, help_lanes},
+    {"trace", shell_trace, help_trace},
+    {"checkin", shell_checkin, help_checkin},
+    {"margins", shell_margins, help_margins},
+    {"mode", shell_mode, help_mode},
+    {"top", shell_top, help_top},
+    {"stacks", shell_stacks, help_stacks},
+    {"periods", shell_periods, help_periods},
+    {"idle", shell_idle, help_idle},
+    {"schedule", shell_schedule, help_schedule},
+    {"crashlog", shell_crashlog, help_crashlog},
     {NULL, NULL, NULL} // Null-terminated array
 };
 
@@ -46,8 +68,13 @@ void shell_help(char **args, int arg_count) {
         terminal_printf("help - Display this help message\n");
         terminal_printf("echo <message> - Echo the message back to the terminal\n");
         terminal_printf("clear - Clear the terminal screen\n");
-        terminal_printf("loglevel <level 0-3> - Set the log level for PVDX terminal output\n");
+        terminal_printf("loglevel [module] <level 0-3> - Set the log level for PVDX terminal output, for all modules or one\n");
         terminal_printf("reboot - Reboot the satellite\n");
+        terminal_printf("lanes - Display head-of-line wait statistics for each task's command lanes\n");
+        terminal_printf("trace [ring|dump|reset] - Display command latency histograms and queue high-water marks\n");
+        terminal_printf("checkin [direct|command] - Display or set how tasks check in with the watchdog\n");
+        terminal_printf("margins [dump|reset] - Display each task's check-in intervals and watchdog timeout margin\n");
+        terminal_printf("crashlog [dump|zip] - Display the fatal errors and warnings kept through the last reset\n");
     } else if (arg_count == 2) {
         for (shell_command_t *shell_command = shell_commands; shell_command->command_name != NULL; shell_command++) {
             if (strcmp(args[1], shell_command->command_name) == 0) {
@@ -159,18 +186,46 @@ char *log_level_string_mappings[] = {"DEBUG", "INFO", "EVENT", "WARNING"};
  *
  */
 void shell_loglevel(char **args, int arg_count) {
+    size_t module_count = 0;
+    const log_module_t *const p_modules = get_log_modules(&module_count);
     if (arg_count == 1) {
         terminal_printf("Current log level: %s(%d)\n", log_level_string_mappings[get_log_level()], get_log_level());
-    } else if (arg_count == 2) {
-        int level = args[1][0]; // Just read the first character
-        level = level - '0';    // Convert the character to an integer
+        for (size_t i = 0; i < module_count; i++) {
+            if (p_modules[i].level != get_log_level()) {
+                terminal_printf("\t%s: %s(%d)\n", p_modules[i].name, log_level_string_mappings[p_modules[i].level], p_modules[i].level);
+            }
+        }
+#if defined(TOKENIZED_LOGS)
+        log_token_stats_t stats;
+        get_log_token_stats(&stats);
+        terminal_printf("Tokenized records: %u sent (%u bytes), %u dropped, %u truncated\n", stats.records,
+                        (uint32_t)stats.bytes_written, stats.dropped, stats.truncated);
+#endif
+        log_ring_stats_t ring_stats;
+        get_log_ring_totals(&ring_stats);
+        terminal_printf("Log ring: %u queued, %u dropped (ring full), %u truncated, max depth %u of %d\n", ring_stats.pushed,
+                        ring_stats.dropped, ring_stats.truncated, ring_stats.max_depth, LOG_RING_CAPACITY);
+    } else if (arg_count == 2 && strcmp(args[1], "modules") == 0) {
+        for (size_t i = 0; i < module_count; i++) {
+            terminal_printf("%s: %s(%d)\n", p_modules[i].name, log_level_string_mappings[p_modules[i].level], p_modules[i].level);
+        }
+    } else if (arg_count == 2 || arg_count == 3) {
+        int level = args[arg_count - 1][0]; // Just read the first character
+        level = level - '0';                // Convert the character to an integer
         if (level < 0 || level > 3) {
             terminal_printf("Invalid log level. Must be between 0 and 3\n");
-        } else {
+        } else if (arg_count == 2) {
             log_level_t log_level = (log_level_t)level;
             set_log_level(log_level);
             info("Log level set to %s(%d)\n", log_level_string_mappings[log_level], log_level);
             terminal_printf("Log level set to %s(%d)\n", log_level_string_mappings[log_level], log_level);
+        } else {
+            log_level_t log_level = (log_level_t)level;
+            if (set_module_log_level(args[1], log_level) == 0) {
+                terminal_printf("loglevel: No module named '%s'. Try 'loglevel modules'\n", args[1]);
+            } else {
+                terminal_printf("Log level of %s set to %s(%d)\n", args[1], log_level_string_mappings[log_level], log_level);
+            }
         }
     } else {
         terminal_printf("loglevel: Invalid usage. Try 'help loglevel'\n");
@@ -185,13 +240,18 @@ void shell_loglevel(char **args, int arg_count) {
  */
 void help_loglevel() {
     terminal_printf("Usage: loglevel\n");
-    terminal_printf("\tDisplays the current log level\n");
+    terminal_printf("\tDisplays the current log level, and the modules set to a different one\n");
+    terminal_printf("Usage: loglevel modules\n");
+    terminal_printf("\tDisplays the log level of every module (source file)\n");
     terminal_printf("Usage: loglevel <level>\n");
     terminal_printf("\tSets the log level for PVDX terminal output\n");
     terminal_printf("\t[0] (debug level) ====> Very detailed info about the internals of every process\n");
     terminal_printf("\t[1] (info level)  ====> Every meaningful interaction with the satellite is displayed [DEFAULT]\n");
     terminal_printf("\t[2] (event level) ====> Significant events and interactions displayed\n");
     terminal_printf("\t[3] (warning level) ==> Only errors and critical events are displayed\n");
+    terminal_printf("Usage: loglevel <module> <level>\n");
+    terminal_printf("\tSets the log level of one module only, e.g. 'loglevel adcs_main 0'\n");
+    terminal_printf("\tMessages below the module's compile-time floor (LOG_MODULE_FLOOR) can't be turned back on\n");
 }
 
 /* ---------- REBOOT COMMAND ---------- */
@@ -248,8 +308,12 @@ void shell_display(char **args, int arg_count) {
 
     const uint8_t *image_buffers[] = {IMAGE_BUFFER_BROWNLOGO, IMAGE_BUFFER_PVDX};
     command_t display_image_command = get_display_image_command(image_buffers[args[1][0] - '0']);
-    enqueue_command(&display_image_command);
-    terminal_printf("fr\n");
+    status_t result = enqueue_command_and_wait(&display_image_command, pdMS_TO_TICKS(SHELL_COMMAND_TIMEOUT_MS));
+    if (result == SUCCESS) {
+        terminal_printf("Image displayed\n");
+    } else {
+        terminal_printf("display: Failed to display image (status %d)\n", result);
+    }
 }
 
 /**
@@ -262,3 +326,610 @@ void help_display() {
     terminal_printf("Usage: display\n");
     terminal_printf("\tgjnerergjkn\n");
 }
+
+/* ---------- LANES COMMAND ---------- */
+
+/**
+ * \fn shell_lanes
+ *
+ * \brief Displays the head-of-line wait statistics of the urgent and normal command lanes of every task
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_lanes(char **args, int arg_count) {
+    if (arg_count != 1) {
+        terminal_printf("Invalid usage. Try 'help lanes'\n");
+        return;
+    }
+
+    const char *const lane_names[NUM_COMMAND_LANES] = {"urgent", "normal"};
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        if (task_list[i]->command_queue == NULL) {
+            continue;
+        }
+        for (size_t lane = 0; lane < NUM_COMMAND_LANES; lane++) {
+            const command_lane_stats_t stats = task_list[i]->lane_stats[lane];
+            const uint32_t mean_wait_us = stats.commands_received ? (uint32_t)(stats.total_wait_us / stats.commands_received) : 0;
+            terminal_printf("%s %s lane: %u commands (%u out of order), wait last %u us, mean %u us, max %u us, %u empty wakeups\n",
+                            task_list[i]->name, lane_names[lane], stats.commands_received, stats.out_of_order, stats.last_wait_us,
+                            mean_wait_us, stats.max_wait_us, stats.empty_wakeups);
+        }
+    }
+}
+
+/**
+ * \fn help_lanes
+ *
+ * \brief helper for shell_lanes
+ *
+ */
+void help_lanes() {
+    terminal_printf("Usage: lanes\n");
+    terminal_printf("\tDisplays how long commands waited in each task's urgent and normal command lanes before being\n");
+    terminal_printf("\tdequeued (measured from dispatch until the target task received them)\n");
+    terminal_printf("\tThe urgent lane is always read first, so commands can be read in a different order than the queue set\n");
+    terminal_printf("\treported them (out of order); empty wakeups are reports whose command a drop-oldest overflow discarded\n");
+}
+
+/* ---------- TRACE COMMAND ---------- */
+
+// Buffer for `trace dump`; static to keep it off the shell task's stack
+static uint8_t trace_dump_buffer[SHELL_TRACE_DUMP_BUFFER_SIZE];
+
+/**
+ * \fn shell_trace
+ *
+ * \brief Displays the command latency histograms and queue high-water marks, the newest trace ring events, or a hex
+ *        dump of the binary trace for downlink tooling. Can also reset the trace.
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_trace(char **args, int arg_count) {
+    if (arg_count == 1) {
+        const char *const interval_names[NUM_TRACE_INTERVALS] = {"dispatch", "queue", "exec"};
+        for (size_t i = 0; i < NUM_TASKS; i++) {
+            terminal_printf("%s: high-water mark urgent %u, normal %u\n", task_list[i]->name,
+                            command_trace_get_high_water_mark(i, COMMAND_LANE_URGENT),
+                            command_trace_get_high_water_mark(i, COMMAND_LANE_NORMAL));
+            for (size_t operation = 0; operation < NUM_OPERATIONS; operation++) {
+                for (size_t interval = 0; interval < NUM_TRACE_INTERVALS; interval++) {
+                    command_trace_histogram_t histogram;
+                    if (!command_trace_get_histogram(i, (operation_t)operation, (trace_interval_t)interval, &histogram)) {
+                        continue;
+                    }
+                    terminal_printf("  op %u %s (max %u us):", operation, interval_names[interval], histogram.max_us);
+                    for (size_t bin = 0; bin < COMMAND_TRACE_HISTOGRAM_BINS; bin++) {
+                        terminal_printf(" %u", histogram.bins[bin]);
+                    }
+                    terminal_printf("\n");
+                }
+            }
+        }
+        terminal_printf("Bin 0 is < %u us, each following bin doubles the upper bound\n", 1u << COMMAND_TRACE_BIN_SHIFT);
+    } else if (arg_count == 2 && strcmp(args[1], "ring") == 0) {
+        command_trace_event_t events[SHELL_TRACE_RING_EVENTS];
+        const size_t count = command_trace_read_events(events, SHELL_TRACE_RING_EVENTS);
+        const char *const stage_names[NUM_TRACE_STAGES] = {"enqueue", "dispatch", "dequeue", "complete"};
+        for (size_t i = 0; i < count; i++) {
+            terminal_printf("tick %u cycle %u id %u task %u op %u %s\n", events[i].ticks, events[i].cycles, events[i].trace_id,
+                            events[i].task_index, events[i].operation, stage_names[events[i].stage]);
+        }
+    } else if (arg_count == 2 && strcmp(args[1], "dump") == 0) {
+        const size_t size = command_trace_serialize(trace_dump_buffer, sizeof(trace_dump_buffer));
+        for (size_t i = 0; i < size; i++) {
+            terminal_printf("%02x", trace_dump_buffer[i]);
+            if (i % 32 == 31 || i == size - 1) {
+                terminal_printf("\n");
+            }
+        }
+    } else if (arg_count == 2 && strcmp(args[1], "reset") == 0) {
+        command_trace_reset();
+        terminal_printf("Command trace reset\n");
+    } else {
+        terminal_printf("Invalid usage. Try 'help trace'\n");
+    }
+}
+
+/**
+ * \fn help_trace
+ *
+ * \brief helper for shell_trace
+ *
+ */
+void help_trace() {
+    terminal_printf("Usage: trace [ring|dump|reset]\n");
+    terminal_printf("\ttrace: per-task queue high-water marks and per-operation log2 latency histograms for the\n");
+    terminal_printf("\t       dispatch (enqueue to target lane), queue (lane to target) and exec intervals\n");
+    terminal_printf("\ttrace ring: the newest command lifecycle events\n");
+    terminal_printf("\ttrace dump: the binary trace (see command_trace.c) as hex\n");
+    terminal_printf("\ttrace reset: clear the trace\n");
+}
+
+/* ---------- CHECKIN COMMAND ---------- */
+
+/**
+ * \fn shell_checkin
+ *
+ * \brief Displays how tasks check in with the watchdog and how many checkins went through each path, or switches between
+ *        direct checkins and audited checkin commands
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_checkin(char **args, int arg_count) {
+    if (arg_count == 2 && strcmp(args[1], "direct") == 0) {
+        set_watchdog_checkin_mode(WATCHDOG_CHECKIN_DIRECT);
+    } else if (arg_count == 2 && strcmp(args[1], "command") == 0) {
+        set_watchdog_checkin_mode(WATCHDOG_CHECKIN_COMMAND);
+    } else if (arg_count != 1) {
+        terminal_printf("Invalid usage. Try 'help checkin'\n");
+        return;
+    }
+
+    const watchdog_checkin_stats_t stats = get_watchdog_checkin_stats();
+    terminal_printf("checkin mode: %s, %u direct checkins, %u checkin commands\n",
+                    get_watchdog_checkin_mode() == WATCHDOG_CHECKIN_DIRECT ? "direct" : "command", stats.direct_checkins,
+                    stats.command_checkins);
+}
+
+/**
+ * \fn help_checkin
+ *
+ * \brief helper for shell_checkin
+ *
+ */
+void help_checkin() {
+    terminal_printf("Usage: checkin [direct|command]\n");
+    terminal_printf("\tcheckin: the current checkin mode and the number of checkins recorded through each path\n");
+    terminal_printf("\tcheckin direct: tasks store their checkin time directly (no command or context switch)\n");
+    terminal_printf("\tcheckin command: tasks send checkin commands through the command dispatcher, so they are audited\n");
+}
+
+/* ---------- MARGINS COMMAND ---------- */
+
+// Buffer for `margins dump`; static to keep it off the shell task's stack
+static uint8_t margins_dump_buffer[NUM_TASKS * sizeof(watchdog_checkin_record_t)];
+
+/**
+ * \fn shell_margins
+ *
+ * \brief Displays the check-in interval statistics of every task and how close each came to its watchdog timeout, or a
+ *        hex dump of the packed telemetry records. Can also reset the statistics.
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_margins(char **args, int arg_count) {
+    if (arg_count == 1) {
+        for (size_t i = 0; task_list[i] != NULL; i++) {
+            const watchdog_checkin_record_t record = get_watchdog_checkin_record(task_list[i]);
+            if (record.intervals == 0) {
+                continue;
+            }
+            terminal_printf("%s: timeout %u ms, %u intervals, min %u ms, mean %u ms, max %u ms, worst margin %u ms\n",
+                            task_list[i]->name, record.timeout_ms, record.intervals, record.min_interval_ms, record.mean_interval_ms,
+                            record.max_interval_ms, record.min_margin_ms);
+            terminal_printf("\tby eighths of the timeout:");
+            for (size_t bin = 0; bin < CHECKIN_HISTOGRAM_BINS; bin++) {
+                terminal_printf(" %u", record.histogram[bin]);
+            }
+            terminal_printf("\n");
+        }
+    } else if (arg_count == 2 && strcmp(args[1], "dump") == 0) {
+        const size_t size = watchdog_checkin_serialize(margins_dump_buffer, sizeof(margins_dump_buffer));
+        for (size_t i = 0; i < size; i++) {
+            terminal_printf("%02x", margins_dump_buffer[i]);
+        }
+        terminal_printf("\n");
+    } else if (arg_count == 2 && strcmp(args[1], "reset") == 0) {
+        reset_watchdog_checkin_interval_stats();
+        terminal_printf("Check-in interval statistics reset\n");
+    } else {
+        terminal_printf("Invalid usage. Try 'help margins'\n");
+    }
+}
+
+/**
+ * \fn help_margins
+ *
+ * \brief helper for shell_margins
+ *
+ */
+void help_margins() {
+    terminal_printf("Usage: margins [dump|reset]\n");
+    terminal_printf("\tmargins: min/mean/max check-in interval, worst-case margin before the watchdog timeout and an\n");
+    terminal_printf("\t         interval histogram (by eighths of the timeout) for every task that has checked in\n");
+    terminal_printf("\tmargins dump: one packed watchdog_checkin_record_t per task (see watchdog_task.h) as hex\n");
+    terminal_printf("\tmargins reset: clear the statistics\n");
+}
+
+/* ---------- MODE COMMAND ---------- */
+
+/**
+ * \fn shell_mode
+ *
+ * \brief Displays the current satellite mode and how long mode transitions take, or moves the system into another mode
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_mode(char **args, int arg_count) {
+    if (arg_count == 2) {
+        const mode_profile_t *const p_profile = get_mode_profile(args[1]);
+        if (p_profile == NULL) {
+            terminal_printf("Unknown mode '%s'. Try 'help mode'\n", args[1]);
+            return;
+        }
+
+        command_t set_mode_command = get_set_mode_command(p_profile);
+        const status_t result = enqueue_command_and_wait(&set_mode_command, pdMS_TO_TICKS(SHELL_COMMAND_TIMEOUT_MS));
+        if (result != SUCCESS) {
+            terminal_printf("mode: Failed to enter %s mode (status %d)\n", p_profile->name, result);
+            return;
+        }
+    } else if (arg_count != 1) {
+        terminal_printf("Invalid usage. Try 'help mode'\n");
+        return;
+    }
+
+    const mode_profile_t *const p_current_mode = get_current_mode();
+    const mode_transition_stats_t stats = get_mode_transition_stats();
+    terminal_printf("mode: %s\n", p_current_mode != NULL ? p_current_mode->name : "startup");
+    terminal_printf("%u transitions, last changed %u tasks in %u us (scheduler suspended for %u us), max %u us\n", stats.transitions,
+                    stats.last_tasks_changed, stats.last_transition_us, stats.last_suspended_us, stats.max_transition_us);
+}
+
+/**
+ * \fn help_mode
+ *
+ * \brief helper for shell_mode
+ *
+ */
+void help_mode() {
+    terminal_printf("Usage: mode [detumble|nominal|safe]\n");
+    terminal_printf("\tmode: the current satellite mode and the latency of mode transitions\n");
+    terminal_printf("\tmode <name>: enable, disable and reprioritise tasks to match the mode's profile in one step\n");
+}
+
+/* ---------- TOP COMMAND ---------- */
+
+// Results of the latest `top`; static to keep them off the shell task's stack
+static run_time_report_t top_report;
+
+/**
+ * \fn shell_top
+ *
+ * \brief Measures CPU usage over a short window and displays each task's share of the CPU, the idle share, the context
+ *        switch rate and the longest single run slice of each task
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_top(char **args, int arg_count) {
+    uint32_t window_ms = SHELL_TOP_WINDOW_MS;
+    if (arg_count == 2) {
+        window_ms = 0;
+        for (const char *p_digit = args[1]; *p_digit != '\0'; p_digit++) {
+            if (*p_digit < '0' || *p_digit > '9' || window_ms > SHELL_TOP_MAX_WINDOW_MS) {
+                window_ms = 0;
+                break;
+            }
+            window_ms = window_ms * 10 + (uint32_t)(*p_digit - '0');
+        }
+    } else if (arg_count != 1) {
+        window_ms = 0;
+    }
+
+    if (window_ms == 0 || window_ms > SHELL_TOP_MAX_WINDOW_MS) {
+        terminal_printf("Invalid usage. Try 'help top'\n");
+        return;
+    }
+
+    terminal_printf("top: measuring for %u ms...\n", window_ms);
+    if (run_time_stats_measure(window_ms, &top_report) != SUCCESS) {
+        terminal_printf("top: Failed to measure run-time statistics\n");
+        return;
+    }
+
+    terminal_printf("%u context switches/s, idle %u.%u%%\n", top_report.context_switches_per_s, top_report.idle_permille / 10,
+                    top_report.idle_permille % 10);
+    terminal_printf("CPU%%\tworst slice (us)\ttask\n");
+    for (size_t i = 0; i < top_report.num_tasks; i++) {
+        const run_time_task_stats_t *const p_stats = &top_report.tasks[i];
+        terminal_printf("%u.%u\t%u\t\t\t%s%s\n", p_stats->cpu_permille / 10, p_stats->cpu_permille % 10,
+                        cycles_to_us(p_stats->worst_slice_cycles), p_stats->name, p_stats->p_task != NULL ? "" : " (not a PVDX task)");
+    }
+    if (top_report.worst_slice_task != NULL) {
+        terminal_printf("worst run slice: %u us (%s)\n", cycles_to_us(top_report.worst_slice_cycles), top_report.worst_slice_task);
+    }
+}
+
+/**
+ * \fn help_top
+ *
+ * \brief helper for shell_top
+ *
+ */
+void help_top() {
+    terminal_printf("Usage: top [window_ms]\n");
+    terminal_printf("\tMeasures for window_ms (default %u, at most %u) and shows each task's CPU share and longest run\n",
+                    SHELL_TOP_WINDOW_MS, SHELL_TOP_MAX_WINDOW_MS);
+    terminal_printf("\tslice, the idle share and context switches per second\n");
+}
+
+/* ---------- STACKS COMMAND ---------- */
+
+// Buffer for `stacks dump`; static to keep it off the shell task's stack
+static uint8_t stacks_dump_buffer[NUM_TASKS * sizeof(stack_usage_record_t)];
+
+/**
+ * \fn shell_stacks
+ *
+ * \brief Displays how much of its stack every task has ever used, or a hex dump of the packed telemetry records
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_stacks(char **args, int arg_count) {
+    // Sample now so that the figures are current rather than as of the watchdog's last pet
+    stack_usage_sample();
+
+    if (arg_count == 1) {
+        terminal_printf("size\tpeak\tfree\tused%%\ttask\n");
+        for (size_t i = 0; task_list[i] != NULL; i++) {
+            const stack_usage_record_t record = get_stack_usage_record(task_list[i]);
+            if (!(record.flags & STACK_USAGE_FLAG_RUNNING)) {
+                terminal_printf("%u\t-\t-\t-\t%s (not running)\n", record.stack_size_words, task_list[i]->name);
+                continue;
+            }
+            const uint32_t used_permille = (uint32_t)record.peak_used_words * 1000 / record.stack_size_words;
+            terminal_printf("%u\t%u\t%u\t%u.%u\t%s%s\n", record.stack_size_words, record.peak_used_words, record.min_free_words,
+                            used_permille / 10, used_permille % 10, task_list[i]->name,
+                            (record.flags & STACK_USAGE_FLAG_LOW) ? " (low)" : "");
+        }
+        terminal_printf("(sizes in words; run 'make stack_report' for the static worst case)\n");
+    } else if (arg_count == 2 && strcmp(args[1], "dump") == 0) {
+        const size_t size = stack_usage_serialize(stacks_dump_buffer, sizeof(stacks_dump_buffer));
+        for (size_t i = 0; i < size; i++) {
+            terminal_printf("%02x", stacks_dump_buffer[i]);
+        }
+        terminal_printf("\n");
+    } else {
+        terminal_printf("Invalid usage. Try 'help stacks'\n");
+    }
+}
+
+/**
+ * \fn help_stacks
+ *
+ * \brief helper for shell_stacks
+ *
+ */
+void help_stacks() {
+    terminal_printf("Usage: stacks [dump]\n");
+    terminal_printf("\tstacks: stack size, deepest use seen and smallest free space (in words) of every task\n");
+    terminal_printf("\tstacks dump: one packed stack_usage_record_t per task (see stack_usage.h) as hex\n");
+}
+
+/* ---------- PERIODS COMMAND ---------- */
+
+// Buffer for `periods dump`; static to keep it off the shell task's stack
+static uint8_t periods_dump_buffer[NUM_TASKS * sizeof(task_period_record_t)];
+
+/**
+ * \fn shell_periods
+ *
+ * \brief Displays the release statistics (overruns, dropped releases, jitter and longest job) of every periodic task,
+ *        or a hex dump of the packed telemetry records. Can also reset the statistics.
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_periods(char **args, int arg_count) {
+    if (arg_count == 1) {
+        for (size_t i = 0; task_list[i] != NULL; i++) {
+            const task_period_record_t record = get_task_period_record(task_list[i]);
+            if (record.period_ms == 0) {
+                continue;
+            }
+            terminal_printf("%s: period %u ms, %u releases, %u overruns, %u dropped, jitter mean %u us max %u us, longest job %u us\n",
+                            task_list[i]->name, record.period_ms, record.releases, record.overruns, record.skipped_releases,
+                            record.mean_jitter_us, record.max_jitter_us, record.max_execution_us);
+        }
+    } else if (arg_count == 2 && strcmp(args[1], "dump") == 0) {
+        const size_t size = task_period_serialize(periods_dump_buffer, sizeof(periods_dump_buffer));
+        for (size_t i = 0; i < size; i++) {
+            terminal_printf("%02x", periods_dump_buffer[i]);
+        }
+        terminal_printf("\n");
+    } else if (arg_count == 2 && strcmp(args[1], "reset") == 0) {
+        reset_task_period_stats();
+        terminal_printf("Release statistics reset\n");
+    } else {
+        terminal_printf("Invalid usage. Try 'help periods'\n");
+    }
+}
+
+/**
+ * \fn help_periods
+ *
+ * \brief helper for shell_periods
+ *
+ */
+void help_periods() {
+    terminal_printf("Usage: periods [dump|reset]\n");
+    terminal_printf("\tperiods: releases, overruns, dropped releases, release jitter and longest job of every periodic task\n");
+    terminal_printf("\tperiods dump: one packed task_period_record_t per task (see task_period.h) as hex\n");
+    terminal_printf("\tperiods reset: clear the statistics\n");
+}
+
+/* ---------- IDLE COMMAND ---------- */
+
+/**
+ * \fn shell_idle
+ *
+ * \brief Displays how much of the time the core has spent asleep in tickless idle and how many tick interrupts that
+ *        saved, or resets the statistics
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_idle(char **args, int arg_count) {
+    if (arg_count == 1) {
+        tickless_stats_t stats;
+        uint32_t elapsed_counts;
+        get_tickless_stats(&stats, &elapsed_counts);
+        const uint32_t residency_permille = elapsed_counts > 0 ? (uint32_t)(stats.slept_counts * 1000 / elapsed_counts) : 0;
+        terminal_printf("asleep %u.%u%% of %u s, %u ticks suppressed\n", residency_permille / 10, residency_permille % 10,
+                        elapsed_counts / TICKLESS_RTC_HZ, stats.suppressed_ticks);
+        terminal_printf("%u sleeps (%u woken early by an interrupt), %u not entered\n", stats.sleeps, stats.early_wakeups,
+                        stats.aborted_sleeps);
+    } else if (arg_count == 2 && strcmp(args[1], "reset") == 0) {
+        reset_tickless_stats();
+        terminal_printf("Idle statistics reset\n");
+    } else {
+        terminal_printf("Invalid usage. Try 'help idle'\n");
+    }
+}
+
+/**
+ * \fn help_idle
+ *
+ * \brief helper for shell_idle
+ *
+ */
+void help_idle() {
+    terminal_printf("Usage: idle [reset]\n");
+    terminal_printf("\tidle: share of the time spent asleep in tickless idle, tick interrupts suppressed and sleep counts\n");
+    terminal_printf("\tidle reset: clear the statistics\n");
+}
+
+/* ---------- SCHEDULE COMMAND ---------- */
+
+/**
+ * \fn shell_schedule
+ *
+ * \brief Displays every periodically scheduled command with its release statistics, or resets the statistics
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_schedule(char **args, int arg_count) {
+    if (arg_count == 1) {
+        terminal_printf("entry\ttarget\t\top\tperiod\tphase\tnext\treleases\tfailed\tskipped\tdisabled\tdrift mean/max (ms)\n");
+        for (size_t i = 0; i < COMMAND_SCHEDULE_MAX_ENTRIES; i++) {
+            command_schedule_info_t info;
+            if (!get_command_schedule_entry(i, &info)) {
+                continue;
+            }
+            const uint32_t mean_drift_ms = info.stats.releases > 0 ? info.stats.total_drift_ms / info.stats.releases : 0;
+            terminal_printf("%u\t%s\t\t%d\t%u\t%u\t%u\t%u\t\t%u\t%u\t%u\t\t%u/%u\n", i, info.target->name, info.operation,
+                            info.period_ms, info.phase_ms, info.next_release_ms, info.stats.releases, info.stats.failures,
+                            info.stats.skipped, info.stats.disabled, mean_drift_ms, info.stats.max_drift_ms);
+        }
+    } else if (arg_count == 2 && strcmp(args[1], "reset") == 0) {
+        reset_command_schedule_stats();
+        terminal_printf("Schedule statistics reset\n");
+    } else {
+        terminal_printf("Invalid usage. Try 'help schedule'\n");
+    }
+}
+
+/**
+ * \fn help_schedule
+ *
+ * \brief helper for shell_schedule
+ *
+ */
+void help_schedule() {
+    terminal_printf("Usage: schedule [reset]\n");
+    terminal_printf("\tschedule: commands emitted periodically into the dispatcher, with their period, phase and time to the next\n");
+    terminal_printf("\trelease (ms), releases, failed and skipped releases, releases held back while the target was disabled,\n");
+    terminal_printf("\tand how late releases were emitted\n");
+    terminal_printf("\tschedule reset: clear the statistics\n");
+}
+
+/* ---------- CRASHLOG COMMAND ---------- */
+
+// Buffers for `crashlog dump` and `crashlog zip`; static to keep them off the shell task's stack
+static uint8_t crashlog_dump_buffer[CRASH_LOG_CAPACITY * sizeof(crash_log_record_t)];
+static log_compressor_t crashlog_compressor;
+static uint8_t crashlog_payload[LOG_COMPRESS_PAYLOAD_SIZE];
+
+/**
+ * \fn shell_crashlog
+ *
+ * \brief Displays the fatal errors and warnings recovered from backup RAM after the last reset, or a hex dump of the
+ *        records for downlink, either as they are or compressed into SPP-sized payloads
+ *
+ * \param args the command and arguments the shell command recieves
+ *
+ * \param arg_count the number of total arguments provided
+ *
+ */
+void shell_crashlog(char **args, int arg_count) {
+    if (arg_count == 1) {
+        size_t count = 0;
+        const crash_log_record_t *const p_records = get_recovered_crash_log(&count);
+        terminal_printf("%u messages recovered from before the last reset\n", count);
+        for (size_t i = 0; i < count; i++) {
+            terminal_printf("#%u %s at tick %u: %s", p_records[i].sequence, p_records[i].kind == LOG_KIND_FATAL ? "FATAL" : "WARNING",
+                            p_records[i].ticks, p_records[i].text);
+        }
+    } else if (arg_count == 2 && strcmp(args[1], "dump") == 0) {
+        const size_t size = crash_log_serialize(crashlog_dump_buffer, sizeof(crashlog_dump_buffer));
+        for (size_t i = 0; i < size; i++) {
+            terminal_printf("%02x", crashlog_dump_buffer[i]);
+        }
+        terminal_printf("\n");
+    } else if (arg_count == 2 && strcmp(args[1], "zip") == 0) {
+        const size_t size = crash_log_serialize(crashlog_dump_buffer, sizeof(crashlog_dump_buffer));
+        size_t offset = 0;
+        do {
+            log_compressor_start(&crashlog_compressor, crashlog_payload, sizeof(crashlog_payload));
+            offset += log_compressor_sink(&crashlog_compressor, &crashlog_dump_buffer[offset], size - offset);
+            const size_t payload_length = log_compressor_finish(&crashlog_compressor);
+            for (size_t i = 0; i < payload_length; i++) {
+                terminal_printf("%02x", crashlog_payload[i]);
+            }
+            terminal_printf("\n");
+        } while (offset < size || log_compressor_pending(&crashlog_compressor) > 0);
+    } else {
+        terminal_printf("Invalid usage. Try 'help crashlog'\n");
+    }
+}
+
+/**
+ * \fn help_crashlog
+ *
+ * \brief helper for shell_crashlog
+ *
+ */
+void help_crashlog() {
+    terminal_printf("Usage: crashlog [dump|zip]\n");
+    terminal_printf("\tcrashlog: the fatal errors and warnings written to backup RAM before the last reset, oldest first\n");
+    terminal_printf("\tcrashlog dump: the recovered crash_log_record_t records (see crash_log.h) as hex\n");
+    terminal_printf("\tcrashlog zip: the same records compressed, one payload per line (see scripts/log_decompress.py)\n");
+}
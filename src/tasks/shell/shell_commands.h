@@ -28,4 +28,37 @@ void help_reboot();
 void shell_display(char **args, int arg_count);
 void help_display();
 
+void shell_lanes(char **args, int arg_count);
+void help_lanes();
+
+void shell_trace(char **args, int arg_count);
+void help_trace();
+
+void shell_checkin(char **args, int arg_count);
+void help_checkin();
+
+void shell_margins(char **args, int arg_count);
+void help_margins();
+
+void shell_mode(char **args, int arg_count);
+void help_mode();
+
+void shell_top(char **args, int arg_count);
+void help_top();
+
+void shell_stacks(char **args, int arg_count);
+void help_stacks();
+
+void shell_periods(char **args, int arg_count);
+void help_periods();
+
+void shell_idle(char **args, int arg_count);
+void help_idle();
+
+void shell_schedule(char **args, int arg_count);
+void help_schedule();
+
+void shell_crashlog(char **args, int arg_count);
+void help_crashlog();
+
 #endif // SHELL_COMMANDS_H
\ No newline at end of file
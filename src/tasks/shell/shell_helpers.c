@@ -23,13 +23,11 @@ size_t get_line_from_terminal(uint8_t *p_linebuffer) {
 
     // Obtain a pointer to the current task within the global task list
     pvdx_task_t *const current_task = get_current_task();
-    // Cache the watchdog checkin command to avoid creating it every iteration
-    command_t cmd_checkin = get_watchdog_checkin_command(current_task);
 
     while (true) {
         // This is really the loop that we expect the program to spend most of its time in, so pet the watchdog here
-        enqueue_command(&cmd_checkin);
-        debug("shell: Enqueued watchdog checkin command\n");
+        checkin_with_watchdog(current_task);
+        debug("shell: Checked in with watchdog\n");
 
         int character_read = SEGGER_RTT_GetKey();
         warning("character read: %d\n", character_read);
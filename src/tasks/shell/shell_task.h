@@ -19,6 +19,11 @@
 
 #define SHELL_INPUT_POLLING_INTERVAL 200 // Check for new commands through RTT this often (in ms)
 #define SHELL_INPUT_BUFFER_SIZE 128
+#define SHELL_COMMAND_TIMEOUT_MS 2000     // How long shell commands wait for the result of a command sent to another task
+#define SHELL_TRACE_RING_EVENTS 16        // Number of trace ring events shown by `trace ring`
+#define SHELL_TRACE_DUMP_BUFFER_SIZE 1024 // Size of the buffer that `trace dump` serializes into
+#define SHELL_TOP_WINDOW_MS 1000          // Default measurement window of `top`
+#define SHELL_TOP_MAX_WINDOW_MS 4000      // Longest `top` window; the shell cannot check in with the watchdog while measuring
 #define MAX_ARGS 10
 #define SHELL_PROMPT (RTT_CTRL_TEXT_GREEN "PVDXos Shell> $ " RTT_CTRL_RESET)
 #define SHELL_RTT_CHANNEL 0 /* CHANGE THIS WITH CAUTION! GetKey AND PutKey ARE NOT GUARANTEED TO WORK ON CHANNELS OTHER THAN ZERO */
@@ -11,9 +11,14 @@
 #include "task_list.h"
 
 #include "command_dispatcher_task.h"
+#include "command_encoding.h"
+#include "command_trace.h"
+#include "cycle_counter.h"
 #include "display_task.h"
 #include "globals.h"
 #include "heartbeat_task.h"
+#include "logger_task.h"
+#include "logging.h"
 #include "shell_task.h"
 #include "task_manager_task.h"
 #include "tasks/adcs/adcs_task.h"
@@ -24,6 +29,7 @@ pvdx_task_t watchdog_task = {.name = "Watchdog",
                              .enabled = true,
                              .handle = NULL,
                              .command_queue = NULL,
+                             .queue_set_mem = &watchdog_mem.watchdog_queue_set_mem,
                              .init = init_watchdog,
                              .function = main_watchdog,
                              .stack_size = WATCHDOG_TASK_STACK_SIZE,
@@ -34,12 +40,14 @@ pvdx_task_t watchdog_task = {.name = "Watchdog",
                              .watchdog_timeout_ms = 10000,
                              .last_checkin_time_ticks = 0xDEADBEEF,
                              .has_registered = false,
-                             .task_type = OS};
+                             .task_type = OS,
+                             .task_index = TASK_INDEX_WATCHDOG};
 
 pvdx_task_t command_dispatcher_task = {.name = "CommandDispatcher",
                                        .enabled = true,
                                        .handle = NULL,
                                        .command_queue = NULL,
+                                       .queue_set_mem = &command_dispatcher_mem.command_dispatcher_queue_set_mem,
                                        .init = init_command_dispatcher,
                                        .function = main_command_dispatcher,
                                        .stack_size = COMMAND_DISPATCHER_TASK_STACK_SIZE,
@@ -50,12 +58,14 @@ pvdx_task_t command_dispatcher_task = {.name = "CommandDispatcher",
                                        .watchdog_timeout_ms = 10000,
                                        .last_checkin_time_ticks = 0xDEADBEEF,
                                        .has_registered = false,
-                                       .task_type = OS};
+                                       .task_type = OS,
+                                       .task_index = TASK_INDEX_COMMAND_DISPATCHER};
 
 pvdx_task_t task_manager_task = {.name = "TaskManager",
                                  .enabled = true,
                                  .handle = NULL,
                                  .command_queue = NULL,
+                                 .queue_set_mem = &task_manager_mem.task_manager_queue_set_mem,
                                  .init = init_task_manager,
                                  .function = main_task_manager,
                                  .stack_size = TASK_MANAGER_TASK_STACK_SIZE,
@@ -66,12 +76,14 @@ pvdx_task_t task_manager_task = {.name = "TaskManager",
                                  .watchdog_timeout_ms = 10000,
                                  .last_checkin_time_ticks = 0xDEADBEEF,
                                  .has_registered = false,
-                                 .task_type = OS};
+                                 .task_type = OS,
+                                 .task_index = TASK_INDEX_TASK_MANAGER};
 
 pvdx_task_t adcs_task = {.name = "ADCS",
                          .enabled = false,
                          .handle = NULL,
                          .command_queue = NULL,
+                         .queue_set_mem = &adcs_mem.adcs_queue_set_mem,
                          .init = init_adcs,
                          .function = main_adcs,
                          .stack_size = ADCS_TASK_STACK_SIZE,
@@ -80,14 +92,17 @@ pvdx_task_t adcs_task = {.name = "ADCS",
                          .priority = 2,
                          .task_tcb = &adcs_mem.adcs_task_tcb,
                          .watchdog_timeout_ms = 5000,
+                         .period_ms = ADCS_TASK_PERIOD_MS,
                          .last_checkin_time_ticks = 0xDEADBEEF,
                          .has_registered = false,
-                         .task_type = SENSOR};
+                         .task_type = SENSOR,
+                         .task_index = TASK_INDEX_ADCS};
 
 pvdx_task_t shell_task = {.name = "Shell",
                           .enabled = false,
                           .handle = NULL,
                           .command_queue = NULL,
+                          .queue_set_mem = NULL,
                           .init = NULL,
                           .function = main_shell,
                           .stack_size = SHELL_TASK_STACK_SIZE,
@@ -98,12 +113,14 @@ pvdx_task_t shell_task = {.name = "Shell",
                           .watchdog_timeout_ms = 10000,
                           .last_checkin_time_ticks = 0xDEADBEEF,
                           .has_registered = false,
-                          .task_type = TESTING};
+                          .task_type = TESTING,
+                          .task_index = TASK_INDEX_SHELL};
 
 pvdx_task_t display_task = {.name = "Display",
                             .enabled = false,
                             .handle = NULL,
                             .command_queue = NULL,
+                            .queue_set_mem = &display_mem.display_queue_set_mem,
                             .init = init_display,
                             .function = main_display,
                             .stack_size = DISPLAY_TASK_STACK_SIZE,
@@ -114,13 +131,15 @@ pvdx_task_t display_task = {.name = "Display",
                             .watchdog_timeout_ms = 10000,
                             .last_checkin_time_ticks = 0xDEADBEEF,
                             .has_registered = false,
-                            .task_type = ACTUATOR};
+                            .task_type = ACTUATOR,
+                            .task_index = TASK_INDEX_DISPLAY};
 
 pvdx_task_t heartbeat_task = {
     .name = "Heartbeat",
     .enabled = true,
     .handle = NULL,
     .command_queue = NULL,
+    .queue_set_mem = NULL,
     .init = NULL,
     .function = main_heartbeat,
     .stack_size = HEARTBEAT_TASK_STACK_SIZE,
@@ -131,7 +150,28 @@ pvdx_task_t heartbeat_task = {
     .watchdog_timeout_ms = 10000,
     .last_checkin_time_ticks = 0xDEADBEEF,
     .has_registered = false,
-    .task_type = OS // ACTUATOR
+    .task_type = OS, // ACTUATOR
+    .task_index = TASK_INDEX_HEARTBEAT,
+};
+
+pvdx_task_t logger_task = {
+    .name = "Logger",
+    .enabled = true,
+    .handle = NULL,
+    .command_queue = NULL,
+    .queue_set_mem = NULL,
+    .init = NULL,
+    .function = main_logger,
+    .stack_size = LOGGER_TASK_STACK_SIZE,
+    .stack_buffer = logger_mem.logger_task_stack,
+    .pvParameters = NULL,
+    .priority = 1, // Lowest task priority: logging only uses otherwise idle time
+    .task_tcb = &logger_mem.logger_task_tcb,
+    .watchdog_timeout_ms = 10000,
+    .last_checkin_time_ticks = 0xDEADBEEF,
+    .has_registered = false,
+    .task_type = SERVICE, // A Logger that stops checking in is restarted rather than rebooting the satellite
+    .task_index = TASK_INDEX_LOGGER,
 };
 
 // and define their constant pointers
@@ -142,6 +182,7 @@ pvdx_task_t *const p_adcs_task = &adcs_task;
 pvdx_task_t *const p_shell_task = &shell_task;
 pvdx_task_t *const p_display_task = &display_task;
 pvdx_task_t *const p_heartbeat_task = &heartbeat_task;
+pvdx_task_t *const p_logger_task = &logger_task;
 pvdx_task_t *const task_list_null_terminator = NULL;
 
 // Global list of all tasks running on PVDXos (see `pvdx_task_t` definition in globals.h)
@@ -150,11 +191,21 @@ pvdx_task_t *const task_list_null_terminator = NULL;
 // ***********************************************************************
 // NOTE: Watchdog task must be first in the list, Command Dispatcher second, and Task Manager third.
 // If you change the order of any of these, make sure that main.c reflects the change and update this comment.
+// Each task must sit at the position given by its `task_index` (checked on boot in main.c).
 pvdx_task_t *task_list[] = {
-    p_watchdog_task, p_command_dispatcher_task, p_task_manager_task,       p_adcs_task, p_shell_task,
-    p_display_task,  p_heartbeat_task,          task_list_null_terminator,
+    [TASK_INDEX_WATCHDOG] = p_watchdog_task,
+    [TASK_INDEX_COMMAND_DISPATCHER] = p_command_dispatcher_task,
+    [TASK_INDEX_TASK_MANAGER] = p_task_manager_task,
+    [TASK_INDEX_ADCS] = p_adcs_task,
+    [TASK_INDEX_SHELL] = p_shell_task,
+    [TASK_INDEX_DISPLAY] = p_display_task,
+    [TASK_INDEX_HEARTBEAT] = p_heartbeat_task,
+    [TASK_INDEX_LOGGER] = p_logger_task,
+    [NUM_TASKS] = task_list_null_terminator,
 };
 
+_Static_assert(sizeof(task_list) / sizeof(task_list[0]) == NUM_TASKS + 1, "task_list must hold every task_index_t plus NULL");
+
 /**
  * \fn get_current_task
  *
@@ -193,3 +244,215 @@ inline TickType_t get_command_queue_block_time_ticks(pvdx_task_t *const p_task)
 inline bool should_checkin(pvdx_task_t *const p_task) {
     return p_task->enabled;
 }
+
+/**
+ * \fn init_command_queue_set
+ *
+ * \brief Creates the urgent command lane and wakeup semaphore for a task and combines them with the task's command
+ *        queue (the normal lane) in a queue set, so that the task can block on all three at once (see
+ *        `receive_command()`). Does nothing for tasks without `queue_set_mem`.
+ *
+ * \param p_task Pointer to the `pvdx_task_t` of the task; its command queue must already exist and be empty
+ *
+ * \warning `fatal` error if the queue set cannot be created
+ */
+void init_command_queue_set(pvdx_task_t *const p_task) {
+    command_queue_set_memory_t *const p_mem = p_task->queue_set_mem;
+    if (p_mem == NULL || p_task->command_queue == NULL) {
+        return;
+    }
+
+    p_task->urgent_command_queue = xQueueCreateStatic(COMMAND_QUEUE_URGENT_MAX_COMMANDS, COMMAND_QUEUE_ITEM_SIZE,
+                                                      p_mem->urgent_queue_buffer, &p_mem->urgent_queue);
+    p_task->command_queue_set =
+        xQueueGenericCreateStatic(COMMAND_QUEUE_SET_LENGTH, sizeof(QueueSetMemberHandle_t), p_mem->queue_set_buffer,
+                                  &p_mem->queue_set, queueQUEUE_TYPE_SET);
+    p_task->wakeup_semaphore = xSemaphoreCreateBinaryStatic(&p_mem->wakeup_semaphore);
+
+    if (p_task->urgent_command_queue == NULL || p_task->command_queue_set == NULL || p_task->wakeup_semaphore == NULL) {
+        fatal("Failed to create %s queue set!\n", p_task->name);
+    }
+
+    if (xQueueAddToSet(p_task->urgent_command_queue, p_task->command_queue_set) != pdPASS ||
+        xQueueAddToSet(p_task->command_queue, p_task->command_queue_set) != pdPASS ||
+        xQueueAddToSet(p_task->wakeup_semaphore, p_task->command_queue_set) != pdPASS) {
+        fatal("Failed to add %s queues to queue set!\n", p_task->name);
+    }
+}
+
+/**
+ * \fn record_lane_wait
+ *
+ * \brief Updates the head-of-line wait statistics of a lane with a command that was just dequeued from it, and
+ *        records the dequeue in the command trace
+ *
+ * \param p_task Pointer to the `pvdx_task_t` of the task that dequeued the command
+ * \param lane The lane the command was dequeued from
+ * \param p_cmd Pointer to the dequeued command
+ */
+static void record_lane_wait(pvdx_task_t *const p_task, command_lane_t lane, command_t *const p_cmd) {
+    command_lane_stats_t *const p_stats = &p_task->lane_stats[lane];
+    const uint32_t wait_us = cycles_to_us(get_cycle_count() - p_cmd->enqueued_cycles);
+
+    // The Command Dispatcher also receives commands bound for other tasks in hub mode; only the target dequeues them
+    if (p_cmd->target == p_task) {
+        command_trace_dequeue(p_cmd);
+    }
+
+    p_stats->commands_received++;
+    if (p_cmd->enqueued_cycles == 0) {
+        return; // Sent without metadata (see `unpack_command()`), so its wait is unknown
+    }
+    p_stats->last_wait_us = wait_us;
+    p_stats->total_wait_us += wait_us;
+    if (wait_us > p_stats->max_wait_us) {
+        p_stats->max_wait_us = wait_us;
+    }
+}
+
+/**
+ * \fn take_command
+ *
+ * \brief Reads one packed command off a lane of `p_task`'s command queue and decodes it into `p_cmd`
+ *
+ * \param p_task Pointer to the `pvdx_task_t` of the task receiving the command
+ * \param lane The lane to read from
+ * \param p_cmd Pointer to the command struct to decode the received command into
+ * \param block_time_ticks Maximum time to block for
+ *
+ * \return `bool`, true if a command was decoded into `p_cmd`
+ */
+static bool take_command(pvdx_task_t *const p_task, command_lane_t lane, command_t *const p_cmd, TickType_t block_time_ticks) {
+    QueueHandle_t lane_queue = lane == COMMAND_LANE_URGENT ? p_task->urgent_command_queue : p_task->command_queue;
+    packed_command_t packed;
+    if (xQueueReceive(lane_queue, &packed, block_time_ticks) != pdPASS) {
+        return false;
+    }
+
+    unpack_command(&packed, p_cmd);
+    release_pending_command(p_task, p_cmd);
+    record_lane_wait(p_task, lane, p_cmd);
+    return true;
+}
+
+/**
+ * \fn receive_command
+ *
+ * \brief Blocks until a command arrives for the given task, the task is woken by `wake_task()`, or the block time
+ *        expires, whichever comes first. The urgent lane is always polled first, whichever lane the queue set reported,
+ *        so an urgent command overtakes normal commands that were queued before it. Reads at most one command so that
+ *        the queue set stays in step with the lanes.
+ *
+ * \param p_task Pointer to the `pvdx_task_t` of the task receiving the command
+ * \param p_cmd Pointer to the command struct to copy the received command into
+ * \param block_time_ticks Maximum time to block for
+ *
+ * \return `bool`, true if a command was copied into `p_cmd`
+ *
+ * \note Tasks without a queue set fall back to blocking on their command queue alone
+ * \note A command read from a different lane than the one reported is counted in that lane's `out_of_order`
+ *       statistic. An entry that finds both lanes empty (left by a drop-oldest overflow, see `send_to_lane()`) wakes
+ *       the task without a command and is counted in the reported lane's `empty_wakeups`.
+ */
+bool receive_command(pvdx_task_t *const p_task, command_t *const p_cmd, TickType_t block_time_ticks) {
+    if (p_task->command_queue_set == NULL) {
+        return take_command(p_task, COMMAND_LANE_NORMAL, p_cmd, block_time_ticks);
+    }
+
+    QueueSetMemberHandle_t member = xQueueSelectFromSet(p_task->command_queue_set, block_time_ticks);
+    if (member == p_task->wakeup_semaphore) {
+        xSemaphoreTake(p_task->wakeup_semaphore, 0);
+        return false;
+    }
+    if (member == NULL) {
+        return false;
+    }
+    const command_lane_t reported_lane = member == p_task->urgent_command_queue ? COMMAND_LANE_URGENT : COMMAND_LANE_NORMAL;
+
+    // Whichever lane the set reported, take from the urgent lane first. The set holds one entry per queued command
+    // (plus any left behind by drop-oldest overflows), so every command is still read even if it came from a
+    // different lane than the one reported.
+    for (command_lane_t lane = COMMAND_LANE_URGENT; lane < NUM_COMMAND_LANES; lane++) {
+        if (take_command(p_task, lane, p_cmd, 0)) {
+            p_task->lane_stats[lane].out_of_order += lane != reported_lane ? 1 : 0;
+            return true;
+        }
+    }
+
+    // Both lanes are empty, so this entry belonged to a command discarded by a drop-oldest overflow
+    p_task->lane_stats[reported_lane].empty_wakeups++;
+    taskENTER_CRITICAL();
+    if (p_task->queue_set_surplus > 0) {
+        p_task->queue_set_surplus--;
+    }
+    taskEXIT_CRITICAL();
+    return false;
+}
+
+/**
+ * \fn wake_task
+ *
+ * \brief Wakes a task blocked in `receive_command()` so that it can re-evaluate its deadlines early
+ *
+ * \param p_task Pointer to the `pvdx_task_t` of the task to wake
+ *
+ * \note Waking a task that is already awake (or has no queue set) has no effect
+ */
+void wake_task(pvdx_task_t *const p_task) {
+    if (p_task->wakeup_semaphore != NULL) {
+        xSemaphoreGive(p_task->wakeup_semaphore);
+    }
+}
+
+/**
+ * \fn flush_commands
+ *
+ * \brief Discards every command queued for a task and empties its queue set, so that it starts again from empty lanes.
+ *        Each discarded command is completed with `result`, releasing any sender waiting in `enqueue_command_and_wait()`.
+ *
+ * \param p_task Pointer to the `pvdx_task_t` of the task whose commands to discard
+ * \param result The result to complete each discarded command with
+ *
+ * \return `size_t`, the number of commands discarded
+ *
+ * \warning the task must not be able to run (e.g. it was deleted), or it would race for the same commands
+ */
+size_t flush_commands(pvdx_task_t *const p_task, status_t result) {
+    if (p_task->command_queue == NULL) {
+        return 0;
+    }
+
+    size_t flushed = 0;
+    command_t cmd;
+    while ((p_task->urgent_command_queue != NULL && take_command(p_task, COMMAND_LANE_URGENT, &cmd, 0)) ||
+           take_command(p_task, COMMAND_LANE_NORMAL, &cmd, 0)) {
+        cmd.result = result;
+        complete_command(&cmd);
+        flushed++;
+    }
+
+    if (p_task->command_queue_set != NULL) {
+        // Take the wakeup token before emptying the set, or later `wake_task()` calls would never reach the set again
+        xSemaphoreTake(p_task->wakeup_semaphore, 0);
+        xQueueReset(p_task->command_queue_set);
+        taskENTER_CRITICAL();
+        p_task->queue_set_surplus = 0;
+        taskEXIT_CRITICAL();
+    }
+    return flushed;
+}
+
+/**
+ * \fn ticks_until
+ *
+ * \brief Returns the number of ticks remaining until an absolute tick count, or 0 if it has already passed. Safe across
+ *        tick counter overflow as long as the deadline is less than half the tick range away.
+ *
+ * \param deadline_ticks Absolute tick count of the deadline
+ *
+ * \return `TickType_t`
+ */
+TickType_t ticks_until(TickType_t deadline_ticks) {
+    const TickType_t remaining_ticks = deadline_ticks - xTaskGetTickCount();
+    return ((int32_t)remaining_ticks > 0) ? remaining_ticks : 0;
+}
@@ -12,10 +12,16 @@ extern pvdx_task_t *const p_adcs_task;
 extern pvdx_task_t *const p_shell_task;
 extern pvdx_task_t *const p_display_task;
 extern pvdx_task_t *const p_heartbeat_task;
+extern pvdx_task_t *const p_logger_task;
 extern pvdx_task_t *task_list[];
 
 pvdx_task_t *get_current_task(void);
 TickType_t get_command_queue_block_time_ticks(pvdx_task_t *const task);
 bool should_checkin(pvdx_task_t *const p_task);
+void init_command_queue_set(pvdx_task_t *const p_task);
+bool receive_command(pvdx_task_t *const p_task, command_t *const p_cmd, TickType_t block_time_ticks);
+void wake_task(pvdx_task_t *const p_task);
+size_t flush_commands(pvdx_task_t *const p_task, status_t result);
+TickType_t ticks_until(TickType_t deadline_ticks);
 
 #endif // TASK_LIST_H
@@ -0,0 +1,60 @@
+/**
+ * mode_profiles.c
+ *
+ * Mode profiles for the satellite modes of PVDX's state diagram. Each profile names the subtasks that run in a mode
+ * together with their priorities and watchdog timeouts, so that the task manager can move between modes in a single
+ * step (see `task_manager_set_mode()`) instead of enabling and disabling tasks one command at a time.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "mode_profiles.h"
+
+#include <string.h>
+
+const mode_profile_t mode_profiles[NUM_MODES] = {
+    [MODE_DETUMBLE] =
+        {
+            .name = "detumble",
+            .mode = MODE_DETUMBLE,
+            .enabled_tasks = MODE_SERVICE_TASKS | MODE_TASK_BIT(TASK_INDEX_ADCS) | MODE_TASK_BIT(TASK_INDEX_SHELL),
+            .priorities = {[TASK_INDEX_ADCS] = 3, [TASK_INDEX_SHELL] = 1},
+            .watchdog_timeouts_ms = {[TASK_INDEX_ADCS] = 2000},
+        },
+    [MODE_NOMINAL] =
+        {
+            .name = "nominal",
+            .mode = MODE_NOMINAL,
+            .enabled_tasks = MODE_SERVICE_TASKS | MODE_TASK_BIT(TASK_INDEX_ADCS) | MODE_TASK_BIT(TASK_INDEX_SHELL) |
+                             MODE_TASK_BIT(TASK_INDEX_DISPLAY),
+            .priorities = {[TASK_INDEX_ADCS] = 2, [TASK_INDEX_SHELL] = 2, [TASK_INDEX_DISPLAY] = 2},
+            .watchdog_timeouts_ms = {[TASK_INDEX_ADCS] = 5000, [TASK_INDEX_SHELL] = 10000, [TASK_INDEX_DISPLAY] = 10000},
+        },
+    [MODE_SAFE] =
+        {
+            .name = "safe",
+            .mode = MODE_SAFE,
+            .enabled_tasks = MODE_SERVICE_TASKS | MODE_TASK_BIT(TASK_INDEX_SHELL),
+            .priorities = {[TASK_INDEX_SHELL] = 2},
+            .watchdog_timeouts_ms = {[TASK_INDEX_SHELL] = 10000},
+        },
+};
+
+/**
+ * \fn get_mode_profile
+ *
+ * \brief Looks up a mode profile by name
+ *
+ * \param name the name of the mode (e.g. "nominal")
+ *
+ * \returns `const mode_profile_t *`, the profile, or NULL if there is no mode with that name
+ */
+const mode_profile_t *get_mode_profile(const char *const name) {
+    for (size_t i = 0; i < NUM_MODES; i++) {
+        if (strcmp(mode_profiles[i].name, name) == 0) {
+            return &mode_profiles[i];
+        }
+    }
+    return NULL;
+}
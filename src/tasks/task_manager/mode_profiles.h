@@ -0,0 +1,36 @@
+#ifndef MODE_PROFILES_H
+#define MODE_PROFILES_H
+
+// Includes
+#include "globals.h"
+
+// Constants
+#define MODE_TASK_BIT(task_index) (1UL << (task_index))     // Bit of a task in `mode_profile_t.enabled_tasks`
+#define MODE_SERVICE_TASKS MODE_TASK_BIT(TASK_INDEX_LOGGER) // Service subtasks, enabled in every mode
+#define MODE_PROFILE_KEEP 0                                  // Priority or timeout that leaves the task's current value in place
+
+_Static_assert(NUM_TASKS <= 32, "mode_profile_t.enabled_tasks has one bit per task");
+
+// The satellite modes of PVDX's state diagram
+typedef enum {
+    MODE_DETUMBLE = 0, // Stabilising after deployment; attitude control gets the processor
+    MODE_NOMINAL,      // Normal operations; every subtask runs
+    MODE_SAFE,         // Fault response; only what is needed to talk to the ground stays on
+    NUM_MODES,         // Number of modes (must stay last)
+} satellite_mode_t;
+
+// Which subtasks run in a satellite mode, and at what priority and watchdog timeout (applied by `task_manager_set_mode()`).
+// OS tasks are always enabled and keep their own settings.
+struct mode_profile {
+    const char *const name;                         // Name of the mode (as typed in the shell)
+    const satellite_mode_t mode;                    // The mode this profile describes
+    const uint32_t enabled_tasks;                   // Bitset of the subtasks enabled in this mode (see `MODE_TASK_BIT()`)
+    const UBaseType_t priorities[NUM_TASKS];        // Priority of each enabled subtask (`MODE_PROFILE_KEEP` to leave it)
+    const uint32_t watchdog_timeouts_ms[NUM_TASKS]; // Watchdog timeout of each enabled subtask (`MODE_PROFILE_KEEP` to leave it)
+};
+
+extern const mode_profile_t mode_profiles[NUM_MODES];
+
+const mode_profile_t *get_mode_profile(const char *const name);
+
+#endif // MODE_PROFILES_H
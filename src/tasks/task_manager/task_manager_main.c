@@ -35,8 +35,6 @@ void main_task_manager(void *pvParameters) {
     debug("task_manager: Enqueued command to initialize all subtasks\n");
     // Obtain a pointer to the current task within the global task list
     pvdx_task_t *const current_task = get_current_task();
-    // Cache the watchdog checkin command to avoid creating it every iteration
-    command_t cmd_checkin = get_watchdog_checkin_command(current_task);
     // Calculate the maximum time the command dispatcher should block (and thus be unable to check in with the watchdog)
     const TickType_t queue_block_time_ticks = get_command_queue_block_time_ticks(current_task);
     // Varible to hold commands popped off the queue
@@ -58,19 +56,20 @@ void main_task_manager(void *pvParameters) {
     while (true) {
         debug("\n---------- Task Manager Task Loop ----------\n");
 
-        // Execute all commands contained in the queue
-        if (xQueueReceive(p_task_manager_task->command_queue, &cmd, queue_block_time_ticks) == pdPASS) {
+        // Execute all commands contained in the queue (urgent lane first)
+        if (receive_command(current_task, &cmd, queue_block_time_ticks)) {
             do {
                 debug("task_manager: Command popped off queue. Target: %d, Operation: %d\n", cmd.target, cmd.operation);
-                exec_command_task_manager(&cmd);
-            } while (xQueueReceive(p_task_manager_task->command_queue, &cmd, 0) == pdPASS);
+                exec_command(&cmd);
+                complete_command(&cmd);
+            } while (receive_command(current_task, &cmd, 0));
         }
         debug("task_manager: No more commands queued.\n");
 
         // Check in with the watchdog task
         if (should_checkin(current_task)) {
-            enqueue_command(&cmd_checkin);
-            debug("task_manager: Enqueued watchdog checkin command\n");
+            checkin_with_watchdog(current_task);
+            debug("task_manager: Checked in with watchdog\n");
         }
     }
 }
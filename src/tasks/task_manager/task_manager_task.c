@@ -11,9 +11,22 @@
 
 #include "task_manager_task.h"
 
+#include "cycle_counter.h"
 #include "logging.h"
 #include "watchdog_task.h"
 
+// Restarts of each task within its current escalation window (see `task_manager_restart_task()`)
+static struct {
+    TickType_t window_start_ticks; // When the first restart of the window happened
+    uint8_t restarts;              // Restarts since `window_start_ticks`
+} restart_windows[NUM_TASKS];
+
+static task_restart_stats_t restart_stats = {0};
+
+// Profile applied by the latest mode transition (NULL until the first one)
+static const mode_profile_t *current_mode = NULL;
+static mode_transition_stats_t mode_transition_stats = {0};
+
 /* ---------- DISPATCHABLE FUNCTIONS (sent as commands through the command dispatcher task) ---------- */
 
 /**
@@ -29,7 +42,13 @@ void task_manager_init_subtasks(void) {
             unlock_mutex(task_list_mutex);
         }
     }
-    debug("task_manager: All subtasks initialized\n");
+
+    // Everything a full reboot would have to bring back up is now running. The cycle counter only starts in
+    // `PVDX_init()`, so this leaves out the reset itself and the bootloader and is a lower bound on a reboot's cost.
+    if (restart_stats.min_boot_us == 0) {
+        restart_stats.min_boot_us = cycles_to_us(get_cycle_count());
+    }
+    debug("task_manager: All subtasks initialized %d us after the cycle counter started\n", restart_stats.min_boot_us);
 }
 
 /**
@@ -65,6 +84,7 @@ void task_manager_enable_task(pvdx_task_t *const p_task) {
     register_task_with_watchdog(p_task);
 
     unlock_mutex(task_list_mutex);
+    wake_task(p_watchdog_task); // Let the watchdog re-scan the task list with the new task included
     debug("task_manager: %s task enabled\n", p_task->name);
 }
 
@@ -98,12 +118,110 @@ void task_manager_disable_task(pvdx_task_t *const p_task) {
     p_task->enabled = false;
 
     // Unregister the task with the watchdog so it is no longer monitored
-    unregister_task_with_watchdog(p_task->handle);
+    unregister_task_with_watchdog(p_task);
 
     unlock_mutex(task_list_mutex);
+    wake_task(p_watchdog_task); // Let the watchdog re-scan the task list without the disabled task
     debug("task_manager: %s task disabled\n", p_task->name);
 }
 
+/**
+ * \fn task_manager_set_mode
+ *
+ * \brief Moves the system into a satellite mode in one step. Every subtask whose enabled state differs from the profile
+ *        is resumed or suspended (and registered or unregistered with the watchdog), and enabled subtasks get the
+ *        profile's priority and watchdog timeout. Everything is applied with the scheduler suspended, so no task ever
+ *        runs in a mix of the old and new modes; tasks whose state already matches are left alone.
+ *
+ * \param p_profile the mode profile to apply
+ *
+ * \returns `status_t`, SUCCESS, or ERROR_NOT_READY if the subtasks have not been initialized yet
+ *
+ * \warning requires the task list mutex
+ * \warning modifies task structs
+ */
+status_t task_manager_set_mode(const mode_profile_t *const p_profile) {
+    const uint32_t start_cycles = get_cycle_count();
+    lock_mutex(task_list_mutex);
+
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        if (task_list[i]->task_type != OS && task_list[i]->handle == NULL) {
+            unlock_mutex(task_list_mutex);
+            warning("task_manager: Cannot enter %s mode before %s task is initialized\n", p_profile->name, task_list[i]->name);
+            return ERROR_NOT_READY;
+        }
+    }
+
+    uint32_t tasks_changed = 0;
+    uint32_t tasks_to_wake = 0; // Tasks whose watchdog timeout changed, so that they recompute their block time
+    const uint32_t suspend_cycles = get_cycle_count();
+    vTaskSuspendAll();
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        pvdx_task_t *const p_task = task_list[i];
+        if (p_task->task_type == OS) {
+            continue;
+        }
+
+        const bool enable = (p_profile->enabled_tasks & MODE_TASK_BIT(p_task->task_index)) != 0;
+        bool changed = enable != p_task->enabled;
+        if (enable) {
+            const UBaseType_t priority = p_profile->priorities[p_task->task_index];
+            if (priority != MODE_PROFILE_KEEP && priority != p_task->priority) {
+                vTaskPrioritySet(p_task->handle, priority);
+                p_task->priority = priority;
+                changed = true;
+            }
+
+            const uint32_t timeout_ms = p_profile->watchdog_timeouts_ms[p_task->task_index];
+            if (timeout_ms != MODE_PROFILE_KEEP && timeout_ms != p_task->watchdog_timeout_ms) {
+                set_watchdog_timeout(p_task, timeout_ms);
+                tasks_to_wake |= MODE_TASK_BIT(p_task->task_index);
+                changed = true;
+            }
+        }
+
+        if (enable && !p_task->enabled) {
+            vTaskResume(p_task->handle);
+            p_task->enabled = true;
+            register_task_with_watchdog(p_task);
+        } else if (!enable && p_task->enabled) {
+            vTaskSuspend(p_task->handle);
+            p_task->enabled = false;
+            unregister_task_with_watchdog(p_task);
+        }
+        tasks_changed += changed ? 1 : 0;
+    }
+    xTaskResumeAll();
+    const uint32_t suspended_us = cycles_to_us(get_cycle_count() - suspend_cycles);
+
+    const mode_profile_t *const p_previous_mode = current_mode;
+    current_mode = p_profile;
+    unlock_mutex(task_list_mutex);
+
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        if (tasks_to_wake & MODE_TASK_BIT(i)) {
+            wake_task(task_list[i]);
+        }
+    }
+    wake_task(p_watchdog_task); // Let the watchdog rebuild its deadlines for the new set of tasks
+
+    const uint32_t transition_us = cycles_to_us(get_cycle_count() - start_cycles);
+    taskENTER_CRITICAL();
+    mode_transition_stats.transitions++;
+    mode_transition_stats.last_tasks_changed = tasks_changed;
+    mode_transition_stats.last_transition_us = transition_us;
+    mode_transition_stats.last_suspended_us = suspended_us;
+    if (transition_us > mode_transition_stats.max_transition_us) {
+        mode_transition_stats.max_transition_us = transition_us;
+    }
+    taskEXIT_CRITICAL();
+
+    (void)p_previous_mode; // Only logged, and info compiles out in release builds
+    info("task_manager: Mode %s -> %s: %d tasks changed in %d us (scheduler suspended for %d us)\n",
+         p_previous_mode != NULL ? p_previous_mode->name : "startup", p_profile->name, tasks_changed, transition_us, suspended_us);
+    return SUCCESS;
+}
+
 /* ---------- NON-DISPATCHABLE FUNCTIONS (do not go through the command dispatcher) ---------- */
 
 /**
@@ -148,6 +266,7 @@ void init_task_pointer(pvdx_task_t *const p_task) {
     if (task_init) {
         QueueHandle_t queue_handle = task_init();
         p_task->command_queue = queue_handle;
+        init_command_queue_set(p_task);
     }
 
     p_task->handle = xTaskCreateStatic(p_task->function, p_task->name, p_task->stack_size, p_task->pvParameters, p_task->priority,
@@ -177,33 +296,181 @@ void init_task_pointer(pvdx_task_t *const p_task) {
 }
 
 /**
- * \fn exec_command_task_manager
+ * \fn task_manager_restart_task
  *
- * \brief Executes function corresponding to the command
+ * \brief Deletes a task that stopped checking in with the watchdog and re-creates it from its `pvdx_task_t` descriptor,
+ *        so that one hung task does not cost a reboot of the whole system. Commands still queued for the task are
+ *        completed with `ERROR_TASK_RESTARTED`, its queues start out empty, and it is registered with the watchdog again.
  *
- * \param p_cmd a pointer to a command forwarded to the task manager
+ * \param p_task constant task pointer corresponding to the task to be restarted
+ *
+ * \returns `status_t`, SUCCESS if the task was restarted, or ERROR_PROCESSING_FAILED if only a reboot can recover it:
+ *          OS tasks, tasks holding the task list mutex, and tasks restarted `TASK_MANAGER_MAX_RESTARTS` times within
+ *          `TASK_MANAGER_RESTART_WINDOW_MS` are not restarted
+ *
+ * \warning must not be called by the task being restarted
+ * \warning acquires the task list mutex
+ * \warning modifies a task struct
+ *
+ * \note Called directly by the watchdog, since the task manager itself may be the task that stopped
  */
-void exec_command_task_manager(command_t *const p_cmd) {
-    if (p_cmd->target != p_task_manager_task) {
-        fatal("task manager: command target is not task manager! target: %d operation: %d\n", p_cmd->target, p_cmd->operation);
-    }
-
-    switch (p_cmd->operation) {
-        case OPERATION_INIT_SUBTASKS:
-            task_manager_init_subtasks();
-            p_cmd->result = SUCCESS;
-            break;
-        case OPERATION_ENABLE_SUBTASK:
-            task_manager_enable_task(p_cmd->data.pvdx_task); // Turn this into an index
-            p_cmd->result = SUCCESS;
-            break;
-        case OPERATION_DISABLE_SUBTASK:
-            task_manager_disable_task(p_cmd->data.pvdx_task); // Turn this into an index
-            p_cmd->result = SUCCESS;
-            break;
-        default:
-            fatal("task-manager: Invalid operation!\n");
-            p_cmd->result = ERROR_SANITY_CHECK_FAILED; // TODO: appropriate status?
-            break;
+status_t task_manager_restart_task(pvdx_task_t *const p_task) {
+    const uint32_t start_cycles = get_cycle_count();
+
+    // OS tasks own system-wide state (the task list, other tasks' commands, the hardware watchdog)
+    if (p_task->task_type == OS || p_task->handle == NULL || !p_task->enabled) {
+        return ERROR_PROCESSING_FAILED;
     }
+
+    // A task deleted while holding the task list mutex would never give it back
+    if (xSemaphoreGetMutexHolder(task_list_mutex) == p_task->handle ||
+        xSemaphoreTake(task_list_mutex, pdMS_TO_TICKS(TASK_MANAGER_RESTART_LOCK_MS)) != pdTRUE) {
+        return ERROR_PROCESSING_FAILED;
+    }
+
+    // Escalate to a reboot if restarting has not helped
+    const TickType_t now_ticks = xTaskGetTickCount();
+    if (restart_windows[p_task->task_index].restarts == 0 ||
+        now_ticks - restart_windows[p_task->task_index].window_start_ticks > pdMS_TO_TICKS(TASK_MANAGER_RESTART_WINDOW_MS)) {
+        restart_windows[p_task->task_index].window_start_ticks = now_ticks;
+        restart_windows[p_task->task_index].restarts = 0;
+    }
+    if (restart_windows[p_task->task_index].restarts >= TASK_MANAGER_MAX_RESTARTS) {
+        unlock_mutex(task_list_mutex);
+        return ERROR_PROCESSING_FAILED;
+    }
+    restart_windows[p_task->task_index].restarts++;
+
+    // No other task may run (and send the task commands, or check in for it) until it exists again. The old task is
+    // deleted before it is unregistered, so it can't check in unregistered, and the new one is registered before it
+    // can run. Deleting another task frees nothing here, since its stack and TCB are statically allocated and can be
+    // reused straight away.
+    vTaskSuspendAll();
+    stop_deferred_logging(p_task->handle);
+    vTaskDelete(p_task->handle);
+    unregister_task_with_watchdog(p_task);
+    const size_t flushed = flush_commands(p_task, ERROR_TASK_RESTARTED);
+    p_task->handle = xTaskCreateStatic(p_task->function, p_task->name, p_task->stack_size, p_task->pvParameters, p_task->priority,
+                                       p_task->stack_buffer, p_task->task_tcb);
+    vTaskSetThreadLocalStoragePointer(p_task->handle, 0, (void *)p_task);
+    register_task_with_watchdog(p_task);
+    xTaskResumeAll();
+
+    unlock_mutex(task_list_mutex);
+
+    const uint32_t restart_us = cycles_to_us(get_cycle_count() - start_cycles);
+    taskENTER_CRITICAL();
+    restart_stats.restarts++;
+    restart_stats.last_restart_us = restart_us;
+    if (restart_us > restart_stats.max_restart_us) {
+        restart_stats.max_restart_us = restart_us;
+    }
+    taskEXIT_CRITICAL();
+
+    (void)flushed; // Only logged, and warnings compile out in release builds
+    warning("task_manager: Restarted %s task in %d us (%d commands discarded, restart %d of %d); a reboot takes at least %d us "
+            "plus the reset and bootloader\n",
+            p_task->name, restart_us, flushed, restart_windows[p_task->task_index].restarts, TASK_MANAGER_MAX_RESTARTS,
+            restart_stats.min_boot_us);
+    return SUCCESS;
+}
+
+/**
+ * \fn get_task_restart_stats
+ *
+ * \returns `task_restart_stats_t`, a copy of the task restart statistics
+ */
+task_restart_stats_t get_task_restart_stats(void) {
+    taskENTER_CRITICAL();
+    const task_restart_stats_t stats = restart_stats;
+    taskEXIT_CRITICAL();
+    return stats;
+}
+
+/**
+ * \fn get_set_mode_command
+ *
+ * \brief Gets the task manager command that moves the system into a satellite mode
+ *
+ * \param p_profile the mode profile to apply (one of `mode_profiles`, which outlive the command)
+ *
+ * \returns `command_t`, the command to set the mode
+ */
+command_t get_set_mode_command(const mode_profile_t *const p_profile) {
+    command_t cmd = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_SET_MODE,
+        .data.mode_profile = p_profile,
+        .data_type = CMD_DATA_MODE_PROFILE,
+        .result = PROCESSING,
+    };
+    return cmd;
+}
+
+/**
+ * \fn get_current_mode
+ *
+ * \returns `const mode_profile_t *`, the profile applied by the latest mode transition, or NULL if there has been none
+ */
+const mode_profile_t *get_current_mode(void) {
+    return current_mode;
+}
+
+/**
+ * \fn get_mode_transition_stats
+ *
+ * \returns `mode_transition_stats_t`, a copy of the mode transition latency statistics
+ */
+mode_transition_stats_t get_mode_transition_stats(void) {
+    taskENTER_CRITICAL();
+    const mode_transition_stats_t stats = mode_transition_stats;
+    taskEXIT_CRITICAL();
+    return stats;
+}
+
+/**
+ * \fn exec_command_task_manager_init_subtasks
+ *
+ * \brief Executes an `OPERATION_INIT_SUBTASKS` command (routed by `exec_command()`)
+ *
+ * \param p_cmd a pointer to a command forwarded to the task manager
+ */
+void exec_command_task_manager_init_subtasks(command_t *const p_cmd) {
+    task_manager_init_subtasks();
+    p_cmd->result = SUCCESS;
+}
+
+/**
+ * \fn exec_command_task_manager_enable_subtask
+ *
+ * \brief Executes an `OPERATION_ENABLE_SUBTASK` command (routed by `exec_command()`)
+ *
+ * \param p_cmd a pointer to a command forwarded to the task manager whose `data.pvdx_task` is the task to enable
+ */
+void exec_command_task_manager_enable_subtask(command_t *const p_cmd) {
+    task_manager_enable_task(p_cmd->data.pvdx_task); // Turn this into an index
+    p_cmd->result = SUCCESS;
+}
+
+/**
+ * \fn exec_command_task_manager_disable_subtask
+ *
+ * \brief Executes an `OPERATION_DISABLE_SUBTASK` command (routed by `exec_command()`)
+ *
+ * \param p_cmd a pointer to a command forwarded to the task manager whose `data.pvdx_task` is the task to disable
+ */
+void exec_command_task_manager_disable_subtask(command_t *const p_cmd) {
+    task_manager_disable_task(p_cmd->data.pvdx_task); // Turn this into an index
+    p_cmd->result = SUCCESS;
+}
+
+/**
+ * \fn exec_command_task_manager_set_mode
+ *
+ * \brief Executes an `OPERATION_SET_MODE` command (routed by `exec_command()`)
+ *
+ * \param p_cmd a pointer to a command forwarded to the task manager whose `data.mode_profile` is the mode to enter
+ */
+void exec_command_task_manager_set_mode(command_t *const p_cmd) {
+    p_cmd->result = task_manager_set_mode(p_cmd->data.mode_profile);
 }
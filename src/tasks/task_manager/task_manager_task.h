@@ -7,12 +7,16 @@
 #include <driver_init.h>
 #include "globals.h"
 #include "logging.h"
+#include "mode_profiles.h"
 #include "mutexes.h"
 #include "task_list.h"
 
 // Constants
-#define TASK_MANAGER_TASK_STACK_SIZE 1024 // Size of the stack in words (multiply by 4 to get bytes)
-#define TASK_MANAGER_QUEUE_WAIT_MS 1000   // Wait time for sending/receiving a command to/from the queue (in ms)
+#define TASK_MANAGER_TASK_STACK_SIZE 1024         // Size of the stack in words (multiply by 4 to get bytes)
+#define TASK_MANAGER_QUEUE_WAIT_MS 1000           // Wait time for sending/receiving a command to/from the queue (in ms)
+#define TASK_MANAGER_MAX_RESTARTS 3               // Restarts of one task within the window before the system is reset instead
+#define TASK_MANAGER_RESTART_WINDOW_MS (600000UL) // Window over which a task's restarts are counted (in ms)
+#define TASK_MANAGER_RESTART_LOCK_MS 100          // Longest a restart waits for the task list mutex before giving up (in ms)
 
 // Placed in a struct to ensure that the TCB is placed higher than the stack in memory
 //^ This ensures that stack overflows do not corrupt the TCB (since the stack grows downwards)
@@ -21,9 +25,29 @@ typedef struct {
     StackType_t task_manager_task_stack[TASK_MANAGER_TASK_STACK_SIZE];
     uint8_t task_manager_command_queue_buffer[COMMAND_QUEUE_MAX_COMMANDS * COMMAND_QUEUE_ITEM_SIZE];
     StaticQueue_t task_manager_task_queue;
+    command_queue_set_memory_t task_manager_queue_set_mem;
     StaticTask_t task_manager_task_tcb;
 } task_manager_task_memory_t;
 
+// Recovery times of `task_manager_restart_task()`, kept to compare restarting one task with rebooting the system
+typedef struct {
+    uint32_t restarts;        // Number of task restarts since boot
+    uint32_t last_restart_us; // Time taken by the most recent restart
+    uint32_t max_restart_us;  // Longest restart
+    uint32_t min_boot_us;     // Lower bound on the cost of a reboot: time from starting the cycle counter in `PVDX_init()`
+                              // until all subtasks were initialized. The hardware reset, the bootloader's copy of the
+                              // image and the clock setup before `PVDX_init()` are not included.
+} task_restart_stats_t;
+
+// Latency of `task_manager_set_mode()` transitions
+typedef struct {
+    uint32_t transitions;        // Number of mode transitions applied
+    uint32_t last_tasks_changed; // Tasks enabled, disabled or given new settings by the latest transition
+    uint32_t last_transition_us; // Duration of the latest transition, including waiting for the task list mutex
+    uint32_t last_suspended_us;  // Time the scheduler was suspended during the latest transition
+    uint32_t max_transition_us;  // Longest transition
+} mode_transition_stats_t;
+
 // Global memory for the task manager task
 extern task_manager_task_memory_t task_manager_mem;
 // Mutex related variables
@@ -33,9 +57,18 @@ extern StaticSemaphore_t task_list_mutex_buffer;
 void init_task_pointer(pvdx_task_t *const p_task);
 QueueHandle_t init_task_manager(void);
 void main_task_manager(void *pvParameters);
-void exec_command_task_manager(command_t *const p_cmd);
+void exec_command_task_manager_init_subtasks(command_t *const p_cmd);
+void exec_command_task_manager_enable_subtask(command_t *const p_cmd);
+void exec_command_task_manager_disable_subtask(command_t *const p_cmd);
+void exec_command_task_manager_set_mode(command_t *const p_cmd);
 void task_manager_init_subtasks(void);
 void task_manager_enable_task(pvdx_task_t *const task);
 void task_manager_disable_task(pvdx_task_t *const task);
+status_t task_manager_restart_task(pvdx_task_t *const p_task);
+task_restart_stats_t get_task_restart_stats(void);
+status_t task_manager_set_mode(const mode_profile_t *const p_profile);
+command_t get_set_mode_command(const mode_profile_t *const p_profile);
+const mode_profile_t *get_current_mode(void);
+mode_transition_stats_t get_mode_transition_stats(void);
 
 #endif // TASK_MANAGER_TASK_H
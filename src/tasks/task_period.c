@@ -0,0 +1,192 @@
+/**
+ * task_period.c
+ *
+ * Fixed-rate release of periodic tasks (those with a non-zero `period_ms`). A periodic task runs one job per period
+ * and calls `wait_for_next_release()` when the job is done; the task keeps executing commands until its next release
+ * is due and is then released by `vTaskDelayUntil()`, so releases stay on a fixed schedule no matter how long each
+ * job or command takes.
+ *
+ * A job still running when its next release is due is counted as an overrun. Releases that have already been missed
+ * entirely are dropped (and counted) rather than run back-to-back, so a control loop is never handed a burst of
+ * stale periods. Release jitter is measured with the DWT cycle counter as the difference between each
+ * release-to-release interval and its nominal length.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "task_period.h"
+
+#include <string.h>
+
+#include "command_dispatcher_task.h"
+#include "cycle_counter.h"
+#include "logging.h"
+#include "task_list.h"
+
+/**
+ * \fn start_task_period
+ *
+ * \brief Anchors a periodic task's schedule at the current tick, so that its first job is released immediately. Must
+ *        be called by the task before its main loop (and thus again whenever the task is restarted).
+ *
+ * \param p_task a pointer to the calling task
+ */
+void start_task_period(pvdx_task_t *const p_task) {
+    taskENTER_CRITICAL();
+    p_task->period_stats.last_release_ticks = xTaskGetTickCount();
+    p_task->period_stats.last_release_cycles = get_cycle_count();
+    p_task->period_stats.releases++;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * \fn wait_for_next_release
+ *
+ * \brief Ends the calling task's current job, executes commands until its next release is due and then waits for
+ *        that release with `vTaskDelayUntil()`. Records overruns, dropped releases and release jitter.
+ *
+ * \param p_task a pointer to the calling task; must be periodic and have called `start_task_period()`
+ *
+ * \note Releases missed while the task was suspended (e.g. by a mode change) are counted as skipped releases
+ */
+void wait_for_next_release(pvdx_task_t *const p_task) {
+    task_period_stats_t *const p_stats = &p_task->period_stats;
+    const TickType_t period_ticks = pdMS_TO_TICKS(p_task->period_ms);
+    configASSERT(period_ticks > 0);
+
+    const uint32_t execution_us = cycles_to_us(get_cycle_count() - p_stats->last_release_cycles);
+    const bool overrun = (TickType_t)(xTaskGetTickCount() - p_stats->last_release_ticks) >= period_ticks;
+
+    // Execute commands until the next release is due; a wakeup without a command just goes back to waiting
+    if (p_task->command_queue != NULL) {
+        command_t cmd;
+        TickType_t remaining_ticks;
+        while ((remaining_ticks = ticks_until(p_stats->last_release_ticks + period_ticks)) > 0) {
+            if (receive_command(p_task, &cmd, remaining_ticks)) {
+                exec_command(&cmd);
+                complete_command(&cmd);
+            }
+        }
+    }
+
+    // If whole periods have already gone by, drop all but the latest of their releases so that the schedule is caught
+    // up in one step (`vTaskDelayUntil()` would otherwise return immediately once for every missed period)
+    TickType_t release_ticks = p_stats->last_release_ticks;
+    uint32_t skipped = (uint32_t)((TickType_t)(xTaskGetTickCount() - release_ticks) / period_ticks);
+    skipped = skipped > 1 ? skipped - 1 : 0;
+    release_ticks += (TickType_t)(skipped * period_ticks);
+
+    vTaskDelayUntil(&release_ticks, period_ticks);
+
+    // The task may have been suspended while it waited, in which case its release is already a period or more late
+    const uint32_t late_periods = (uint32_t)((TickType_t)(xTaskGetTickCount() - release_ticks) / period_ticks);
+    release_ticks += (TickType_t)(late_periods * period_ticks);
+    skipped += late_periods;
+    const uint32_t release_cycles = get_cycle_count();
+
+    taskENTER_CRITICAL();
+    // Jitter is only measured between consecutive releases (the cycle counter may have wrapped across a gap)
+    if (skipped == 0 && p_task->period_ms <= TASK_PERIOD_MAX_JITTER_PERIOD_MS) {
+        const uint32_t interval_us = cycles_to_us(release_cycles - p_stats->last_release_cycles);
+        const uint32_t nominal_us = p_task->period_ms * 1000;
+        const uint32_t jitter_us = interval_us > nominal_us ? interval_us - nominal_us : nominal_us - interval_us;
+        p_stats->jitter_samples++;
+        p_stats->total_jitter_us += jitter_us;
+        if (jitter_us > p_stats->max_jitter_us) {
+            p_stats->max_jitter_us = jitter_us;
+        }
+    }
+    if (execution_us > p_stats->max_execution_us) {
+        p_stats->max_execution_us = execution_us;
+    }
+    p_stats->overruns += overrun ? 1 : 0;
+    p_stats->skipped_releases += skipped;
+    p_stats->releases++;
+    p_stats->last_release_ticks = release_ticks;
+    p_stats->last_release_cycles = release_cycles;
+    taskEXIT_CRITICAL();
+
+    if (overrun) {
+        warning("%s: job overran its %u ms period (%u us), %u releases dropped\n", p_task->name, p_task->period_ms, execution_us,
+                skipped);
+    }
+}
+
+/**
+ * \fn get_task_period_stats
+ *
+ * \param p_task a pointer to the task
+ *
+ * \returns `task_period_stats_t`, a consistent snapshot of the task's release statistics
+ */
+task_period_stats_t get_task_period_stats(pvdx_task_t *const p_task) {
+    taskENTER_CRITICAL();
+    const task_period_stats_t snapshot = p_task->period_stats;
+    taskEXIT_CRITICAL();
+    return snapshot;
+}
+
+/**
+ * \fn reset_task_period_stats
+ *
+ * \brief Clears the release statistics of every periodic task, keeping their schedules
+ */
+void reset_task_period_stats(void) {
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        task_period_stats_t *const p_stats = &task_list[i]->period_stats;
+        taskENTER_CRITICAL();
+        const TickType_t last_release_ticks = p_stats->last_release_ticks;
+        const uint32_t last_release_cycles = p_stats->last_release_cycles;
+        memset(p_stats, 0, sizeof(task_period_stats_t));
+        p_stats->last_release_ticks = last_release_ticks;
+        p_stats->last_release_cycles = last_release_cycles;
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * \fn get_task_period_record
+ *
+ * \brief Condenses a task's release statistics into a packed telemetry record
+ *
+ * \param p_task a pointer to the task
+ *
+ * \returns `task_period_record_t`, the record
+ */
+task_period_record_t get_task_period_record(pvdx_task_t *const p_task) {
+    task_period_record_t record = {.task_index = (uint8_t)p_task->task_index};
+    if (p_task->period_ms == 0) {
+        return record;
+    }
+
+    const task_period_stats_t stats = get_task_period_stats(p_task);
+    record.period_ms = p_task->period_ms;
+    record.releases = stats.releases;
+    record.overruns = stats.overruns;
+    record.skipped_releases = stats.skipped_releases;
+    record.max_jitter_us = stats.max_jitter_us;
+    record.mean_jitter_us = stats.jitter_samples ? (uint32_t)(stats.total_jitter_us / stats.jitter_samples) : 0;
+    record.max_execution_us = stats.max_execution_us;
+    return record;
+}
+
+/**
+ * \fn task_period_serialize
+ *
+ * \brief Writes one `task_period_record_t` per task, in task list order, for downlink
+ *
+ * \param p_buffer Buffer to write the records into
+ * \param buffer_size Size of `p_buffer` in bytes
+ *
+ * \returns `size_t`, the number of bytes written (only whole records are written)
+ */
+size_t task_period_serialize(uint8_t *const p_buffer, size_t buffer_size) {
+    size_t offset = 0;
+    for (size_t i = 0; task_list[i] != NULL && offset + sizeof(task_period_record_t) <= buffer_size; i++) {
+        const task_period_record_t record = get_task_period_record(task_list[i]);
+        memcpy(&p_buffer[offset], &record, sizeof(record));
+        offset += sizeof(record);
+    }
+    return offset;
+}
@@ -0,0 +1,32 @@
+#ifndef TASK_PERIOD_H
+#define TASK_PERIOD_H
+
+// Includes
+#include "globals.h"
+
+// Constants
+#define TASK_PERIOD_MAX_JITTER_PERIOD_MS 30000 // Longest period whose jitter is measured (the cycle counter wraps after ~35 s)
+
+// Packed telemetry record of one periodic task's release statistics (see `task_period_serialize()`)
+typedef struct __attribute__((packed)) {
+    uint8_t task_index;
+    uint8_t reserved[3];
+    uint32_t period_ms; // 0 for event-driven tasks (all other fields are then 0 too)
+    uint32_t releases;
+    uint32_t overruns;
+    uint32_t skipped_releases;
+    uint32_t max_jitter_us;
+    uint32_t mean_jitter_us;
+    uint32_t max_execution_us;
+} task_period_record_t;
+
+_Static_assert(sizeof(task_period_record_t) == 32, "task_period_record_t is a fixed telemetry layout");
+
+void start_task_period(pvdx_task_t *const p_task);
+void wait_for_next_release(pvdx_task_t *const p_task);
+task_period_stats_t get_task_period_stats(pvdx_task_t *const p_task);
+void reset_task_period_stats(void);
+task_period_record_t get_task_period_record(pvdx_task_t *const p_task);
+size_t task_period_serialize(uint8_t *const p_buffer, size_t buffer_size);
+
+#endif // TASK_PERIOD_H
@@ -2,18 +2,116 @@
  * watchdog_main.c
  *
  * Main loop of the Watchdog RTOS task. This task is responsible for monitoring the check-ins of other tasks
- * and resetting the system if a task fails to check in within the allowed time.
+ * and restarting a task (or resetting the system) if it fails to check in within the allowed time.
  *
  * Created: January 28, 2024
  * Authors: Oren Kohavi, Tanish Makadia, Siddharta Laloux
  */
 
+#include <string.h>
+
+#include "stack_usage.h"
 #include "tasks/command_dispatcher/command_dispatcher_task.h"
 #include "watchdog_task.h"
 
 watchdog_task_memory_t watchdog_mem;
 QueueHandle_t watchdog_command_queue_handle;
 
+// Deadlines of every registered task, earliest first (see `watchdog_deadline_t`)
+static watchdog_deadline_t deadlines[NUM_TASKS];
+static size_t num_deadlines = 0;
+
+/**
+ * \fn insert_deadline
+ *
+ * \brief Inserts a task's deadline into `deadlines`, keeping the list sorted earliest first. Safe across tick counter
+ *        overflow, since deadlines are never more than half the tick range apart.
+ *
+ * \param p_task the registered task
+ * \param last_checkin_time_ticks the task's latest checkin time
+ */
+static void insert_deadline(pvdx_task_t *const p_task, TickType_t last_checkin_time_ticks) {
+    // The first tick at which `ticks_since_last_checkin > timeout` holds
+    const TickType_t deadline_ticks = last_checkin_time_ticks + pdMS_TO_TICKS(p_task->watchdog_timeout_ms) + 1;
+
+    size_t i = num_deadlines;
+    while (i > 0 && (int32_t)(deadline_ticks - deadlines[i - 1].deadline_ticks) < 0) {
+        deadlines[i] = deadlines[i - 1];
+        i--;
+    }
+    deadlines[i] = (watchdog_deadline_t){.deadline_ticks = deadline_ticks, .p_task = p_task};
+    num_deadlines++;
+}
+
+/**
+ * \fn rebuild_deadlines
+ *
+ * \brief Refills `deadlines` from the task list. Only needed when a task registers or unregisters; checkins move
+ *        deadlines forward without the watchdog having to look at them (see `check_deadlines()`).
+ */
+static void rebuild_deadlines(void) {
+    num_deadlines = 0;
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        if (!__atomic_load_n(&task_list[i]->has_registered, __ATOMIC_ACQUIRE)) {
+            debug("watchdog: Task %d has not registered, skipping it ...\n", i);
+            continue;
+        }
+        const uint32_t last_checkin_time_ticks = __atomic_load_n(&task_list[i]->last_checkin_time_ticks, __ATOMIC_ACQUIRE);
+        if (last_checkin_time_ticks != WATCHDOG_CHECKIN_UNREGISTERED) {
+            insert_deadline(task_list[i], last_checkin_time_ticks);
+        }
+    }
+}
+
+/**
+ * \fn check_deadlines
+ *
+ * \brief Checks every task whose deadline has passed. Tasks that checked in since their deadline was computed get a new
+ *        deadline; a task that has not checked in within the allowed time is restarted, or resets the system if it
+ *        cannot be (see `task_manager_restart_task()`). Checkin times are stored atomically (see
+ *        `checkin_with_watchdog()`), so only a restart locks the task list.
+ *
+ * \param current_time_ticks the current tick count
+ */
+static void check_deadlines(TickType_t current_time_ticks) {
+    while (num_deadlines > 0 && (int32_t)(deadlines[0].deadline_ticks - current_time_ticks) <= 0) {
+        pvdx_task_t *const p_task = deadlines[0].p_task;
+        num_deadlines--;
+        memmove(&deadlines[0], &deadlines[1], num_deadlines * sizeof(watchdog_deadline_t));
+
+        if (!__atomic_load_n(&p_task->has_registered, __ATOMIC_ACQUIRE)) {
+            continue; // Unregistered; the list is rebuilt without it on the next pass
+        }
+        const uint32_t last_checkin_time_ticks = __atomic_load_n(&p_task->last_checkin_time_ticks, __ATOMIC_ACQUIRE);
+        if (last_checkin_time_ticks == WATCHDOG_CHECKIN_UNREGISTERED) {
+            continue; // Unregistered since the flag was read
+        }
+        const uint32_t ticks_since_last_checkin = current_time_ticks - last_checkin_time_ticks;
+
+        if (ticks_since_last_checkin > pdMS_TO_TICKS(p_task->watchdog_timeout_ms)) {
+            warning("watchdog: %s task has not checked in within the allowed time! (time since last checkin: %d, allowed time: %d).\n",
+                    p_task->name, ticks_since_last_checkin, p_task->watchdog_timeout_ms);
+
+            // Restarting just the task is much faster than a reboot; the task manager escalates when it cannot help
+            if (task_manager_restart_task(p_task) != SUCCESS) {
+                fatal("watchdog: %s task could not be restarted, resetting the system\n", p_task->name);
+            }
+            insert_deadline(p_task, __atomic_load_n(&p_task->last_checkin_time_ticks, __ATOMIC_ACQUIRE));
+            continue;
+        }
+        insert_deadline(p_task, last_checkin_time_ticks);
+    }
+}
+
+/**
+ * \fn earliest_tick
+ *
+ * \returns `TickType_t`, whichever of two absolute tick counts comes first
+ */
+static inline TickType_t earliest_tick(TickType_t a_ticks, TickType_t b_ticks) {
+    return (int32_t)(a_ticks - b_ticks) < 0 ? a_ticks : b_ticks;
+}
+
 /**
  * \fn main_watchdog
  *
@@ -27,56 +125,54 @@ void main_watchdog(void *pvParameters) {
 
     // Obtain a pointer to the current task within the global task list
     pvdx_task_t *const current_task = get_current_task();
-    // Cache the watchdog checkin command to avoid creating it every iteration
-    command_t cmd_checkin = get_watchdog_checkin_command(current_task);
     // Calculate the maximum time the task should block (and thus be unable to check in with the watchdog)
     const TickType_t queue_block_time_ticks = get_command_queue_block_time_ticks(current_task);
+    // Absolute tick counts at which the hardware watchdog must next be petted and the next self-checkin is due (both due
+    // on startup)
+    TickType_t next_pet_ticks = xTaskGetTickCount();
+    TickType_t next_checkin_ticks = next_pet_ticks;
+    // Registration generation `deadlines` was built for (differs on startup, so that the list is built on the first pass)
+    uint32_t deadlines_generation = get_watchdog_registration_generation() - 1;
     // Varible to hold commands popped off the queue
     command_t cmd;
     while (true) {
-        debug("\n---------- Watchdog Task Loop ----------\n");
-
-        // Iterate through the running times and check if any tasks have not checked in within the allowed time
-        const uint32_t current_time_ticks = xTaskGetTickCount();
-
-        lock_mutex(task_list_mutex);
-
-        for (size_t i = 0; task_list[i] != NULL; i++) {
-            if (task_list[i]->has_registered) {
-                const uint32_t ticks_since_last_checkin = current_time_ticks - task_list[i]->last_checkin_time_ticks;
-
-                if (ticks_since_last_checkin > pdMS_TO_TICKS(task_list[i]->watchdog_timeout_ms)) {
-                    // The task has not checked in within the allowed time, so we should reset the system
-                    fatal(
-                        "watchdog: %s task has not checked in within the allowed time! (time since last checkin: %d, allowed time: %d).\n",
-                        task_list[i]->name, ticks_since_last_checkin, task_list[i]->watchdog_timeout_ms);
-                }
-            } else {
-                debug("watchdog: Task %d has not registered, skipping it ...\n", i);
-            }
+        // Sleep until a command arrives, the earliest task deadline passes, the watchdog must be petted or checked in, or
+        // another task wakes us (e.g. after a task registers); there is no fixed polling delay
+        TickType_t next_wakeup_ticks = earliest_tick(next_pet_ticks, next_checkin_ticks);
+        if (num_deadlines > 0) {
+            next_wakeup_ticks = earliest_tick(next_wakeup_ticks, deadlines[0].deadline_ticks);
+        }
+        if (receive_command(current_task, &cmd, ticks_until(next_wakeup_ticks))) {
+            debug("watchdog: Command popped off queue. Target: %d, Operation: %d\n", cmd.target, cmd.operation);
+            exec_command(&cmd);
+            complete_command(&cmd);
         }
 
-        unlock_mutex(task_list_mutex);
-
-        // Execute all commands contained in the queue
-        if (xQueueReceive(watchdog_command_queue_handle, &cmd, queue_block_time_ticks) == pdPASS) {
-            do {
-                debug("watchdog: Command popped off queue. Target: %d, Operation: %d\n", cmd.target, cmd.operation);
-                exec_command_watchdog(&cmd);
-            } while (xQueueReceive(watchdog_command_queue_handle, &cmd, 0) == pdPASS);
+        const uint32_t generation = get_watchdog_registration_generation();
+        if (generation != deadlines_generation) {
+            deadlines_generation = generation;
+            rebuild_deadlines();
         }
-        debug("watchdog: No more commands queued.\n");
+
+        // Only the tasks whose deadlines have passed are looked at
+        check_deadlines(xTaskGetTickCount());
 
         // if we get here, then all tasks have checked in within the allowed time
-        pet_watchdog();
+        if (ticks_until(next_pet_ticks) == 0) {
+            debug("\n---------- Watchdog Task Loop ----------\n");
+            pet_watchdog();
+            // Stack high-water marks only need sampling occasionally, so they ride along with the pet
+            stack_usage_sample();
+            next_pet_ticks = xTaskGetTickCount() + pdMS_TO_TICKS(WATCHDOG_MS_DELAY);
+        }
 
         // Watchdog Task must also check-in with itself
-        if (should_checkin(current_task)) {
-            enqueue_command(&cmd_checkin);
-            debug("watchdog: Enqueued watchdog checkin command\n");
+        if (ticks_until(next_checkin_ticks) == 0) {
+            if (should_checkin(current_task)) {
+                checkin_with_watchdog(current_task);
+                debug("watchdog: Checked in with itself\n");
+            }
+            next_checkin_ticks = xTaskGetTickCount() + queue_block_time_ticks;
         }
-
-        // Guarantee other tasks get time to run
-        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
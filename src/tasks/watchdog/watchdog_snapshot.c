@@ -0,0 +1,191 @@
+/**
+ * watchdog_snapshot.c
+ *
+ * Pre-reset state snapshot taken by the hardware watchdog's early-warning interrupt. The interrupt copies each task's
+ * check-in time, state, stack high-water mark and command queue depths into backup RAM, which is retained across the
+ * watchdog reset that follows, and returns immediately. The next boot decodes the snapshot to report which task
+ * starved the watchdog.
+ *
+ * Everything here runs in the interrupt, above `configMAX_SYSCALL_INTERRUPT_PRIORITY`, so only plain reads of kernel
+ * state are used (no critical sections or FreeRTOS API calls that may assert or block). The time taken is bounded by
+ * the number of tasks and the size of their stacks.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "watchdog_snapshot.h"
+
+#include "atmel_start.h"
+#include "logging.h"
+#include "queue.h"
+#include "task_list.h"
+
+// Lives in backup RAM (after the bootloader's reserved bytes, see src_ram.ld) and is never zeroed at startup
+__attribute__((section(".bkupram"))) static volatile watchdog_snapshot_t watchdog_snapshot;
+
+// The value FreeRTOS fills new task stacks with (see `tskSTACK_FILL_BYTE` in tasks.c)
+#define WATCHDOG_SNAPSHOT_STACK_FILL_BYTE 0xA5U
+
+/**
+ * \fn stack_high_water_mark
+ *
+ * \brief Counts the words at the far end of a task's stack that still hold the fill pattern, like
+ *        `uxTaskGetStackHighWaterMark()` but without going through the kernel
+ *
+ * \param p_task the task whose stack to inspect
+ *
+ * \returns `uint16_t`, the number of words never used (saturated)
+ */
+static uint16_t stack_high_water_mark(const pvdx_task_t *const p_task) {
+    const uint8_t *const p_stack = (const uint8_t *)p_task->stack_buffer;
+    const size_t stack_bytes = p_task->stack_size * sizeof(StackType_t);
+
+    size_t unused_bytes = 0;
+    while (unused_bytes < stack_bytes && p_stack[unused_bytes] == WATCHDOG_SNAPSHOT_STACK_FILL_BYTE) {
+        unused_bytes++;
+    }
+    const size_t unused_words = unused_bytes / sizeof(StackType_t);
+    return unused_words > UINT16_MAX ? UINT16_MAX : (uint16_t)unused_words;
+}
+
+/**
+ * \fn queue_depth
+ *
+ * \returns `uint8_t`, the number of commands waiting in a queue (0 if it does not exist)
+ */
+static inline uint8_t queue_depth(QueueHandle_t queue) {
+    return queue != NULL ? (uint8_t)uxQueueMessagesWaitingFromISR(queue) : 0;
+}
+
+/**
+ * \fn watchdog_take_snapshot
+ *
+ * \brief Records the state of every task in backup RAM. Called from the watchdog early-warning interrupt.
+ *
+ * \warning Must stay bounded in time and must not call FreeRTOS functions that use critical sections
+ */
+void watchdog_take_snapshot(void) {
+    const TaskHandle_t running_task = xTaskGetCurrentTaskHandle();
+
+    watchdog_snapshot.magic = 0; // Invalidate any older snapshot while this one is written
+    watchdog_snapshot.tick_count = xTaskGetTickCount();
+    watchdog_snapshot.running_task_index = WATCHDOG_SNAPSHOT_NO_TASK;
+    watchdog_snapshot.reserved = 0;
+
+    size_t num_tasks = 0;
+    for (; task_list[num_tasks] != NULL && num_tasks < NUM_TASKS; num_tasks++) {
+        const pvdx_task_t *const p_task = task_list[num_tasks];
+        volatile watchdog_snapshot_task_t *const p_entry = &watchdog_snapshot.tasks[num_tasks];
+
+        size_t c = 0;
+        for (; c < WATCHDOG_SNAPSHOT_NAME_LENGTH && p_task->name[c] != '\0'; c++) {
+            p_entry->name[c] = p_task->name[c];
+        }
+        for (; c < WATCHDOG_SNAPSHOT_NAME_LENGTH; c++) {
+            p_entry->name[c] = '\0';
+        }
+
+        watchdog_snapshot_task_state_t state = WATCHDOG_SNAPSHOT_TASK_NOT_CREATED;
+        if (p_task->handle != NULL && p_task->handle == running_task) {
+            state = WATCHDOG_SNAPSHOT_TASK_RUNNING;
+            watchdog_snapshot.running_task_index = (uint8_t)num_tasks;
+        } else if (p_task->handle != NULL) {
+            state = p_task->enabled ? WATCHDOG_SNAPSHOT_TASK_ENABLED : WATCHDOG_SNAPSHOT_TASK_DISABLED;
+        }
+
+        p_entry->last_checkin_time_ticks = p_task->last_checkin_time_ticks;
+        p_entry->watchdog_timeout_ms = p_task->watchdog_timeout_ms;
+        p_entry->stack_high_water_mark = p_task->handle != NULL ? stack_high_water_mark(p_task) : 0;
+        p_entry->state = (uint8_t)state;
+        p_entry->has_registered = p_task->has_registered;
+        p_entry->urgent_queue_depth = queue_depth(p_task->urgent_command_queue);
+        p_entry->normal_queue_depth = queue_depth(p_task->command_queue);
+        p_entry->reserved = 0;
+    }
+    watchdog_snapshot.num_tasks = (uint8_t)num_tasks;
+
+    __DMB(); // Every field must be in backup RAM before the snapshot is marked complete
+    watchdog_snapshot.magic = WATCHDOG_SNAPSHOT_MAGIC;
+}
+
+/**
+ * \fn watchdog_discard_snapshot
+ *
+ * \brief Invalidates the snapshot once the watchdog has been petted again, so that an early warning the system
+ *        recovered from is not blamed for a later, unrelated reset
+ */
+void watchdog_discard_snapshot(void) {
+    if (watchdog_snapshot.magic == WATCHDOG_SNAPSHOT_MAGIC) {
+        watchdog_snapshot.magic = 0;
+        info("watchdog: Recovered from an early warning\n");
+    }
+}
+
+/**
+ * \fn snapshot_task_name
+ *
+ * \brief Copies the (possibly truncated) name of a task in the snapshot into a NUL-terminated string
+ */
+static void snapshot_task_name(size_t index, char p_name[WATCHDOG_SNAPSHOT_NAME_LENGTH + 1]) {
+    for (size_t c = 0; c < WATCHDOG_SNAPSHOT_NAME_LENGTH; c++) {
+        p_name[c] = watchdog_snapshot.tasks[index].name[c];
+    }
+    p_name[WATCHDOG_SNAPSHOT_NAME_LENGTH] = '\0';
+}
+
+/**
+ * \fn watchdog_report_snapshot
+ *
+ * \brief Decodes the snapshot left in backup RAM by an early warning before the last reset (if any), logs the state of
+ *        every task and names the task that starved the watchdog: the registered task that had gone longest without
+ *        checking in, relative to its timeout. Then clears the snapshot. Called once at boot.
+ */
+void watchdog_report_snapshot(void) {
+    if (watchdog_snapshot.magic != WATCHDOG_SNAPSHOT_MAGIC) {
+        return; // No early warning before the last reset (or backup RAM lost power)
+    }
+    watchdog_snapshot.magic = 0;
+
+    const char *const state_names[] = {"not created", "disabled", "enabled", "running"}; // By `watchdog_snapshot_task_state_t`
+    (void)state_names; // Only used by log output, which RELEASE builds compile out
+    const uint8_t num_tasks = watchdog_snapshot.num_tasks <= NUM_TASKS ? watchdog_snapshot.num_tasks : NUM_TASKS;
+    const uint32_t tick_count = watchdog_snapshot.tick_count;
+
+    info("[!] Watchdog early warning before the last reset (tick %u, reset cause: %s)\n", tick_count,
+         (RSTC->RCAUSE.reg & RSTC_RCAUSE_WDT) ? "watchdog" : "other");
+
+    size_t starved_index = WATCHDOG_SNAPSHOT_NO_TASK;
+    uint32_t starved_permille = 0;
+    for (size_t i = 0; i < num_tasks; i++) {
+        const volatile watchdog_snapshot_task_t *const p_entry = &watchdog_snapshot.tasks[i];
+        const uint32_t ticks_since_checkin = tick_count - p_entry->last_checkin_time_ticks;
+
+        char name[WATCHDOG_SNAPSHOT_NAME_LENGTH + 1];
+        snapshot_task_name(i, name);
+        info("[!]   %s: %s, %s, last checkin %u ticks before (timeout %u ms), stack free %u words, queued %u urgent %u normal\n",
+             name, state_names[p_entry->state <= WATCHDOG_SNAPSHOT_TASK_RUNNING ? p_entry->state : 0],
+             p_entry->has_registered ? "registered" : "unregistered",
+             p_entry->has_registered ? ticks_since_checkin : 0, p_entry->watchdog_timeout_ms, p_entry->stack_high_water_mark,
+             p_entry->urgent_queue_depth, p_entry->normal_queue_depth);
+
+        const uint32_t timeout_ticks = pdMS_TO_TICKS(p_entry->watchdog_timeout_ms);
+        if (p_entry->has_registered && timeout_ticks > 0) {
+            const uint32_t permille = (uint32_t)(((uint64_t)ticks_since_checkin * 1000) / timeout_ticks);
+            if (starved_index == WATCHDOG_SNAPSHOT_NO_TASK || permille > starved_permille) {
+                starved_index = i;
+                starved_permille = permille;
+            }
+        }
+    }
+
+    char name[WATCHDOG_SNAPSHOT_NAME_LENGTH + 1];
+    if (watchdog_snapshot.running_task_index < num_tasks) {
+        snapshot_task_name(watchdog_snapshot.running_task_index, name);
+        info("[!] Interrupted task: %s\n", name);
+    }
+    if (starved_index != WATCHDOG_SNAPSHOT_NO_TASK) {
+        snapshot_task_name(starved_index, name);
+        info("[!] Task that starved the watchdog: %s (%u/1000 of its timeout without checking in)\n", name, starved_permille);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef WATCHDOG_SNAPSHOT_H
+#define WATCHDOG_SNAPSHOT_H
+
+// Includes
+#include "globals.h"
+
+// Constants
+#define WATCHDOG_SNAPSHOT_MAGIC 0x57445353UL // ASCII for 'WDSS'; marks a complete snapshot in backup RAM
+#define WATCHDOG_SNAPSHOT_NAME_LENGTH 12     // Characters of each task name kept (not NUL-terminated if truncated)
+#define WATCHDOG_SNAPSHOT_NO_TASK 0xFF       // `running_task_index` when no PVDX task was running (e.g. the idle task)
+
+// What a task was doing when the early warning fired. The kernel's own task state cannot be read safely from the
+// early-warning interrupt, so this is derived from the PVDX task list instead.
+typedef enum {
+    WATCHDOG_SNAPSHOT_TASK_NOT_CREATED = 0, // No FreeRTOS task exists yet
+    WATCHDOG_SNAPSHOT_TASK_DISABLED,        // Suspended by the task manager
+    WATCHDOG_SNAPSHOT_TASK_ENABLED,         // Ready or blocked
+    WATCHDOG_SNAPSHOT_TASK_RUNNING,         // The task the early warning interrupted
+} watchdog_snapshot_task_state_t;
+
+// State of one task at the moment of the early warning
+typedef struct {
+    char name[WATCHDOG_SNAPSHOT_NAME_LENGTH];
+    uint32_t last_checkin_time_ticks;
+    uint32_t watchdog_timeout_ms;
+    uint16_t stack_high_water_mark; // Words of stack never used
+    uint8_t state;                  // `watchdog_snapshot_task_state_t`
+    uint8_t has_registered;
+    uint8_t urgent_queue_depth;
+    uint8_t normal_queue_depth;
+    uint16_t reserved;
+} watchdog_snapshot_task_t;
+
+// Written to backup RAM by the early-warning interrupt; survives the watchdog reset that follows it
+typedef struct {
+    uint32_t magic; // `WATCHDOG_SNAPSHOT_MAGIC` once the snapshot is complete, so a partial write is never decoded
+    uint32_t tick_count;
+    uint8_t num_tasks;
+    uint8_t running_task_index; // Index of the task the early warning interrupted, or `WATCHDOG_SNAPSHOT_NO_TASK`
+    uint16_t reserved;
+    watchdog_snapshot_task_t tasks[NUM_TASKS];
+} watchdog_snapshot_t;
+
+void watchdog_take_snapshot(void);
+void watchdog_discard_snapshot(void);
+void watchdog_report_snapshot(void);
+
+#endif // WATCHDOG_SNAPSHOT_H
@@ -11,36 +11,93 @@
 
 #include "watchdog_task.h"
 
+#include <string.h>
+
+#include "command_dispatcher_task.h"
+
 // Reference to the hardware watchdog timer on the SAMD51 microcontroller
 static volatile Wdt *const p_watchdog_timer = WDT                                                                                       ;
 
-/* ---------- DISPATCHABLE FUNCTIONS (sent as commands through the command dispatcher task) ---------- */
+// How tasks prove liveness in `checkin_with_watchdog()` (see `watchdog_checkin_mode_t`)
+static watchdog_checkin_mode_t watchdog_checkin_mode = WATCHDOG_DEFAULT_CHECKIN_MODE                                                    ;
+// Check-ins recorded through each path since boot (see `get_watchdog_checkin_stats()`)
+static watchdog_checkin_stats_t watchdog_checkin_stats = {0}                                                                            ;
+// Incremented whenever a task registers or unregisters, so the watchdog knows to rebuild its deadline list
+static uint32_t watchdog_registration_generation = 0                                                                                    ;
+// Incremented by `reset_watchdog_checkin_interval_stats()`; a copy of the statistics from an older generation is empty
+static uint32_t checkin_interval_stats_generation = 0                                                                                   ;
 
 /**
- * \fn watchdog_checkin
+ * \fn record_checkin_interval
  *
- * \brief Updates the last checkin time of the given task to prove that it is
- *        still running
+ * \brief Adds the time between a task's last two check-ins to its check-in interval statistics. The statistics are
+ *        kept in one copy per writer (see `checkin_writer_t`), so the check-in path updates them without a lock
  *
- * \param p_task a constant task pointer; the task to check-in
+ * \param p_task a constant task pointer; the task that checked in
+ * \param interval_ticks ticks since the task's previous check-in (or registration)
+ */
+static void record_checkin_interval(pvdx_task_t *const p_task, uint32_t interval_ticks)                                                 {
+    const uint32_t timeout_ticks = pdMS_TO_TICKS(p_task->watchdog_timeout_ms)                                                           ;
+    const uint32_t margin_ticks = interval_ticks < timeout_ticks ? timeout_ticks - interval_ticks : 0                                   ;
+    const size_t bin =
+        interval_ticks < timeout_ticks ? (interval_ticks * CHECKIN_HISTOGRAM_BINS) / timeout_ticks : CHECKIN_HISTOGRAM_BINS - 1         ;
+
+    const checkin_writer_t writer = get_current_task() == p_watchdog_task ? CHECKIN_WRITER_WATCHDOG : CHECKIN_WRITER_TASK               ;
+    checkin_interval_stats_t *const p_stats = &p_task->checkin_stats.copies[writer]                                                     ;
+    const uint32_t generation = __atomic_load_n(&checkin_interval_stats_generation, __ATOMIC_ACQUIRE)                                   ;
+    if (p_task->checkin_stats.generations[writer] != generation)                                                                        {
+        // The statistics were reset since this copy was last written; only its writer clears it
+        memset(p_stats, 0, sizeof(checkin_interval_stats_t))                                                                            ;
+        __atomic_store_n(&p_task->checkin_stats.generations[writer], generation, __ATOMIC_RELEASE)                                      ;}
+    if (p_stats->intervals == 0 || interval_ticks < p_stats->min_interval_ticks)                                                        {
+        p_stats->min_interval_ticks = interval_ticks                                                                                    ;}
+    if (interval_ticks > p_stats->max_interval_ticks)                                                                                   {
+        p_stats->max_interval_ticks = interval_ticks                                                                                    ;}
+    if (p_stats->intervals == 0 || margin_ticks < p_stats->min_margin_ticks)                                                            {
+        p_stats->min_margin_ticks = margin_ticks                                                                                        ;}
+    if (p_stats->histogram[bin] < UINT16_MAX)                                                                                           {
+        p_stats->histogram[bin]++                                                                                                       ;}
+    p_stats->total_interval_ticks += interval_ticks                                                                                     ;
+    p_stats->intervals++                                                                                                                ;}
+
+/**
+ * \fn store_checkin_time
  *
- * \warning Acquires the task list mutex
- * \warning Modifies the given task struct
+ * \brief Records the current tick count as a task's last checkin time with a single atomic exchange, so that neither the
+ *        task checking in nor the watchdog scanning the task list needs a lock, and updates the task's check-in
+ *        interval statistics
+ *
+ * \param p_task a constant task pointer; the task to check-in
  */
-void watchdog_checkin(pvdx_task_t *const p_task)                                                                                        {
+static inline void store_checkin_time(pvdx_task_t *const p_task)                                                                        {
     if (!p_task)                                                                                                                        {
         fatal("Attempted to update checkin time of null task!")                                                                         ;}
 
-    if (!(p_task->has_registered))                                                                                                      {
+    if (!__atomic_load_n(&p_task->has_registered, __ATOMIC_ACQUIRE))                                                                    {
         // something went wrong because a task that is checking in should have 'has_registered' set to true
         fatal("watchdog: %s task tried to check in without registering\n", p_task->name)                                                ;}
 
-    lock_mutex(task_list_mutex)                                                                                                         ;
+    const uint32_t current_time_ticks = xTaskGetTickCount()                                                                             ;
+    const uint32_t last_checkin_time_ticks =
+        __atomic_exchange_n(&p_task->last_checkin_time_ticks, current_time_ticks, __ATOMIC_ACQ_REL)                                     ;
+    if (last_checkin_time_ticks != WATCHDOG_CHECKIN_UNREGISTERED)                                                                       {
+        record_checkin_interval(p_task, current_time_ticks - last_checkin_time_ticks)                                                   ;}}
 
-    // update the last checkin time
-    p_task->last_checkin_time_ticks = xTaskGetTickCount()                                                                               ;
+/* ---------- DISPATCHABLE FUNCTIONS (sent as commands through the command dispatcher task) ---------- */
 
-    unlock_mutex(task_list_mutex)                                                                                                       ;
+/**
+ * \fn watchdog_checkin
+ *
+ * \brief Updates the last checkin time of the given task to prove that it is
+ *        still running. This is the audited path taken by `OPERATION_CHECKIN` commands.
+ *
+ * \param p_task a constant task pointer; the task to check-in
+ *
+ * \warning Modifies the given task struct
+ */
+void watchdog_checkin(pvdx_task_t *const p_task)                                                                                        {
+    store_checkin_time(p_task)                                                                                                          ;
+    __atomic_fetch_add(&watchdog_checkin_stats.command_checkins, 1, __ATOMIC_RELAXED)                                                   ;
     debug("watchdog: %s task checked in\n", p_task->name)                                                                               ;}
 
 /* ---------- NON-DISPATCHABLE FUNCTIONS (do not go through the command dispatcher) ---------- */
@@ -102,27 +159,21 @@ QueueHandle_t init_watchdog(void)
 /**
  * \fn early_warning_callback_watchdog
  *
- * \brief No clue
+ * \brief Handles the hardware watchdog's early warning, which fires halfway through the watchdog period when the
+ *        watchdog has not been petted. Records a snapshot of every task in backup RAM for the next boot to decode
+ *        (see `watchdog_report_snapshot()`) and returns; it never blocks. Log messages still in the log ring are left
+ *        there: formatting them here would make the interrupt's run time depend on the ring, and warnings and fatal
+ *        errors are kept in the crash log anyway.
  *
  * \return void
+ *
+ * \warning Runs in interrupt context (called by `WDT_Handler()`)
  */
 void early_warning_callback_watchdog(void)                                                                                              {
-    warning("Early warning callback executed\n")                                                                                        ;
-    // This function gets called when the watchdog is almost out of time
-    // TODO: Test if this works
-    // This is also fine to leave blank
-    gpio_set_pin_level(LED_ORANGE1, false)                                                                                              ;
-    vTaskDelay(pdMS_TO_TICKS(100))                                                                                                      ;
-    gpio_set_pin_level(LED_ORANGE2, false)                                                                                              ;
-    vTaskDelay(pdMS_TO_TICKS(100))                                                                                                      ;
-    gpio_set_pin_level(LED_RED, true)                                                                                                   ;
-    vTaskDelay(pdMS_TO_TICKS(400))                                                                                                      ;
-    gpio_set_pin_level(LED_ORANGE1, true)                                                                                               ;
-    vTaskDelay(pdMS_TO_TICKS(33))                                                                                                       ;
-    gpio_set_pin_level(LED_ORANGE2, true)                                                                                               ;
-    vTaskDelay(pdMS_TO_TICKS(33))                                                                                                       ;
-    gpio_set_pin_level(LED_RED, false)                                                                                                  ;
-    vTaskDelay(pdMS_TO_TICKS(300))                                                                                                      ;;}
+    watchdog_clear_early_warning_bit(p_watchdog_timer)                                                                                  ;
+    watchdog_take_snapshot()                                                                                                            ;
+    gpio_set_pin_level(LED_RED, true); // Visible sign that a reset is imminent
+                                                                                                                                        }
 
 /**
  * \fn pet_watchdog
@@ -132,7 +183,8 @@ void early_warning_callback_watchdog(void)
  */
 void pet_watchdog(void)                                                                                                                 {
     debug("hardware-watchdog: Petted\n")                                                                                                ;
-    watchdog_feed(p_watchdog_timer)                                                                                                     ;}
+    watchdog_feed(p_watchdog_timer)                                                                                                     ;
+    watchdog_discard_snapshot()                                                                                                         ;}
 
 /**
  * \fn kick_watchdog
@@ -166,6 +218,162 @@ inline command_t get_watchdog_checkin_command(pvdx_task_t *const p_task)
         .data_type = CMD_DATA_PVDX_TASK,
         .result = NO_STATUS_RETURN,                                                                                                     };}
 
+/**
+ * \fn checkin_with_watchdog
+ *
+ * \brief Proves that the calling task is still running. In `WATCHDOG_CHECKIN_DIRECT` mode the checkin time is stored
+ *        directly in the task struct, without any command, queue copy or context switch. In
+ *        `WATCHDOG_CHECKIN_COMMAND` mode an `OPERATION_CHECKIN` command is enqueued instead, so that every checkin
+ *        passes through the Command Dispatcher's audit hook.
+ *
+ * \param p_task a pointer to the task checking in (normally the caller's own entry in the task list)
+ *
+ * \return void
+ */
+void checkin_with_watchdog(pvdx_task_t *const p_task)                                                                                   {
+    if (__atomic_load_n(&watchdog_checkin_mode, __ATOMIC_RELAXED) == WATCHDOG_CHECKIN_COMMAND)                                          {
+        command_t cmd_checkin = get_watchdog_checkin_command(p_task)                                                                    ;
+        enqueue_command(&cmd_checkin)                                                                                                   ;
+        return                                                                                                                          ;}
+
+    store_checkin_time(p_task)                                                                                                          ;
+    __atomic_fetch_add(&watchdog_checkin_stats.direct_checkins, 1, __ATOMIC_RELAXED)                                                    ;}
+
+/**
+ * \fn set_watchdog_checkin_mode
+ *
+ * \brief Chooses how `checkin_with_watchdog()` records checkins from now on
+ *
+ * \param mode the new checkin mode
+ */
+void set_watchdog_checkin_mode(watchdog_checkin_mode_t mode)                                                                            {
+    __atomic_store_n(&watchdog_checkin_mode, mode, __ATOMIC_RELAXED)                                                                    ;
+    info("watchdog: checkin mode set to %s\n", mode == WATCHDOG_CHECKIN_DIRECT ? "direct" : "command")                                  ;}
+
+/**
+ * \fn get_watchdog_checkin_mode
+ *
+ * \returns `watchdog_checkin_mode_t`, the current checkin mode
+ */
+watchdog_checkin_mode_t get_watchdog_checkin_mode(void)                                                                                 {
+    return __atomic_load_n(&watchdog_checkin_mode, __ATOMIC_RELAXED)                                                                    ;}
+
+/**
+ * \fn get_watchdog_checkin_stats
+ *
+ * \returns `watchdog_checkin_stats_t`, the number of checkins recorded through each path since boot
+ */
+watchdog_checkin_stats_t get_watchdog_checkin_stats(void)                                                                               {
+    return (watchdog_checkin_stats_t)                                                                                                   {
+        .direct_checkins = __atomic_load_n(&watchdog_checkin_stats.direct_checkins, __ATOMIC_RELAXED),
+        .command_checkins = __atomic_load_n(&watchdog_checkin_stats.command_checkins, __ATOMIC_RELAXED),                                };}
+
+/**
+ * \fn get_watchdog_registration_generation
+ *
+ * \returns `uint32_t`, a counter that changes whenever a task registers or unregisters with the watchdog, or its
+ *          timeout changes
+ */
+uint32_t get_watchdog_registration_generation(void)                                                                                     {
+    return __atomic_load_n(&watchdog_registration_generation, __ATOMIC_ACQUIRE)                                                         ;}
+
+/**
+ * \fn set_watchdog_timeout
+ *
+ * \brief Changes how often a task must check in with the watchdog (e.g. when a mode change gives it a new timeout).
+ *        The watchdog recomputes its deadlines before it next checks them.
+ *
+ * \param p_task a pointer to the task
+ * \param timeout_ms the new watchdog timeout (in ms)
+ */
+void set_watchdog_timeout(pvdx_task_t *const p_task, uint32_t timeout_ms)                                                               {
+    __atomic_store_n(&p_task->watchdog_timeout_ms, timeout_ms, __ATOMIC_RELAXED)                                                        ;
+    __atomic_fetch_add(&watchdog_registration_generation, 1, __ATOMIC_RELEASE)                                                          ;}
+
+/**
+ * \fn get_watchdog_checkin_interval_stats
+ *
+ * \brief Combines the copies of a task's check-in interval statistics kept by each writer (see `checkin_writer_t`)
+ *
+ * \param p_task a pointer to the task
+ *
+ * \returns `checkin_interval_stats_t`, the task's check-in interval statistics (a check-in being recorded while they
+ *          are read may be partly included)
+ */
+checkin_interval_stats_t get_watchdog_checkin_interval_stats(pvdx_task_t *const p_task)                                                 {
+    checkin_interval_stats_t combined = {0}                                                                                             ;
+    const uint32_t generation = __atomic_load_n(&checkin_interval_stats_generation, __ATOMIC_ACQUIRE)                                   ;
+    for (size_t writer = 0; writer < NUM_CHECKIN_WRITERS; writer++)                                                                     {
+        if (__atomic_load_n(&p_task->checkin_stats.generations[writer], __ATOMIC_ACQUIRE) != generation)                                {
+            continue                                                                                                                    ;}
+        const checkin_interval_stats_t stats = p_task->checkin_stats.copies[writer]                                                     ;
+        if (stats.intervals == 0)                                                                                                       {
+            continue                                                                                                                    ;}
+        if (combined.intervals == 0 || stats.min_interval_ticks < combined.min_interval_ticks)                                          {
+            combined.min_interval_ticks = stats.min_interval_ticks                                                                      ;}
+        if (stats.max_interval_ticks > combined.max_interval_ticks)                                                                     {
+            combined.max_interval_ticks = stats.max_interval_ticks                                                                      ;}
+        if (combined.intervals == 0 || stats.min_margin_ticks < combined.min_margin_ticks)                                              {
+            combined.min_margin_ticks = stats.min_margin_ticks                                                                          ;}
+        for (size_t bin = 0; bin < CHECKIN_HISTOGRAM_BINS; bin++)                                                                       {
+            const uint32_t count = (uint32_t)combined.histogram[bin] + stats.histogram[bin]                                             ;
+            combined.histogram[bin] = count < UINT16_MAX ? (uint16_t)count : UINT16_MAX                                                 ;}
+        combined.total_interval_ticks += stats.total_interval_ticks                                                                     ;
+        combined.intervals += stats.intervals                                                                                           ;}
+    return combined                                                                                                                     ;}
+
+/**
+ * \fn reset_watchdog_checkin_interval_stats
+ *
+ * \brief Clears the check-in interval statistics of every task (e.g. after changing a task's timeout). Each copy is
+ *        cleared by its own writer at its next check-in, so the check-in path never races with a reset
+ */
+void reset_watchdog_checkin_interval_stats(void)                                                                                        {
+    __atomic_fetch_add(&checkin_interval_stats_generation, 1, __ATOMIC_RELEASE)                                                         ;}
+
+/**
+ * \fn get_watchdog_checkin_record
+ *
+ * \brief Condenses a task's check-in interval statistics into a packed telemetry record (times in milliseconds)
+ *
+ * \param p_task a pointer to the task
+ *
+ * \returns `watchdog_checkin_record_t`, the record
+ */
+watchdog_checkin_record_t get_watchdog_checkin_record(pvdx_task_t *const p_task)                                                        {
+    const checkin_interval_stats_t stats = get_watchdog_checkin_interval_stats(p_task)                                                  ;
+    watchdog_checkin_record_t record =                                                                                                  {
+        .task_index = (uint8_t)p_task->task_index,
+        .num_bins = CHECKIN_HISTOGRAM_BINS,
+        .reserved = 0,
+        .timeout_ms = p_task->watchdog_timeout_ms,
+        .intervals = stats.intervals,
+        .min_interval_ms = stats.min_interval_ticks * portTICK_PERIOD_MS,
+        .mean_interval_ms = stats.intervals ? (uint32_t)(stats.total_interval_ticks / stats.intervals) * portTICK_PERIOD_MS : 0,
+        .max_interval_ms = stats.max_interval_ticks * portTICK_PERIOD_MS,
+        .min_margin_ms = stats.min_margin_ticks * portTICK_PERIOD_MS,                                                                   };
+    for (size_t bin = 0; bin < CHECKIN_HISTOGRAM_BINS; bin++)                                                                           {
+        record.histogram[bin] = stats.histogram[bin]                                                                                    ;}
+    return record                                                                                                                       ;}
+
+/**
+ * \fn watchdog_checkin_serialize
+ *
+ * \brief Writes one `watchdog_checkin_record_t` per task, in task list order, for downlink
+ *
+ * \param p_buffer Buffer to write the records into
+ * \param buffer_size Size of `p_buffer` in bytes
+ *
+ * \returns `size_t`, the number of bytes written (only whole records are written)
+ */
+size_t watchdog_checkin_serialize(uint8_t *const p_buffer, size_t buffer_size)                                                          {
+    size_t offset = 0                                                                                                                   ;
+    for (size_t i = 0; task_list[i] != NULL && offset + sizeof(watchdog_checkin_record_t) <= buffer_size; i++)                          {
+        const watchdog_checkin_record_t record = get_watchdog_checkin_record(task_list[i])                                              ;
+        memcpy(&p_buffer[offset], &record, sizeof(record))                                                                              ;
+        offset += sizeof(record)                                                                                                        ;}
+    return offset                                                                                                                       ;}
+
 /**
  * \fn register_task_with_watchdog
  *
@@ -187,9 +395,11 @@ void register_task_with_watchdog(pvdx_task_t *const p_task)
     if (p_task->has_registered)                                                                                                         {
         fatal("%s task tried to register a second time with watchdog\n", p_task->name)                                                  ;}
 
-    // initialize running times and require the task to check in
-    p_task->last_checkin_time_ticks = xTaskGetTickCount()                                                                               ;
-    p_task->has_registered = true                                                                                                       ;
+    // initialize running times and require the task to check in (the time is published before the flag, since the
+    // watchdog scans without the task list mutex)
+    __atomic_store_n(&p_task->last_checkin_time_ticks, xTaskGetTickCount(), __ATOMIC_RELAXED)                                           ;
+    __atomic_store_n(&p_task->has_registered, true, __ATOMIC_RELEASE)                                                                   ;
+    __atomic_fetch_add(&watchdog_registration_generation, 1, __ATOMIC_RELEASE)                                                          ;
     debug("%s task registered with watchdog\n", p_task->name)                                                                           ;}
 
 /**
@@ -213,29 +423,21 @@ void unregister_task_with_watchdog(pvdx_task_t *const p_task)
     if (!(p_task->has_registered))                                                                                                      {
         fatal("%s task tried to unregister a second time with watchdog\n", p_task->name)                                                ;}
 
-    p_task->last_checkin_time_ticks = 0xDEADBEEF; // 0xDEADBEEF is a special value that indicates that the task is not running
-    p_task->has_registered = false                                                                                                      ;
+    // The flag is cleared first; a scan that already saw it set skips the task once it reads the special value
+    __atomic_store_n(&p_task->has_registered, false, __ATOMIC_RELEASE)                                                                  ;
+    __atomic_store_n(&p_task->last_checkin_time_ticks, WATCHDOG_CHECKIN_UNREGISTERED, __ATOMIC_RELEASE)                                 ;
+    __atomic_fetch_add(&watchdog_registration_generation, 1, __ATOMIC_RELEASE)                                                          ;
     debug("%s task unregistered with watchdog\n", p_task->name)                                                                         ;}
 
 /**
- * \fn exec_command_task_manager
+ * \fn exec_command_watchdog_checkin
  *
- * \brief Executes a command received by the watchdog task
+ * \brief Executes an `OPERATION_CHECKIN` command received by the watchdog task (routed by `exec_command()`)
  *
- * \param p_cmd a pointer to a command forwarded to the task manager
+ * \param p_cmd a pointer to a checkin command whose `data.pvdx_task` is the task checking in
  *
  * \return void
- *
- * \warning fatal error if target wrong or operation undefined
  */
-void exec_command_watchdog(command_t *const p_cmd)                                                                                      {
-    if (p_cmd->target != p_watchdog_task)                                                                                               {
-        fatal("watchdog: command target is not watchdog! target: %d operation: %d\n", p_cmd->target->name, p_cmd->operation)            ;}
-
-    switch (p_cmd->operation)                                                                                                           {
-        case OPERATION_CHECKIN:
-            watchdog_checkin(p_cmd->data.pvdx_task)                                                                                     ;
-            break                                                                                                                       ;
-        default:
-            fatal("watchdog: Invalid operation! target: %d operation: %d\n", p_cmd->target, p_cmd->operation)                           ;
-            break                                                                                                                       ;}}
+void exec_command_watchdog_checkin(command_t *const p_cmd)                                                                              {
+    watchdog_checkin(p_cmd->data.pvdx_task)                                                                                             ;
+    p_cmd->result = SUCCESS                                                                                                             ;}
@@ -9,9 +9,12 @@
 #include "mutexes.h"
 #include "rtos_start.h"
 #include "task_manager_task.h"
+#include "watchdog_snapshot.h"
 
 // Constants
-#define WATCHDOG_MS_DELAY 1000 // Controls how often the Watchdog thread runs and verifies task checkins
+#define WATCHDOG_MS_DELAY 1000                                // How often the Watchdog task pets the hardware watchdog
+#define WATCHDOG_CHECKIN_UNREGISTERED 0xDEADBEEF              // `last_checkin_time_ticks` of a task that is not running
+#define WATCHDOG_DEFAULT_CHECKIN_MODE WATCHDOG_CHECKIN_DIRECT // Checkin mode used from boot (see `watchdog_checkin_mode_t`)
 
 // Memory for the watchdog task
 #define WATCHDOG_TASK_STACK_SIZE 1024 // Size of the stack in words (multiply by 4 to get bytes)
@@ -23,9 +26,45 @@ typedef struct {
     StackType_t watchdog_task_stack[WATCHDOG_TASK_STACK_SIZE];
     uint8_t watchdog_command_queue_buffer[COMMAND_QUEUE_MAX_COMMANDS * COMMAND_QUEUE_ITEM_SIZE];
     StaticQueue_t watchdog_task_queue;
+    command_queue_set_memory_t watchdog_queue_set_mem;
     StaticTask_t watchdog_task_tcb;
 } watchdog_task_memory_t;
 
+// How `checkin_with_watchdog()` records that a task is still running
+typedef enum {
+    WATCHDOG_CHECKIN_DIRECT = 0, // Atomically store the checkin time in the task struct (no command, lock or context switch)
+    WATCHDOG_CHECKIN_COMMAND,    // Send an `OPERATION_CHECKIN` command through the Command Dispatcher (audited)
+} watchdog_checkin_mode_t;
+
+// Checkins recorded through each path since boot
+typedef struct {
+    uint32_t direct_checkins;  // Checkins stored directly by `checkin_with_watchdog()`
+    uint32_t command_checkins; // Checkins executed from `OPERATION_CHECKIN` commands
+} watchdog_checkin_stats_t;
+
+// When a registered task will next be overdue: the first tick at which it will have gone longer than its timeout
+// without checking in (unless it checks in again before then)
+typedef struct {
+    TickType_t deadline_ticks;
+    pvdx_task_t *p_task;
+} watchdog_deadline_t;
+
+// Packed telemetry record of one task's check-in interval statistics (see `watchdog_checkin_serialize()`)
+typedef struct __attribute__((packed)) {
+    uint8_t task_index;
+    uint8_t num_bins; // `CHECKIN_HISTOGRAM_BINS`
+    uint16_t reserved;
+    uint32_t timeout_ms;
+    uint32_t intervals;
+    uint32_t min_interval_ms;
+    uint32_t mean_interval_ms;
+    uint32_t max_interval_ms;
+    uint32_t min_margin_ms;                     // Worst-case time that was left before the watchdog timeout
+    uint16_t histogram[CHECKIN_HISTOGRAM_BINS]; // Intervals by eighths of the timeout
+} watchdog_checkin_record_t;
+
+_Static_assert(sizeof(watchdog_checkin_record_t) == 44, "watchdog_checkin_record_t is a fixed telemetry layout");
+
 extern watchdog_task_memory_t watchdog_mem;
 extern QueueHandle_t watchdog_command_queue_handle;
 
@@ -38,6 +77,16 @@ void kick_watchdog(void);
 command_t get_watchdog_checkin_command(pvdx_task_t *const task);
 void register_task_with_watchdog(pvdx_task_t *const p_task);
 void unregister_task_with_watchdog(pvdx_task_t *const task);
-void exec_command_watchdog(command_t *const p_cmd);
+void exec_command_watchdog_checkin(command_t *const p_cmd);
+void checkin_with_watchdog(pvdx_task_t *const p_task);
+void set_watchdog_checkin_mode(watchdog_checkin_mode_t mode);
+watchdog_checkin_mode_t get_watchdog_checkin_mode(void);
+watchdog_checkin_stats_t get_watchdog_checkin_stats(void);
+uint32_t get_watchdog_registration_generation(void);
+void set_watchdog_timeout(pvdx_task_t *const p_task, uint32_t timeout_ms);
+checkin_interval_stats_t get_watchdog_checkin_interval_stats(pvdx_task_t *const p_task);
+void reset_watchdog_checkin_interval_stats(void);
+watchdog_checkin_record_t get_watchdog_checkin_record(pvdx_task_t *const p_task);
+size_t watchdog_checkin_serialize(uint8_t *const p_buffer, size_t buffer_size);
 
 #endif // WATCHDOG_TASK_H
@@ -0,0 +1,855 @@
+/**
+ * src/tests/benchmark.c
+ *
+ * On-target performance benchmarks. These run alongside the unit tests in UNITTEST builds (after the OS
+ * integrity tasks have been initialized but before the scheduler starts) and report their results over RTT.
+ * Timings are taken with the DWT cycle counter, so they measure the cost of the code path itself rather
+ * than any scheduling delay. Benchmarks that need the scheduler running (e.g. counting context switches or
+ * timing a command end to end) run later from a short-lived, low-priority benchmark task.
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+
+#include "tests/benchmark.h"
+
+#include <string.h>
+
+#include "command_dispatcher_task.h"
+#include "command_encoding.h"
+#include "command_trace.h"
+#include "crash_log.h"
+#include "cycle_counter.h"
+#include "log_compress.h"
+#include "log_ring.h"
+#include "logging.h"
+#include "run_time_stats.h"
+#include "task_list.h"
+#include "task_manager_task.h"
+#include "task_period.h"
+#include "watchdog_task.h"
+
+#ifdef UNITTEST
+
+static StackType_t benchmark_task_stack[BENCHMARK_TASK_STACK_SIZE];
+static StaticTask_t benchmark_task_tcb;
+
+/**
+ * \fn benchmark_summarize
+ *
+ * \brief Reduces an array of cycle-count samples to min/max/mean
+ */
+static benchmark_result_t benchmark_summarize(const uint32_t *samples, size_t count) {
+    benchmark_result_t result = {.min_cycles = UINT32_MAX, .max_cycles = 0, .mean_cycles = 0};
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (samples[i] < result.min_cycles) {
+            result.min_cycles = samples[i];
+        }
+        if (samples[i] > result.max_cycles) {
+            result.max_cycles = samples[i];
+        }
+        total += samples[i];
+    }
+    result.mean_cycles = (uint32_t)(total / count);
+    return result;
+}
+
+/**
+ * \fn find_trace_stage
+ *
+ * \brief Looks for the event of a traced command reaching a lifecycle stage in the command trace ring
+ *
+ * \param trace_id the command's trace ID
+ * \param stage the stage to look for
+ * \param p_cycles set to the cycle count of the event, if it is found
+ *
+ * \returns `bool`, whether the event is in the ring
+ */
+static bool find_trace_stage(uint16_t trace_id, trace_stage_t stage, uint32_t *const p_cycles) {
+    static command_trace_event_t events[COMMAND_TRACE_RING_SIZE];
+    const size_t count = command_trace_read_events(events, COMMAND_TRACE_RING_SIZE);
+
+    for (size_t i = count; i-- > 0;) {
+        if (events[i].trace_id == trace_id && events[i].stage == stage) {
+            *p_cycles = events[i].cycles;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \fn benchmark_enqueue_to_execute
+ *
+ * \brief Times one command from `enqueue_command()` until its target has executed it, with every task running. The
+ *        benchmark task runs below every OS task, so it only gets to look once the command has been handled; the end
+ *        time is taken from the command's `TRACE_STAGE_COMPLETE` event, recorded by the target as its handler returns.
+ *
+ * \param p_cmd the command to send (a fresh copy is sent every time)
+ * \param p_cycles set to the number of cycles taken
+ *
+ * \returns `bool`, false if the command was not queued or not executed within `BENCHMARK_LATENCY_TIMEOUT_MS`
+ */
+static bool benchmark_enqueue_to_execute(const command_t *const p_cmd, uint32_t *const p_cycles) {
+    command_t cmd = *p_cmd;
+    const uint32_t start = get_cycle_count();
+    if (enqueue_command(&cmd) != SUCCESS) {
+        return false;
+    }
+
+    uint32_t completed;
+    const TickType_t deadline_ticks = xTaskGetTickCount() + pdMS_TO_TICKS(BENCHMARK_LATENCY_TIMEOUT_MS);
+    while (!find_trace_stage(cmd.trace_id, TRACE_STAGE_COMPLETE, &completed)) {
+        if (ticks_until(deadline_ticks) == 0) {
+            return false;
+        }
+        vTaskDelay(1);
+    }
+
+    *p_cycles = completed - start;
+    return true;
+}
+
+/**
+ * \fn benchmark_dispatch_latency
+ *
+ * \brief Compares the enqueue-to-execute latency of `DISPATCH_MODE_HUB` against `DISPATCH_MODE_DIRECT`, end to end:
+ *        in hub mode this includes the time the Command Dispatcher takes to wake up and forward the command, and in
+ *        both modes the time the target takes to wake up and execute it
+ *
+ * \warning must be called from a task once the scheduler is running
+ */
+void benchmark_dispatch_latency(void) {
+    test_log("----- benchmarking dispatch latency -----\n");
+
+    // Check in on behalf of the Command Dispatcher, which has registered with the watchdog by now
+    if (!p_command_dispatcher_task->has_registered) {
+        test_log("skipped: Command Dispatcher has not registered with the watchdog\n");
+        return;
+    }
+    const command_t cmd_checkin = get_watchdog_checkin_command(p_command_dispatcher_task);
+
+    // A checkin still waiting in the watchdog's lane would otherwise swallow the timed one, which then never completes
+    const overflow_policy_config_t original_policy = get_overflow_policy(OPERATION_CHECKIN);
+    set_overflow_policy(OPERATION_CHECKIN, OVERFLOW_POLICY_BOUNDED_WAIT, OVERFLOW_DEFAULT_WAIT_MS);
+    static uint32_t samples[BENCHMARK_ITERATIONS];
+    const dispatch_mode_t original_mode = get_dispatch_mode();
+    const dispatch_mode_t modes[] = {DISPATCH_MODE_HUB, DISPATCH_MODE_DIRECT};
+    const char *const mode_names[] = {"hub", "direct"};
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        set_dispatch_mode(modes[m]);
+        size_t count = 0;
+        for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+            if (benchmark_enqueue_to_execute(&cmd_checkin, &samples[count])) {
+                count++;
+            }
+        }
+        if (count == 0) {
+            test_log("%s mode enqueue-to-execute: no command was executed\n", mode_names[m]);
+            continue;
+        }
+
+        const benchmark_result_t result = benchmark_summarize(samples, count);
+        test_log("%s mode enqueue-to-execute: mean %u us, min %u us, max %u us (%u of %u executed)\n", mode_names[m],
+                 cycles_to_us(result.mean_cycles), cycles_to_us(result.min_cycles), cycles_to_us(result.max_cycles), (unsigned)count,
+                 BENCHMARK_ITERATIONS);
+    }
+
+    set_dispatch_mode(original_mode);
+    set_overflow_policy(OPERATION_CHECKIN, original_policy.policy, original_policy.wait_ms);
+}
+
+/**
+ * \fn time_command_path
+ *
+ * \brief Times the code path of one command from `enqueue_command()` through the target's handler, without any
+ *        scheduling delay. The dispatcher and target tasks are not running yet, so their queue reads are performed
+ *        inline in the same order the tasks would perform them (through `receive_command()`, which keeps the queue sets
+ *        in step).
+ *
+ * \param p_cmd the watchdog checkin command to push through the system
+ *
+ * \returns `uint32_t`, the number of cycles taken
+ */
+static uint32_t time_command_path(command_t *const p_cmd) {
+    command_t cmd;
+    const uint32_t start = get_cycle_count();
+
+    enqueue_command(p_cmd);
+    if (get_dispatch_mode() == DISPATCH_MODE_HUB) {
+        // Second hop: the Command Dispatcher pops the command and forwards it to the target
+        receive_command(p_command_dispatcher_task, &cmd, 0);
+        dispatch_command(&cmd);
+    }
+    receive_command(p_watchdog_task, &cmd, 0);
+    exec_command(&cmd);
+
+    return get_cycle_count() - start;
+}
+
+/**
+ * \fn benchmark_checkin_paths
+ *
+ * \brief Compares the cost of one direct watchdog checkin against one checkin command pushed from
+ *        `enqueue_command()` through the Command Dispatcher to the watchdog's handler (in hub mode)
+ */
+void benchmark_checkin_paths(void) {
+    test_log("----- benchmarking checkin paths -----\n");
+
+    static uint32_t samples[BENCHMARK_ITERATIONS];
+    const dispatch_mode_t original_mode = get_dispatch_mode();
+    const watchdog_checkin_mode_t original_checkin_mode = get_watchdog_checkin_mode();
+    command_t cmd_checkin = get_watchdog_checkin_command(p_watchdog_task);
+
+    // The watchdog only accepts checkins from registered tasks, which normally happens once the task starts
+    const bool was_registered = p_watchdog_task->has_registered;
+    p_watchdog_task->has_registered = true;
+
+    set_watchdog_checkin_mode(WATCHDOG_CHECKIN_DIRECT);
+    for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        const uint32_t start = get_cycle_count();
+        checkin_with_watchdog(p_watchdog_task);
+        samples[i] = get_cycle_count() - start;
+    }
+    benchmark_result_t result = benchmark_summarize(samples, BENCHMARK_ITERATIONS);
+    test_log("direct checkin: mean %u cycles (%u us), min %u, max %u\n", result.mean_cycles, cycles_to_us(result.mean_cycles),
+             result.min_cycles, result.max_cycles);
+
+    set_dispatch_mode(DISPATCH_MODE_HUB);
+    for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        samples[i] = time_command_path(&cmd_checkin);
+    }
+    result = benchmark_summarize(samples, BENCHMARK_ITERATIONS);
+    test_log("checkin command (hub): mean %u cycles (%u us), min %u, max %u\n", result.mean_cycles, cycles_to_us(result.mean_cycles),
+             result.min_cycles, result.max_cycles);
+
+    p_watchdog_task->has_registered = was_registered;
+    set_dispatch_mode(original_mode);
+    set_watchdog_checkin_mode(original_checkin_mode);
+}
+
+/**
+ * \fn benchmark_command_encoding
+ *
+ * \brief Compares the cost of copying a command through a queue as a full `command_t` against packing it into a
+ *        `packed_command_t` first, and reports how much queue storage the packed form saves across all tasks
+ */
+void benchmark_command_encoding(void) {
+    test_log("----- benchmarking command encoding -----\n");
+
+    static uint32_t samples[BENCHMARK_ITERATIONS];
+    static uint8_t wide_queue_buffer[sizeof(command_t)];
+    static uint8_t packed_queue_buffer[sizeof(packed_command_t)];
+    static StaticQueue_t wide_queue_mem;
+    static StaticQueue_t packed_queue_mem;
+    QueueHandle_t wide_queue = xQueueCreateStatic(1, sizeof(command_t), wide_queue_buffer, &wide_queue_mem);
+    QueueHandle_t packed_queue = xQueueCreateStatic(1, sizeof(packed_command_t), packed_queue_buffer, &packed_queue_mem);
+
+    command_t cmd = get_watchdog_checkin_command(p_watchdog_task);
+    command_t received;
+    packed_command_t packed;
+
+    for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        const uint32_t start = get_cycle_count();
+        xQueueSendToBack(wide_queue, &cmd, 0);
+        xQueueReceive(wide_queue, &received, 0);
+        samples[i] = get_cycle_count() - start;
+    }
+    benchmark_result_t result = benchmark_summarize(samples, BENCHMARK_ITERATIONS);
+    test_log("command_t (%u bytes) send+receive: mean %u cycles, min %u, max %u\n", sizeof(command_t), result.mean_cycles,
+             result.min_cycles, result.max_cycles);
+
+    for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        const uint32_t start = get_cycle_count();
+        pack_command(&cmd, &packed);
+        xQueueSendToBack(packed_queue, &packed, 0);
+        xQueueReceive(packed_queue, &packed, 0);
+        unpack_command(&packed, &received);
+        samples[i] = get_cycle_count() - start;
+    }
+    result = benchmark_summarize(samples, BENCHMARK_ITERATIONS);
+    test_log("packed_command_t (%u bytes) pack+send+receive+unpack: mean %u cycles, min %u, max %u\n", sizeof(packed_command_t),
+             result.mean_cycles, result.min_cycles, result.max_cycles);
+
+    vQueueDelete(wide_queue);
+    vQueueDelete(packed_queue);
+
+    // Every command queue slot shrinks, at the cost of the shared metadata pool
+    uint32_t queue_slots = 0;
+    for (size_t i = 0; task_list[i] != NULL; i++) {
+        if (task_list[i]->command_queue != NULL) {
+            queue_slots += COMMAND_QUEUE_MAX_COMMANDS;
+        }
+        if (task_list[i]->urgent_command_queue != NULL) {
+            queue_slots += COMMAND_QUEUE_URGENT_MAX_COMMANDS;
+        }
+    }
+    const uint32_t wide_bytes = queue_slots * sizeof(command_t);
+    const uint32_t packed_bytes = queue_slots * sizeof(packed_command_t) + COMMAND_META_POOL_SIZE * sizeof(command_meta_t);
+    test_log("%u queue slots: %u bytes as command_t, %u bytes packed (incl. metadata pool), %u bytes saved\n", queue_slots,
+             wide_bytes, packed_bytes, wide_bytes - packed_bytes);
+}
+
+/**
+ * \fn count_burst_context_switches
+ *
+ * \brief Sends `BENCHMARK_BURST_COMMANDS` commands in bursts and counts the context switches taken while sending
+ *
+ * \param p_burst the burst of commands to send
+ * \param batched whether to send each burst with `enqueue_commands()` or one `enqueue_command()` at a time
+ *
+ * \returns `uint32_t`, the number of context switches per 100 commands
+ */
+static uint32_t count_burst_context_switches(command_t *const p_burst, bool batched) {
+    uint32_t switches = 0;
+
+    for (size_t sent = 0; sent < BENCHMARK_BURST_COMMANDS; sent += BENCHMARK_BURST_SIZE) {
+        const uint32_t switches_before = get_context_switch_count();
+        if (batched) {
+            enqueue_commands(p_burst, BENCHMARK_BURST_SIZE);
+        } else {
+            for (size_t i = 0; i < BENCHMARK_BURST_SIZE; i++) {
+                enqueue_command(&p_burst[i]);
+            }
+        }
+        switches += get_context_switch_count() - switches_before;
+
+        // Let the target drain its lane so that every burst starts from the same state
+        vTaskDelay(pdMS_TO_TICKS(BENCHMARK_BURST_GAP_MS));
+    }
+
+    return switches * 100 / BENCHMARK_BURST_COMMANDS;
+}
+
+/**
+ * \fn benchmark_burst_context_switches
+ *
+ * \brief Compares the context switches caused by sending bursts of commands one at a time against sending them with
+ *        `enqueue_commands()`, in both dispatch modes. The benchmark task runs below every OS task, so each command
+ *        sent on its own preempts it to wake the receiving task.
+ *
+ * \warning must be called from a task once the scheduler is running
+ */
+void benchmark_burst_context_switches(void) {
+    test_log("----- benchmarking burst context switches -----\n");
+
+    // Check in on behalf of the Command Dispatcher, which has registered with the watchdog by now
+    if (!p_command_dispatcher_task->has_registered) {
+        test_log("skipped: Command Dispatcher has not registered with the watchdog\n");
+        return;
+    }
+    const command_t cmd_checkin = get_watchdog_checkin_command(p_command_dispatcher_task);
+    command_t burst[BENCHMARK_BURST_SIZE];
+    for (size_t i = 0; i < BENCHMARK_BURST_SIZE; i++) {
+        memcpy(&burst[i], &cmd_checkin, sizeof(command_t));
+    }
+
+    // Identical checkins would otherwise be coalesced whenever the watchdog has not drained the previous one yet
+    const overflow_policy_config_t original_policy = get_overflow_policy(OPERATION_CHECKIN);
+    set_overflow_policy(OPERATION_CHECKIN, OVERFLOW_POLICY_BOUNDED_WAIT, OVERFLOW_DEFAULT_WAIT_MS);
+    const dispatch_mode_t original_mode = get_dispatch_mode();
+    const dispatch_mode_t modes[] = {DISPATCH_MODE_HUB, DISPATCH_MODE_DIRECT};
+    const char *const mode_names[] = {"hub", "direct"};
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        set_dispatch_mode(modes[m]);
+        const uint32_t single_switches = count_burst_context_switches(burst, false);
+        const uint32_t batched_switches = count_burst_context_switches(burst, true);
+        test_log("%s mode context switches per 100 commands: %u one at a time, %u batched (bursts of %d)\n", mode_names[m],
+                 single_switches, batched_switches, BENCHMARK_BURST_SIZE);
+    }
+
+    set_dispatch_mode(original_mode);
+    set_overflow_policy(OPERATION_CHECKIN, original_policy.policy, original_policy.wait_ms);
+}
+
+/**
+ * \fn benchmark_checkin_dispatcher_load
+ *
+ * \brief Lets the running system idle for `BENCHMARK_LOAD_WINDOW_MS` in each watchdog checkin mode and reports the
+ *        commands handled by the Command Dispatcher and the context switches taken per second. Every task keeps
+ *        checking in at its normal rate, so the difference is the load that checkins put on the dispatcher.
+ */
+void benchmark_checkin_dispatcher_load(void) {
+    test_log("----- benchmarking checkin dispatcher load -----\n");
+
+    const watchdog_checkin_mode_t original_checkin_mode = get_watchdog_checkin_mode();
+    const watchdog_checkin_mode_t modes[] = {WATCHDOG_CHECKIN_COMMAND, WATCHDOG_CHECKIN_DIRECT};
+    const char *const mode_names[] = {"command", "direct"};
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        set_watchdog_checkin_mode(modes[m]);
+        vTaskDelay(pdMS_TO_TICKS(BENCHMARK_LOAD_SETTLE_MS)); // Let checkins sent in the previous mode drain
+
+        const uint32_t forwarded_before = get_command_dispatcher_stats().commands_forwarded;
+        const uint32_t switches_before = get_context_switch_count();
+        vTaskDelay(pdMS_TO_TICKS(BENCHMARK_LOAD_WINDOW_MS));
+        const uint32_t forwarded = get_command_dispatcher_stats().commands_forwarded - forwarded_before;
+        const uint32_t switches = get_context_switch_count() - switches_before;
+
+        test_log("%s checkins: %u dispatcher commands/s, %u context switches/s\n", mode_names[m],
+                 forwarded * 1000 / BENCHMARK_LOAD_WINDOW_MS, switches * 1000 / BENCHMARK_LOAD_WINDOW_MS);
+    }
+
+    set_watchdog_checkin_mode(original_checkin_mode);
+}
+
+/**
+ * \fn benchmark_task_restart
+ *
+ * \brief Restarts one running subtask the way the watchdog does when a task misses its checkin, and compares the time
+ *        it took with a lower bound on a full reboot: the time PVDXos took to bring every subtask up after starting its
+ *        cycle counter (a reboot adds the hardware watchdog reset and the bootloader's copy of the image on top)
+ */
+void benchmark_task_restart(void) {
+    test_log("----- benchmarking task restart -----\n");
+
+    pvdx_task_t *p_task = NULL;
+    for (size_t i = 0; task_list[i] != NULL && p_task == NULL; i++) {
+        if (task_list[i]->task_type != OS && task_list[i]->enabled && task_list[i]->handle != NULL) {
+            p_task = task_list[i];
+        }
+    }
+    if (p_task == NULL) {
+        test_log("no running subtask to restart, skipping\n");
+        return;
+    }
+
+    const uint32_t start_cycles = get_cycle_count();
+    const status_t status = task_manager_restart_task(p_task);
+    const uint32_t restart_us = cycles_to_us(get_cycle_count() - start_cycles);
+    if (status != SUCCESS) {
+        test_log("%s task could not be restarted (status %d)\n", p_task->name, status);
+        return;
+    }
+
+    const uint32_t min_boot_us = get_task_restart_stats().min_boot_us;
+    test_log("%s task restart: %u us; reboot at least %u us (%u x the restart), not counting the reset and bootloader\n",
+             p_task->name, restart_us, min_boot_us, restart_us > 0 ? min_boot_us / restart_us : 0);
+}
+
+/**
+ * \fn benchmark_mode_transitions
+ *
+ * \brief Times `task_manager_set_mode()` transitions between detumble and safe mode, and compares them with making the
+ *        same change one task at a time through `task_manager_enable_task()`/`task_manager_disable_task()` (what the
+ *        `OPERATION_ENABLE_SUBTASK` and `OPERATION_DISABLE_SUBTASK` handlers do). Called directly, since the benchmark
+ *        task is not in the task list and so cannot wait for command results. Leaves the system in safe mode.
+ */
+void benchmark_mode_transitions(void) {
+    test_log("----- benchmarking mode transitions -----\n");
+
+    static uint32_t samples[BENCHMARK_MODE_TRANSITIONS];
+    const mode_profile_t *const profiles[] = {&mode_profiles[MODE_DETUMBLE], &mode_profiles[MODE_SAFE]};
+
+    for (size_t i = 0; i < BENCHMARK_MODE_TRANSITIONS; i++) {
+        const uint32_t start_cycles = get_cycle_count();
+        const status_t status = task_manager_set_mode(profiles[i % 2]);
+        samples[i] = get_cycle_count() - start_cycles;
+        if (status != SUCCESS) {
+            test_log("entering %s mode failed (status %d), skipping\n", profiles[i % 2]->name, status);
+            return;
+        }
+    }
+    benchmark_result_t result = benchmark_summarize(samples, BENCHMARK_MODE_TRANSITIONS);
+    const mode_transition_stats_t stats = get_mode_transition_stats();
+    test_log("set mode: mean %u us, min %u us, max %u us (scheduler suspended for %u us of the last)\n",
+             cycles_to_us(result.mean_cycles), cycles_to_us(result.min_cycles), cycles_to_us(result.max_cycles),
+             stats.last_suspended_us);
+
+    // Safe mode leaves ADCS disabled; toggle it one call at a time, ending disabled again
+    for (size_t i = 0; i < BENCHMARK_MODE_TRANSITIONS; i++) {
+        const uint32_t start_cycles = get_cycle_count();
+        if (i % 2 == 0) {
+            task_manager_enable_task(p_adcs_task);
+        } else {
+            task_manager_disable_task(p_adcs_task);
+        }
+        samples[i] = get_cycle_count() - start_cycles;
+    }
+    result = benchmark_summarize(samples, BENCHMARK_MODE_TRANSITIONS);
+    test_log("enable/disable one task: mean %u us, min %u us, max %u us\n", cycles_to_us(result.mean_cycles),
+             cycles_to_us(result.min_cycles), cycles_to_us(result.max_cycles));
+}
+
+/**
+ * \fn benchmark_run_time_stats
+ *
+ * \brief Reports how the CPU is shared between tasks while the system idles for `BENCHMARK_LOAD_WINDOW_MS`, as the
+ *        shell's `top` command would show it
+ */
+void benchmark_run_time_stats(void) {
+    test_log("----- benchmarking run-time stats -----\n");
+
+    static run_time_report_t report;
+    if (run_time_stats_measure(BENCHMARK_LOAD_WINDOW_MS, &report) != SUCCESS) {
+        test_log("run-time stats measurement failed, skipping\n");
+        return;
+    }
+
+    uint32_t total_permille = 0;
+    for (size_t i = 0; i < report.num_tasks; i++) {
+        test_log("%s: %u.%u%% CPU, worst slice %u us\n", report.tasks[i].name, report.tasks[i].cpu_permille / 10,
+                 report.tasks[i].cpu_permille % 10, cycles_to_us(report.tasks[i].worst_slice_cycles));
+        total_permille += report.tasks[i].cpu_permille;
+    }
+    test_log("idle %u.%u%%, %u context switches/s, %u.%u%% of the window accounted for\n", report.idle_permille / 10,
+             report.idle_permille % 10, report.context_switches_per_s, total_permille / 10, total_permille % 10);
+}
+
+/**
+ * \fn busy_wait_us
+ *
+ * \brief Keeps the CPU busy for a number of microseconds (stands in for a job of known length)
+ *
+ * \param duration_us how long to spin
+ */
+static void busy_wait_us(uint32_t duration_us) {
+    const uint32_t start_cycles = get_cycle_count();
+    while (get_cycle_count() - start_cycles < duration_us * CYCLES_PER_US) {
+    }
+}
+
+/**
+ * \fn benchmark_periodic_release
+ *
+ * \brief Runs jobs of varying length every `BENCHMARK_PERIOD_MS`, first released by `vTaskDelay()` after each job (how
+ *        tasks paced themselves before periodic tasks) and then by `wait_for_next_release()`, and compares how far each
+ *        drifts from the nominal schedule
+ */
+void benchmark_periodic_release(void) {
+    test_log("----- benchmarking periodic release -----\n");
+
+    // Jobs take 0 to 3/8 of the period, so that no job overruns
+    const uint32_t job_step_us = BENCHMARK_PERIOD_MS * 1000 / 8;
+    const uint32_t nominal_us = BENCHMARK_PERIOD_RELEASES * BENCHMARK_PERIOD_MS * 1000;
+
+    uint32_t start_cycles = get_cycle_count();
+    for (size_t i = 0; i < BENCHMARK_PERIOD_RELEASES; i++) {
+        busy_wait_us((i % 4) * job_step_us);
+        vTaskDelay(pdMS_TO_TICKS(BENCHMARK_PERIOD_MS));
+    }
+    const uint32_t delay_elapsed_us = cycles_to_us(get_cycle_count() - start_cycles);
+
+    // A stand-in periodic task without a command queue (the benchmark task is not in `task_list`)
+    static pvdx_task_t periodic_task = {.name = "BenchmarkPeriodic", .period_ms = BENCHMARK_PERIOD_MS};
+    memset(&periodic_task.period_stats, 0, sizeof(periodic_task.period_stats));
+    start_cycles = get_cycle_count();
+    start_task_period(&periodic_task);
+    for (size_t i = 0; i < BENCHMARK_PERIOD_RELEASES; i++) {
+        busy_wait_us((i % 4) * job_step_us);
+        wait_for_next_release(&periodic_task);
+    }
+    const uint32_t periodic_elapsed_us = cycles_to_us(get_cycle_count() - start_cycles);
+    const task_period_record_t record = get_task_period_record(&periodic_task);
+
+    test_log("%u jobs every %u ms (nominal %u us)\n", BENCHMARK_PERIOD_RELEASES, BENCHMARK_PERIOD_MS, nominal_us);
+    test_log("vTaskDelay: %u us, drift %d us\n", delay_elapsed_us, (int32_t)(delay_elapsed_us - nominal_us));
+    test_log("vTaskDelayUntil: %u us, drift %d us, jitter mean %u us max %u us, %u overruns, %u dropped\n", periodic_elapsed_us,
+             (int32_t)(periodic_elapsed_us - nominal_us), record.mean_jitter_us, record.max_jitter_us, record.overruns,
+             record.skipped_releases);
+}
+
+// Message used to compare the ways of logging, shaped like a devbuild info() call
+#define BENCHMARK_LOG_FORMAT "[INFO|%s:%d]: benchmark: sample %u of %u, value 0x%08X\n"
+
+/**
+ * \fn benchmark_log_push
+ *
+ * \brief Adds a text message to the given ring, as a deferred logging call does
+ */
+static bool benchmark_log_push(log_ring_t *const p_ring, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool was_empty;
+    const bool pushed = log_ring_push(p_ring, LOG_ENTRY_TEXT, format, 0, format, &args, &was_empty);
+    va_end(args);
+    return pushed;
+}
+
+/**
+ * \fn benchmark_log_print
+ *
+ * \brief Formats a message straight into the log channel, as logging calls did before the Logger task
+ */
+static void benchmark_log_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    SEGGER_RTT_vprintf(LOGGING_RTT_OUTPUT_CHANNEL, format, &args);
+    va_end(args);
+}
+
+/**
+ * \fn benchmark_log_ring
+ *
+ * \brief Compares what a logging call costs its caller when it formats the message into RTT itself against packing
+ *        it into the log ring, and what the Logger task later spends formatting a message out of the ring
+ */
+void benchmark_log_ring(void) {
+    test_log("----- benchmarking log ring -----\n");
+
+    static uint32_t samples[BENCHMARK_ITERATIONS];
+    static log_ring_t ring;
+    static char text[LOG_TEXT_MAX_LENGTH];
+    memset(&ring, 0, sizeof(ring));
+
+    for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        const uint32_t start = get_cycle_count();
+        benchmark_log_print(BENCHMARK_LOG_FORMAT, __FILENAME__, __LINE__, i, BENCHMARK_ITERATIONS, get_cycle_count());
+        samples[i] = get_cycle_count() - start;
+    }
+    benchmark_result_t result = benchmark_summarize(samples, BENCHMARK_ITERATIONS);
+    test_log("Formatted in the caller (SEGGER_RTT_vprintf): mean %u cycles, min %u, max %u\n", result.mean_cycles, result.min_cycles,
+             result.max_cycles);
+
+    // The ring is drained every LOG_RING_CAPACITY messages, as the Logger task would
+    uint32_t drain_cycles = 0;
+    uint32_t drained = 0;
+    for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        const uint32_t start = get_cycle_count();
+        benchmark_log_push(&ring, BENCHMARK_LOG_FORMAT, __FILENAME__, __LINE__, i, BENCHMARK_ITERATIONS, get_cycle_count());
+        samples[i] = get_cycle_count() - start;
+
+        if ((i + 1) % LOG_RING_CAPACITY == 0 || i + 1 == BENCHMARK_ITERATIONS) {
+            const uint32_t drain_start = get_cycle_count();
+            log_entry_t entry;
+            while (log_ring_pop(&ring, &entry)) {
+                log_format_payload(entry.p_source, entry.payload, entry.payload_length, text, sizeof(text));
+                drained++;
+            }
+            drain_cycles += get_cycle_count() - drain_start;
+        }
+    }
+    result = benchmark_summarize(samples, BENCHMARK_ITERATIONS);
+    test_log("Packed into the log ring (%u-byte slots): mean %u cycles, min %u, max %u\n", sizeof(log_ring_cell_t), result.mean_cycles,
+             result.min_cycles, result.max_cycles);
+    test_log("Formatted later by the Logger task: mean %u cycles per message\n", drain_cycles / (drained > 0 ? drained : 1));
+}
+
+// A hand-assembled stretch of devbuild log output (RTT channel 1, debug level), in the form the tasks print it. It is
+// not a recording, so the ratio it gives is illustrative only; the crash log figure below uses real record layouts.
+#define BENCHMARK_DEBUG_LINE(site, text) RTT_CTRL_TEXT_WHITE "[DEBUG|" site "]: " text RTT_CTRL_RESET
+static const char benchmark_log_capture[] =
+    BENCHMARK_DEBUG_LINE("heartbeat_main.c:42", "heartbeat: Current time is 41000\n")
+    BENCHMARK_DEBUG_LINE("watchdog_task.c:178", "hardware-watchdog: Petted\n")
+    BENCHMARK_DEBUG_LINE("command_dispatcher_main.c:39", "\n---------- Command Dispatcher Task Loop ----------\n")
+    BENCHMARK_DEBUG_LINE("command_dispatcher_main.c:48", "command_dispatcher: 2 commands popped off queue\n")
+    BENCHMARK_DEBUG_LINE("command_dispatcher_task.c:134", "command-dispatcher: Forwarding operation 1 to Watchdog task\n")
+    BENCHMARK_DEBUG_LINE("command_dispatcher_task.c:134", "command-dispatcher: Forwarding operation 1 to Watchdog task\n")
+    BENCHMARK_DEBUG_LINE("watchdog_main.c:146", "watchdog: Command popped off queue. Target: 536873628, Operation: 1\n")
+    BENCHMARK_DEBUG_LINE("watchdog_task.c:94", "watchdog: Heartbeat task checked in\n")
+    BENCHMARK_DEBUG_LINE("watchdog_main.c:146", "watchdog: Command popped off queue. Target: 536873628, Operation: 1\n")
+    BENCHMARK_DEBUG_LINE("watchdog_task.c:94", "watchdog: Display task checked in\n")
+    BENCHMARK_DEBUG_LINE("heartbeat_main.c:83", "heartbeat: Checked in with watchdog\n")
+    BENCHMARK_DEBUG_LINE("task_manager_main.c:57", "\n---------- Task Manager Task Loop ----------\n")
+    BENCHMARK_DEBUG_LINE("task_manager_main.c:67", "task_manager: No more commands queued.\n")
+    BENCHMARK_DEBUG_LINE("task_manager_main.c:72", "task_manager: Checked in with watchdog\n")
+    BENCHMARK_DEBUG_LINE("display_main.c:38", "\n---------- Display Task Loop ----------\n")
+    BENCHMARK_DEBUG_LINE("display_main.c:52", "display: No more commands queued.\n")
+    BENCHMARK_DEBUG_LINE("display_main.c:72", "display: Checked in with watchdog\n")
+    BENCHMARK_DEBUG_LINE("shell_main.c:30", "\n---------- Shell Task Loop ----------\n")
+    BENCHMARK_DEBUG_LINE("shell_main.c:30", "shell: Checked in with watchdog\n")
+    BENCHMARK_DEBUG_LINE("heartbeat_main.c:42", "heartbeat: Current time is 41500\n")
+    BENCHMARK_DEBUG_LINE("command_dispatcher_main.c:39", "\n---------- Command Dispatcher Task Loop ----------\n")
+    BENCHMARK_DEBUG_LINE("command_dispatcher_main.c:48", "command_dispatcher: 1 commands popped off queue\n")
+    BENCHMARK_DEBUG_LINE("command_dispatcher_task.c:134", "command-dispatcher: Forwarding operation 1 to Watchdog task\n")
+    BENCHMARK_DEBUG_LINE("watchdog_main.c:146", "watchdog: Command popped off queue. Target: 536873628, Operation: 1\n")
+    BENCHMARK_DEBUG_LINE("watchdog_task.c:94", "watchdog: Task Manager task checked in\n")
+    BENCHMARK_DEBUG_LINE("watchdog_main.c:173", "watchdog: Checked in with itself\n")
+    BENCHMARK_DEBUG_LINE("watchdog_task.c:178", "hardware-watchdog: Petted\n")
+    BENCHMARK_DEBUG_LINE("task_manager_main.c:57", "\n---------- Task Manager Task Loop ----------\n")
+    BENCHMARK_DEBUG_LINE("task_manager_main.c:62", "task_manager: Command popped off queue. Target: 536873444, Operation: 2\n")
+    BENCHMARK_DEBUG_LINE("task_manager_task.c:87", "task_manager: Display task enabled\n")
+    BENCHMARK_DEBUG_LINE("task_manager_main.c:67", "task_manager: No more commands queued.\n")
+    BENCHMARK_DEBUG_LINE("display_main.c:38", "\n---------- Display Task Loop ----------\n")
+    BENCHMARK_DEBUG_LINE("display_main.c:47", "display: Command popped off queue. Target: 536873512, Operation: 1\n")
+    BENCHMARK_DEBUG_LINE("display_task.c:28", "display: Displaying new image\n")
+    BENCHMARK_DEBUG_LINE("display_main.c:52", "display: No more commands queued.\n")
+    BENCHMARK_DEBUG_LINE("heartbeat_main.c:42", "heartbeat: Current time is 42000\n")
+    BENCHMARK_DEBUG_LINE("heartbeat_main.c:83", "heartbeat: Checked in with watchdog\n");
+
+// Warnings and fatal errors as the flight code logs them (its format strings, with plausible arguments), in the order
+// they might fill the crash log during a bad pass
+#define BENCHMARK_CRASH_LOG_MESSAGES 16
+
+/**
+ * \fn benchmark_crash_log_write
+ *
+ * \brief Writes one record into a crash log that is not the one in backup RAM
+ */
+static void benchmark_crash_log_write(crash_log_t *const p_log, log_kind_t kind, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    crash_log_write(p_log, kind, NULL, 0, format, &args);
+    va_end(args);
+}
+
+/**
+ * \fn benchmark_fill_crash_log
+ *
+ * \brief Fills a crash log with every slot written, from messages the flight code actually logs with `warning()` and
+ *        `fatal()`
+ */
+static void benchmark_fill_crash_log(crash_log_t *const p_log) {
+    memset(p_log, 0, sizeof(*p_log));
+    for (uint32_t i = 0; i < CRASH_LOG_CAPACITY; i++) {
+        switch (i % BENCHMARK_CRASH_LOG_MESSAGES) {
+            case 0:
+            case 1:
+            case 2:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING, "command-dispatcher: %s lane full, dropped operation %d\n",
+                                          "Display", 4 + i % 2);
+                break;
+            case 3:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING,
+                                          "command-dispatcher: %s lane full, dropped oldest command (operation %d)\n", "ADCS", 7);
+                break;
+            case 4:
+            case 5:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING, "display: Failed to display image. Error code: %d\n", 3);
+                break;
+            case 6:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING,
+                                          "command-dispatcher: %s task timed out waiting for operation %d\n", "Shell", 2);
+                break;
+            case 7:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING, "adcs task: magnetometer device check failed after read failure\n");
+                break;
+            case 8:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING,
+                                          "task_manager: Restarted %s task in %d us (%d commands discarded, restart %d of %d); "
+                                          "a reboot takes %d us\n",
+                                          "Display", 180 + i, 2, 1 + i / BENCHMARK_CRASH_LOG_MESSAGES, 3, 412000);
+                break;
+            case 9:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING, "cosmic_monkey: Flipped bit at address 0x%08x\n", 0x20001A3C + 4 * i);
+                break;
+            case 10:
+            case 11:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING, "adcs task: photodiode read failed\n");
+                break;
+            case 12:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING,
+                                          "command-dispatcher: command metadata pool exhausted, dropped operation %d\n", 1);
+                break;
+            case 13:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING,
+                                          "command-schedule: Timer command queue full, periodic commands are stalled until the "
+                                          "next change\n");
+                break;
+            case 14:
+                benchmark_crash_log_write(p_log, LOG_KIND_WARNING, "shell: Command length limit reached! (Max: %d)\n", 256);
+                break;
+            default:
+                benchmark_crash_log_write(p_log, LOG_KIND_FATAL, "watchdog: %s task could not be restarted, resetting the system\n",
+                                          "Display");
+                break;
+        }
+    }
+}
+
+/**
+ * \fn benchmark_compress_buffer
+ *
+ * \brief Compresses a buffer into SPP-sized payloads `BENCHMARK_COMPRESS_ITERATIONS` times and reports the compressed
+ *        size and the cycles spent per input byte
+ *
+ * \param name what the buffer holds, for the report
+ * \param p_input the buffer
+ * \param size its size in bytes
+ */
+static void benchmark_compress_buffer(const char *name, const uint8_t *const p_input, size_t size) {
+    static log_compressor_t compressor; // Too large for the stack
+    static uint8_t payload[LOG_COMPRESS_PAYLOAD_SIZE];
+    static uint32_t samples[BENCHMARK_COMPRESS_ITERATIONS];
+    size_t compressed = 0;
+    size_t payloads = 0;
+
+    for (size_t i = 0; i < BENCHMARK_COMPRESS_ITERATIONS; i++) {
+        memset(&compressor, 0, sizeof(compressor));
+        compressed = 0;
+        payloads = 0;
+        size_t offset = 0;
+        const uint32_t start = get_cycle_count();
+        do {
+            log_compressor_start(&compressor, payload, sizeof(payload));
+            offset += log_compressor_sink(&compressor, &p_input[offset], size - offset);
+            compressed += log_compressor_finish(&compressor);
+            payloads++;
+        } while (offset < size || log_compressor_pending(&compressor) > 0);
+        samples[i] = get_cycle_count() - start;
+    }
+
+    const benchmark_result_t result = benchmark_summarize(samples, BENCHMARK_COMPRESS_ITERATIONS);
+    test_log("%s: %u bytes -> %u bytes in %u payloads of up to %u bytes (%u.%u%% of the original size)\n", name, size, compressed,
+             payloads, LOG_COMPRESS_PAYLOAD_SIZE, compressed * 100 / size, (compressed * 1000 / size) % 10);
+    test_log("  mean %u cycles per byte (%u us in total), min %u, max %u cycles per byte\n", result.mean_cycles / size,
+             cycles_to_us(result.mean_cycles), result.min_cycles / size, result.max_cycles / size);
+}
+
+/**
+ * \fn benchmark_log_compress
+ *
+ * \brief Compresses a full crash log, as the shell's `crashlog zip` downlinks it, and a sample of debug log text into
+ *        SPP-sized payloads, reporting the compression ratios and the cycles spent per input byte. The crash log is
+ *        built with `crash_log_write()` from the flight code's own warning and fatal messages, so its ratio is the one
+ *        to plan downlink with; the debug text is hand-assembled and its ratio is illustrative only.
+ */
+void benchmark_log_compress(void) {
+    test_log("----- benchmarking log compression -----\n");
+
+    static crash_log_t crash_log; // Too large for the stack
+    benchmark_fill_crash_log(&crash_log);
+    benchmark_compress_buffer("crash log records", (const uint8_t *)crash_log.records, sizeof(crash_log.records));
+    benchmark_compress_buffer("debug log text (illustrative sample)", (const uint8_t *)benchmark_log_capture,
+                              sizeof(benchmark_log_capture) - 1);
+}
+
+/**
+ * \fn main_benchmark
+ *
+ * \brief Entry point of the benchmark task. Runs the benchmarks that need the scheduler, then deletes itself.
+ *
+ * \param pvParameters unused
+ */
+static void main_benchmark(void *pvParameters) {
+    vTaskDelay(pdMS_TO_TICKS(BENCHMARK_TASK_START_DELAY_MS));
+    benchmark_dispatch_latency();
+    benchmark_burst_context_switches();
+    benchmark_checkin_dispatcher_load();
+    benchmark_task_restart();
+    benchmark_mode_transitions();
+    benchmark_run_time_stats();
+    benchmark_periodic_release();
+    vTaskDelete(NULL);
+}
+
+/**
+ * \fn benchmarks_start_task
+ *
+ * \brief Creates the benchmark task, which runs once the scheduler has started
+ */
+void benchmarks_start_task(void) {
+    TaskHandle_t handle = xTaskCreateStatic(main_benchmark, "Benchmark", BENCHMARK_TASK_STACK_SIZE, NULL, BENCHMARK_TASK_PRIORITY,
+                                            benchmark_task_stack, &benchmark_task_tcb);
+    if (handle == NULL) {
+        warning("Benchmark Task Creation Failed!\n");
+    }
+}
+
+/**
+ * \fn benchmarks_run
+ *
+ * \brief Runs every benchmark in sequence
+ */
+void benchmarks_run(void) {
+    benchmark_command_encoding();
+    benchmark_checkin_paths();
+    benchmark_log_ring();
+    benchmark_log_compress();
+}
+
+#endif // UNITTEST
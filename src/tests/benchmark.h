@@ -0,0 +1,50 @@
+/**
+ * src/tests/benchmark.h
+ *
+ * header file for on-target performance benchmarks (unit test builds only)
+ *
+ * Created: October 17, 2026
+ * Authors: PVDX Flight Software Team
+ */
+#ifndef TESTS_BENCHMARK_H
+#define TESTS_BENCHMARK_H
+
+#include <stdint.h>
+
+#define BENCHMARK_ITERATIONS 100           // Number of samples taken by each benchmark
+#define BENCHMARK_TASK_STACK_SIZE 512      // Size of the benchmark task's stack in words (multiply by 4 to get bytes)
+#define BENCHMARK_TASK_PRIORITY 1          // Below every OS task, so that sending them a command can preempt the benchmark
+#define BENCHMARK_TASK_START_DELAY_MS 2000 // Lets the OS tasks start and register with the watchdog before benchmarking
+#define BENCHMARK_LATENCY_TIMEOUT_MS 500   // How long the dispatch latency benchmark waits for each command to be executed
+#define BENCHMARK_BURST_COMMANDS 100       // Number of commands sent by the burst benchmark
+#define BENCHMARK_BURST_SIZE 5             // Number of commands in each burst (must fit in the watchdog's urgent lane)
+#define BENCHMARK_BURST_GAP_MS 10          // Time between bursts for the target to drain its lane
+#define BENCHMARK_LOAD_WINDOW_MS 5000      // How long the dispatcher load is sampled in each checkin mode
+#define BENCHMARK_LOAD_SETTLE_MS 500       // Time allowed after switching checkin mode before sampling
+#define BENCHMARK_MODE_TRANSITIONS 10      // Number of mode transitions timed (must be even, so that the last one enters safe mode)
+#define BENCHMARK_PERIOD_MS 20             // Period of the periodic release benchmark
+#define BENCHMARK_PERIOD_RELEASES 50       // Number of jobs run by the periodic release benchmark with each release method
+#define BENCHMARK_COMPRESS_ITERATIONS 10   // Number of times the log compression benchmark compresses its sample
+
+// Summary of a set of cycle-count samples
+typedef struct {
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t mean_cycles;
+} benchmark_result_t;
+
+void benchmarks_run(void);
+void benchmarks_start_task(void);
+void benchmark_dispatch_latency(void);
+void benchmark_command_encoding(void);
+void benchmark_burst_context_switches(void);
+void benchmark_checkin_paths(void);
+void benchmark_checkin_dispatcher_load(void);
+void benchmark_task_restart(void);
+void benchmark_mode_transitions(void);
+void benchmark_run_time_stats(void);
+void benchmark_periodic_release(void);
+void benchmark_log_ring(void);
+void benchmark_log_compress(void);
+
+#endif // TESTS_BENCHMARK_H
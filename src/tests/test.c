@@ -1,10 +1,26 @@
 
 #include "tests/test.h"
 
+#include "tests/benchmark.h"
+
 #include "ccsds/cfdp_pdu.h"
 #include "ccsds/spp.h"
+#include "command_dispatcher_task.h"
+#include "command_encoding.h"
+#include "command_schedule.h"
+#include "command_trace.h"
+#include "crash_log.h"
 #include "linalg/LinearAlgebra/declareFunctions.h"
+#include "log_compress.h"
+#include "log_ring.h"
+#include "log_tokens.h"
 #include "logging.h"
+#include "run_time_stats.h"
+#include "stack_usage.h"
+#include "task_list.h"
+#include "task_period.h"
+#include "tickless_clock.h"
+#include "watchdog_task.h"
 
 int tests_passed = 0;
 int tests_total = 0;
@@ -12,12 +28,55 @@ int tests_total = 0;
 void test_spp(void);
 void test_matrix_product(void);
 void test_cfdp(void);
+void test_command_lanes(void);
+void test_overflow_policies(void);
+void test_command_trace(void);
+void test_command_batches(void);
+void test_command_routing(void);
+void test_command_encoding(void);
+void test_command_completion(void);
+void test_watchdog_checkins(void);
+void test_task_restart(void);
+void test_mode_profiles(void);
+void test_run_time_stats(void);
+void test_stack_usage(void);
+void test_task_periods(void);
+void test_tickless_clock(void);
+void test_command_schedule(void);
+void test_log_tokens(void);
+void test_log_modules(void);
+void test_log_ring(void);
+void test_crash_log(void);
+void test_log_compress(void);
 
 void tests_run(void) {
     test_spp();
     test_matrix_product();
     test_cfdp();
+    test_command_lanes();
+    test_overflow_policies();
+    test_command_trace();
+    test_command_batches();
+    test_command_routing();
+    test_command_encoding();
+    test_command_completion();
+    test_watchdog_checkins();
+    test_task_restart();
+    test_mode_profiles();
+    test_run_time_stats();
+    test_stack_usage();
+    test_task_periods();
+    test_tickless_clock();
+    test_command_schedule();
+    test_log_tokens();
+    test_log_modules();
+    test_log_ring();
+    test_crash_log();
+    test_log_compress();
     test_log("test results: %d/%d passed", tests_passed, tests_total);
+#ifdef UNITTEST
+    benchmarks_run();
+#endif
 }
 
 // #ifdef UNITTEST
@@ -218,3 +277,960 @@ void test_cfdp(void) {
     PVDX_ASSERT(filedata.data.data[1] == 0xFE && "data[1]");
 }
 // #endif
+
+void test_command_lanes(void) {
+    test_log("----- testing command lanes -----\n");
+
+    // Queue a normal-lane command ahead of an urgent one; the urgent one must still be received first
+    command_t cmd_normal = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_INIT_SUBTASKS,
+        .data = {0},
+        .data_type = CMD_DATA_NONE,
+        .result = NO_STATUS_RETURN,
+    };
+    command_t cmd_urgent = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_POWER_OFF,
+        .data = {0},
+        .data_type = CMD_DATA_NONE,
+        .result = NO_STATUS_RETURN,
+    };
+    command_t received;
+    const command_lane_stats_t urgent_before = p_task_manager_task->lane_stats[COMMAND_LANE_URGENT];
+    const command_lane_stats_t normal_before = p_task_manager_task->lane_stats[COMMAND_LANE_NORMAL];
+
+    PVDX_ASSERT_MSG(dispatch_command(&cmd_normal) == SUCCESS, "dispatch normal command\n");
+    PVDX_ASSERT_MSG(dispatch_unrouted_command(&cmd_urgent) == SUCCESS, "dispatch urgent command\n");
+
+    bool ok = receive_command(p_task_manager_task, &received, 0);
+    PVDX_ASSERT_MSG(ok && received.operation == OPERATION_POWER_OFF, "urgent lane drained first\n");
+    ok = receive_command(p_task_manager_task, &received, 0);
+    PVDX_ASSERT_MSG(ok && received.operation == OPERATION_INIT_SUBTASKS, "normal lane drained second\n");
+    PVDX_ASSERT_MSG(!receive_command(p_task_manager_task, &received, 0), "lanes empty\n");
+
+    test_log("urgent lane commands received: %u\n", p_task_manager_task->lane_stats[COMMAND_LANE_URGENT].commands_received);
+    PVDX_ASSERT_MSG(p_task_manager_task->lane_stats[COMMAND_LANE_URGENT].commands_received == urgent_before.commands_received + 1,
+                    "urgent lane counter\n");
+
+    // The queue set reported the normal command first, so both commands were read out of order
+    PVDX_ASSERT_MSG(p_task_manager_task->lane_stats[COMMAND_LANE_URGENT].out_of_order == urgent_before.out_of_order + 1,
+                    "urgent command overtook the normal one\n");
+    PVDX_ASSERT_MSG(p_task_manager_task->lane_stats[COMMAND_LANE_NORMAL].out_of_order == normal_before.out_of_order + 1,
+                    "normal command read on the urgent entry\n");
+}
+
+void test_overflow_policies(void) {
+    test_log("----- testing overflow policies -----\n");
+
+    command_t received;
+    size_t received_count;
+    command_dispatcher_stats_t stats_before = get_command_dispatcher_stats();
+
+    // Coalesce: a second identical checkin is merged into the one already queued
+    command_t cmd_checkin = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_CHECKIN,
+        .data.pvdx_task = p_task_manager_task,
+        .data_type = CMD_DATA_PVDX_TASK,
+        .result = NO_STATUS_RETURN,
+    };
+    PVDX_ASSERT_MSG(dispatch_unrouted_command(&cmd_checkin) == SUCCESS, "coalesce first checkin\n");
+    PVDX_ASSERT_MSG(dispatch_unrouted_command(&cmd_checkin) == SUCCESS, "coalesce second checkin\n");
+    received_count = 0;
+    while (receive_command(p_task_manager_task, &received, 0)) {
+        received_count++;
+    }
+    test_log("checkins received after coalescing: %u\n", (unsigned)received_count);
+    PVDX_ASSERT_MSG(received_count == 1, "duplicate checkin coalesced\n");
+    PVDX_ASSERT_MSG(get_command_dispatcher_stats().coalesced == stats_before.coalesced + 1, "coalesce counter\n");
+
+    // Drop newest: once the lane is full, new commands are rejected
+    command_t cmd_test = {
+        .target = p_task_manager_task,
+        .operation = TEST_OP,
+        .data = {0},
+        .data_type = CMD_DATA_NONE,
+        .result = NO_STATUS_RETURN,
+    };
+    for (size_t i = 0; i < COMMAND_QUEUE_MAX_COMMANDS; i++) {
+        dispatch_unrouted_command(&cmd_test);
+    }
+    PVDX_ASSERT_MSG(dispatch_unrouted_command(&cmd_test) == ERROR_QUEUE_FULL, "drop newest rejects command\n");
+    PVDX_ASSERT_MSG(get_command_dispatcher_stats().dropped_newest == stats_before.dropped_newest + 1, "drop newest counter\n");
+    received_count = 0;
+    while (receive_command(p_task_manager_task, &received, 0)) {
+        received_count++;
+    }
+    PVDX_ASSERT_MSG(received_count == COMMAND_QUEUE_MAX_COMMANDS, "drop newest keeps queued commands\n");
+
+    // Drop oldest: once the lane is full, the oldest command makes room for the new one
+    command_t cmd_read = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_READ,
+        .data = {0},
+        .data_type = CMD_DATA_NONE,
+        .result = NO_STATUS_RETURN,
+    };
+    const uint32_t empty_wakeups_before = p_task_manager_task->lane_stats[COMMAND_LANE_NORMAL].empty_wakeups;
+    for (size_t i = 0; i < COMMAND_QUEUE_MAX_COMMANDS; i++) {
+        dispatch_unrouted_command(&cmd_read);
+    }
+    PVDX_ASSERT_MSG(dispatch_unrouted_command(&cmd_read) == SUCCESS, "drop oldest accepts command\n");
+    PVDX_ASSERT_MSG(get_command_dispatcher_stats().dropped_oldest == stats_before.dropped_oldest + 1, "drop oldest counter\n");
+    received_count = 0;
+    while (receive_command(p_task_manager_task, &received, 0)) {
+        received_count++;
+    }
+    PVDX_ASSERT_MSG(received_count == COMMAND_QUEUE_MAX_COMMANDS, "drop oldest keeps lane full\n");
+    PVDX_ASSERT_MSG(p_task_manager_task->queue_set_surplus == 0, "queue set back in step\n");
+    PVDX_ASSERT_MSG(p_task_manager_task->lane_stats[COMMAND_LANE_NORMAL].empty_wakeups == empty_wakeups_before + 1,
+                    "dropped command's entry counted as an empty wakeup\n");
+}
+
+void test_command_trace(void) {
+    test_log("----- testing command trace -----\n");
+
+    command_t cmd_test = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_ENABLE_SUBTASK,
+        .data.pvdx_task = p_heartbeat_task,
+        .data_type = CMD_DATA_PVDX_TASK,
+        .result = NO_STATUS_RETURN,
+    };
+    command_t received;
+    const size_t task_index = p_task_manager_task->task_index;
+
+    // Take one command through its whole lifecycle
+    const dispatch_mode_t mode_before = get_dispatch_mode();
+    set_dispatch_mode(DISPATCH_MODE_DIRECT);
+    command_trace_reset();
+    PVDX_ASSERT_MSG(enqueue_command(&cmd_test) == SUCCESS, "enqueue traced command\n");
+    PVDX_ASSERT_MSG(receive_command(p_task_manager_task, &received, 0), "receive traced command\n");
+    received.result = SUCCESS;
+    complete_command(&received);
+    set_dispatch_mode(mode_before);
+
+    command_trace_event_t events[NUM_TRACE_STAGES + 1];
+    const size_t count = command_trace_read_events(events, NUM_TRACE_STAGES + 1);
+    test_log("trace events recorded: %u\n", (unsigned)count);
+    PVDX_ASSERT_MSG(count == NUM_TRACE_STAGES, "one event per stage\n");
+    for (size_t i = 0; i < count; i++) {
+        PVDX_ASSERT_MSG(events[i].stage == i && events[i].trace_id == cmd_test.trace_id, "events in lifecycle order\n");
+    }
+
+    command_trace_histogram_t histogram;
+    PVDX_ASSERT_MSG(command_trace_get_histogram(task_index, OPERATION_ENABLE_SUBTASK, TRACE_INTERVAL_EXEC, &histogram),
+                    "exec histogram\n");
+    PVDX_ASSERT_MSG(!command_trace_get_histogram(task_index, OPERATION_DISABLE_SUBTASK, TRACE_INTERVAL_EXEC, &histogram),
+                    "histograms kept per operation\n");
+    PVDX_ASSERT_MSG(!command_trace_get_histogram(task_index, OPERATION_READ, TRACE_INTERVAL_EXEC, &histogram),
+                    "no histogram without a route\n");
+    PVDX_ASSERT_MSG(command_trace_get_high_water_mark(task_index, COMMAND_LANE_NORMAL) == 1, "normal lane high-water mark\n");
+
+    // The dump starts with the magic number and holds every event when the buffer is large enough
+    uint8_t dump[256];
+    const size_t dump_size = command_trace_serialize(dump, sizeof(dump));
+    test_log("trace dump size: %u bytes\n", (unsigned)dump_size);
+    PVDX_ASSERT_MSG(dump_size > 0 && (dump[0] | (dump[1] << 8)) == COMMAND_TRACE_DUMP_MAGIC, "dump magic\n");
+    PVDX_ASSERT_MSG((dump[14] | (dump[15] << 8)) == NUM_TRACE_STAGES, "dump event count\n");
+    const size_t first_histogram = 16 + NUM_TASKS * NUM_COMMAND_LANES;
+    PVDX_ASSERT_MSG(dump[first_histogram] == task_index && dump[first_histogram + 1] == OPERATION_ENABLE_SUBTASK, "dump histogram key\n");
+    PVDX_ASSERT_MSG(command_trace_serialize(dump, 8) == 0, "dump rejects small buffer\n");
+
+    command_trace_reset();
+}
+
+void test_command_batches(void) {
+    test_log("----- testing command batches -----\n");
+
+    const command_t cmd_test = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_ENABLE_SUBTASK,
+        .data.pvdx_task = p_heartbeat_task,
+        .data_type = CMD_DATA_PVDX_TASK,
+        .result = NO_STATUS_RETURN,
+    };
+    const command_t burst[] = {cmd_test, cmd_test, cmd_test};
+    const size_t burst_size = sizeof(burst) / sizeof(burst[0]);
+    command_t received[COMMAND_DISPATCH_BATCH_MAX];
+    size_t received_count;
+    const dispatch_mode_t mode_before = get_dispatch_mode();
+
+    // Direct mode: the whole burst lands in the target's lane
+    set_dispatch_mode(DISPATCH_MODE_DIRECT);
+    PVDX_ASSERT_MSG(enqueue_commands(burst, burst_size) == SUCCESS, "direct batch enqueued\n");
+    received_count = 0;
+    while (receive_command(p_task_manager_task, &received[0], 0)) {
+        received_count++;
+    }
+    PVDX_ASSERT_MSG(received_count == burst_size, "direct batch received\n");
+
+    // Hub mode: the burst goes through the Command Dispatcher queue and is forwarded as one batch
+    set_dispatch_mode(DISPATCH_MODE_HUB);
+    PVDX_ASSERT_MSG(enqueue_commands(burst, burst_size) == SUCCESS, "hub batch enqueued\n");
+    received_count = 0;
+    while (received_count < COMMAND_DISPATCH_BATCH_MAX && receive_command(p_command_dispatcher_task, &received[received_count], 0)) {
+        received_count++;
+    }
+    PVDX_ASSERT_MSG(received_count == burst_size, "hub batch reached dispatcher\n");
+    PVDX_ASSERT_MSG(dispatch_commands(received, received_count) == SUCCESS, "hub batch forwarded\n");
+    received_count = 0;
+    while (receive_command(p_task_manager_task, &received[0], 0)) {
+        received_count++;
+    }
+    PVDX_ASSERT_MSG(received_count == burst_size, "hub batch received\n");
+
+    set_dispatch_mode(mode_before);
+}
+
+void test_command_routing(void) {
+    test_log("----- testing command routing -----\n");
+
+    command_t received;
+
+    // An operation the target has no route for is rejected when it is enqueued
+    command_t cmd_no_route = {
+        .target = p_watchdog_task,
+        .operation = OPERATION_DISPLAY_IMAGE,
+        .data = {0},
+        .data_type = CMD_DATA_DISPLAY,
+        .result = NO_STATUS_RETURN,
+    };
+    PVDX_ASSERT_MSG(get_command_route(p_watchdog_task, OPERATION_DISPLAY_IMAGE) == NULL, "watchdog has no display route\n");
+    PVDX_ASSERT_MSG(enqueue_command(&cmd_no_route) == ERROR_INVALID_COMMAND, "unrouted operation rejected\n");
+    PVDX_ASSERT_MSG(cmd_no_route.result == ERROR_INVALID_COMMAND, "unrouted operation result\n");
+    PVDX_ASSERT_MSG(dispatch_command(&cmd_no_route) == ERROR_INVALID_COMMAND, "unrouted operation not forwarded\n");
+
+    // So is a routed operation sent with the wrong data type
+    command_t cmd_wrong_data = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_ENABLE_SUBTASK,
+        .data = {0},
+        .data_type = CMD_DATA_NONE,
+        .result = NO_STATUS_RETURN,
+    };
+    PVDX_ASSERT_MSG(enqueue_command(&cmd_wrong_data) == ERROR_INVALID_COMMAND, "wrong data type rejected\n");
+    PVDX_ASSERT_MSG(!receive_command(p_task_manager_task, &received, 0), "rejected commands never queued\n");
+
+    // The checkin route points at the watchdog's handler and accepts the command built by its getter
+    const command_route_t *const p_route = get_command_route(p_watchdog_task, OPERATION_CHECKIN);
+    PVDX_ASSERT_MSG(p_route != NULL && p_route->handler == exec_command_watchdog_checkin, "checkin routed to watchdog\n");
+    command_t cmd_checkin = get_watchdog_checkin_command(p_task_manager_task);
+    PVDX_ASSERT_MSG(validate_command(&cmd_checkin) == SUCCESS, "checkin command valid\n");
+}
+
+void test_command_encoding(void) {
+    test_log("----- testing command encoding -----\n");
+
+    packed_command_t packed;
+    command_t received;
+
+    // A command survives the round trip through its packed form, metadata included
+    command_t cmd = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_ENABLE_SUBTASK,
+        .data = {.pvdx_task = p_heartbeat_task},
+        .data_type = CMD_DATA_PVDX_TASK,
+        .result = NO_STATUS_RETURN,
+        .enqueued_cycles = 0x12345679,
+        .requester = p_shell_task,
+        .completion_sequence = 7,
+        .trace_id = 42,
+        .submitted_cycles = 0x12345000,
+    };
+    PVDX_ASSERT_MSG(pack_command(&cmd, &packed), "metadata slot assigned\n");
+    PVDX_ASSERT_MSG(packed.target_index == TASK_INDEX_TASK_MANAGER, "target packed as its task index\n");
+    unpack_command(&packed, &received);
+    PVDX_ASSERT_MSG(received.target == p_task_manager_task && received.operation == OPERATION_ENABLE_SUBTASK, "target and operation\n");
+    PVDX_ASSERT_MSG(received.data.pvdx_task == p_heartbeat_task && received.data_type == CMD_DATA_PVDX_TASK, "data pointer and type\n");
+    PVDX_ASSERT_MSG(received.requester == p_shell_task && received.completion_sequence == 7, "completion metadata\n");
+    PVDX_ASSERT_MSG(received.trace_id == 42 && received.enqueued_cycles == 0x12345679, "timing metadata\n");
+    PVDX_ASSERT_MSG(received.result == PROCESSING, "unpacked commands are processing\n");
+
+    // Hold every slot a command nobody waits on may take (commands left queued by earlier tests may still own some)
+    static packed_command_t held[COMMAND_META_POOL_SIZE];
+    size_t num_held = 0;
+    command_t cmd_untimed = cmd;
+    cmd_untimed.requester = NULL;
+    while (num_held < COMMAND_META_POOL_SIZE && pack_command(&cmd_untimed, &held[num_held])) {
+        num_held++;
+    }
+    PVDX_ASSERT_MSG(num_held > 0, "unpacking freed its metadata slot\n");
+
+    // Once the pool is exhausted a command still packs, but arrives untimed
+    PVDX_ASSERT_MSG(!pack_command(&cmd_untimed, &packed) && packed.meta_slot == COMMAND_META_NONE,
+                    "exhausted pool packs without metadata\n");
+    unpack_command(&packed, &received);
+    PVDX_ASSERT_MSG(received.enqueued_cycles == 0 && received.requester == NULL, "untimed command\n");
+
+    // A command with a waiting requester can still take one of the reserved slots, until those run out too
+    size_t num_reserved = 0;
+    while (num_held < COMMAND_META_POOL_SIZE && pack_command(&cmd, &held[num_held])) {
+        num_held++;
+        num_reserved++;
+    }
+    test_log("reserved metadata slots: %u\n", (unsigned)num_reserved);
+    PVDX_ASSERT_MSG(num_reserved == COMMAND_META_RESERVED_SLOTS, "waited-on commands keep their slots\n");
+    PVDX_ASSERT_MSG(!pack_command(&cmd, &packed) && packed.meta_slot == COMMAND_META_NONE, "reserved slots exhausted\n");
+    for (size_t i = 0; i < num_held; i++) {
+        release_command_meta(&held[i]);
+    }
+}
+
+void test_command_completion(void) {
+    test_log("----- testing command completion -----\n");
+
+    // A waiting requester (ADCS stands in for one; it is created but has not run) gets the result of its current wait
+    const TaskHandle_t requester = p_adcs_task->handle;
+    const uint32_t sequence_before = p_adcs_task->completion_sequence;
+    const uint32_t stale_before = get_command_dispatcher_stats().stale_completions;
+    const uint32_t expected_value = (5u << COMPLETION_RESULT_BITS) | SUCCESS;
+    command_t cmd = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_ENABLE_SUBTASK,
+        .data.pvdx_task = p_heartbeat_task,
+        .data_type = CMD_DATA_PVDX_TASK,
+        .result = SUCCESS,
+        .requester = p_adcs_task,
+        .completion_sequence = 5,
+    };
+    uint32_t notification_value = 0;
+    p_adcs_task->completion_sequence = 5;
+    xTaskNotifyStateClear(requester);
+
+    // (querying the value leaves a notification pending, so the pending state is checked first)
+    complete_command(&cmd);
+    PVDX_ASSERT_MSG(xTaskNotifyStateClear(requester) == pdTRUE, "current result delivered\n");
+    xTaskNotifyAndQuery(requester, 0, eNoAction, &notification_value);
+    xTaskNotifyStateClear(requester);
+    PVDX_ASSERT_MSG(notification_value == expected_value, "result tagged with its wait\n");
+
+    // The late result of a wait that already timed out is dropped instead of overwriting the current one
+    cmd.completion_sequence = 4;
+    cmd.result = ERROR_TIMEOUT;
+    complete_command(&cmd);
+    PVDX_ASSERT_MSG(xTaskNotifyStateClear(requester) == pdFALSE, "late result not delivered\n");
+    xTaskNotifyAndQuery(requester, 0, eNoAction, &notification_value);
+    xTaskNotifyStateClear(requester);
+    PVDX_ASSERT_MSG(notification_value == expected_value, "current result not overwritten\n");
+    PVDX_ASSERT_MSG(get_command_dispatcher_stats().stale_completions == stale_before + 1, "late result counted\n");
+
+    p_adcs_task->completion_sequence = sequence_before;
+}
+
+void test_watchdog_checkins(void) {
+    test_log("----- testing watchdog checkins -----\n");
+
+    command_t received;
+    const watchdog_checkin_mode_t original_mode = get_watchdog_checkin_mode();
+    const bool was_registered = p_task_manager_task->has_registered;
+    p_task_manager_task->has_registered = true;
+    while (receive_command(p_watchdog_task, &received, 0)) {
+        // Discard anything left queued for the watchdog by earlier tests
+    }
+
+    // A direct checkin stores the time in the task struct without sending any command
+    const watchdog_checkin_stats_t stats_before = get_watchdog_checkin_stats();
+    set_watchdog_checkin_mode(WATCHDOG_CHECKIN_DIRECT);
+    p_task_manager_task->last_checkin_time_ticks = WATCHDOG_CHECKIN_UNREGISTERED;
+    checkin_with_watchdog(p_task_manager_task);
+    PVDX_ASSERT_MSG(p_task_manager_task->last_checkin_time_ticks == xTaskGetTickCount(), "direct checkin stored\n");
+    PVDX_ASSERT_MSG(get_watchdog_checkin_stats().direct_checkins == stats_before.direct_checkins + 1, "direct checkin counted\n");
+    PVDX_ASSERT_MSG(!receive_command(p_watchdog_task, &received, 0), "direct checkin sends no command\n");
+
+    // In command mode the checkin goes through the dispatcher and is only stored once the watchdog executes it
+    set_watchdog_checkin_mode(WATCHDOG_CHECKIN_COMMAND);
+    p_task_manager_task->last_checkin_time_ticks = WATCHDOG_CHECKIN_UNREGISTERED;
+    checkin_with_watchdog(p_task_manager_task);
+    if (get_dispatch_mode() == DISPATCH_MODE_HUB) {
+        PVDX_ASSERT_MSG(receive_command(p_command_dispatcher_task, &received, 0), "checkin command reached dispatcher\n");
+        dispatch_command(&received);
+    }
+    PVDX_ASSERT_MSG(p_task_manager_task->last_checkin_time_ticks == WATCHDOG_CHECKIN_UNREGISTERED, "checkin command not yet run\n");
+    PVDX_ASSERT_MSG(receive_command(p_watchdog_task, &received, 0) && received.operation == OPERATION_CHECKIN, "checkin command queued\n");
+    exec_command(&received);
+    PVDX_ASSERT_MSG(p_task_manager_task->last_checkin_time_ticks == xTaskGetTickCount(), "checkin command stored\n");
+    PVDX_ASSERT_MSG(get_watchdog_checkin_stats().command_checkins == stats_before.command_checkins + 1, "checkin command counted\n");
+
+    // Each checkin adds the time since the previous one to the task's interval statistics
+    set_watchdog_checkin_mode(WATCHDOG_CHECKIN_DIRECT);
+    reset_watchdog_checkin_interval_stats();
+    PVDX_ASSERT_MSG(get_watchdog_checkin_interval_stats(p_task_manager_task).intervals == 0, "reset clears every copy\n");
+    const uint32_t timeout_ticks = pdMS_TO_TICKS(p_task_manager_task->watchdog_timeout_ms);
+    const uint32_t quarter_timeout_ticks = timeout_ticks / 4;
+    p_task_manager_task->last_checkin_time_ticks = xTaskGetTickCount() - quarter_timeout_ticks;
+    checkin_with_watchdog(p_task_manager_task);
+    const watchdog_checkin_record_t record = get_watchdog_checkin_record(p_task_manager_task);
+    PVDX_ASSERT_MSG(record.intervals == 1 && record.max_interval_ms == quarter_timeout_ticks * portTICK_PERIOD_MS, "interval recorded\n");
+    PVDX_ASSERT_MSG(record.min_margin_ms == (timeout_ticks - quarter_timeout_ticks) * portTICK_PERIOD_MS, "margin recorded\n");
+    PVDX_ASSERT_MSG(record.histogram[CHECKIN_HISTOGRAM_BINS / 4] == 1, "interval binned by fraction of the timeout\n");
+
+    p_task_manager_task->has_registered = was_registered;
+    set_watchdog_checkin_mode(original_mode);
+}
+
+void test_task_restart(void) {
+    test_log("----- testing task restart -----\n");
+
+    // OS tasks are never restarted; a missed checkin from one still resets the system
+    PVDX_ASSERT_MSG(task_manager_restart_task(p_watchdog_task) == ERROR_PROCESSING_FAILED, "OS task not restarted\n");
+
+    // A restarted task starts from empty lanes, and the commands it never ran are failed back to their senders
+    command_t cmd_test = {
+        .target = p_task_manager_task,
+        .operation = TEST_OP,
+        .data = {0},
+        .data_type = CMD_DATA_NONE,
+        .result = NO_STATUS_RETURN,
+    };
+    command_t cmd_urgent = {
+        .target = p_task_manager_task,
+        .operation = OPERATION_POWER_OFF,
+        .data = {0},
+        .data_type = CMD_DATA_NONE,
+        .result = NO_STATUS_RETURN,
+    };
+    command_t received;
+    PVDX_ASSERT_MSG(dispatch_unrouted_command(&cmd_test) == SUCCESS, "dispatch normal command\n");
+    PVDX_ASSERT_MSG(dispatch_unrouted_command(&cmd_urgent) == SUCCESS, "dispatch urgent command\n");
+    wake_task(p_task_manager_task);
+
+    const size_t flushed = flush_commands(p_task_manager_task, ERROR_TASK_RESTARTED);
+    test_log("commands flushed: %u\n", (unsigned)flushed);
+    PVDX_ASSERT_MSG(flushed == 2, "both lanes flushed\n");
+    PVDX_ASSERT_MSG(uxQueueMessagesWaiting(p_task_manager_task->command_queue_set) == 0, "queue set emptied\n");
+    PVDX_ASSERT_MSG(!receive_command(p_task_manager_task, &received, 0), "nothing left to receive\n");
+
+    // The wakeup semaphore must still reach the queue set after a flush
+    wake_task(p_task_manager_task);
+    PVDX_ASSERT_MSG(uxQueueMessagesWaiting(p_task_manager_task->command_queue_set) == 1, "wakeup still reaches queue set\n");
+    receive_command(p_task_manager_task, &received, 0);
+
+    // A hung subtask is replaced by a fresh one that is registered and can check in again. Its handle is the address of
+    // its static TCB, so the same pointer comes back; the new instance shows in its state instead.
+    const uint32_t restarts = get_task_restart_stats().restarts;
+    task_manager_enable_task(p_adcs_task);
+    vTaskSuspend(p_adcs_task->handle); // Stands in for a task that stopped running while still enabled
+    PVDX_ASSERT_MSG(eTaskGetState(p_adcs_task->handle) == eSuspended, "task hung before restart\n");
+    PVDX_ASSERT_MSG(task_manager_restart_task(p_adcs_task) == SUCCESS, "subtask restarted\n");
+    PVDX_ASSERT_MSG(get_task_restart_stats().restarts == restarts + 1, "restart counted\n");
+    PVDX_ASSERT_MSG(eTaskGetState(p_adcs_task->handle) == eReady, "new instance ready to run\n");
+    PVDX_ASSERT_MSG(pvTaskGetThreadLocalStoragePointer(p_adcs_task->handle, 0) == p_adcs_task, "new instance finds its task\n");
+    PVDX_ASSERT_MSG(p_adcs_task->has_registered, "re-registered with the watchdog\n");
+    PVDX_ASSERT_MSG(p_adcs_task->last_checkin_time_ticks != WATCHDOG_CHECKIN_UNREGISTERED, "check-in deadline restarted\n");
+
+    const uint32_t checkins = get_watchdog_checkin_stats().command_checkins;
+    const uint32_t intervals = get_watchdog_checkin_interval_stats(p_adcs_task).intervals;
+    watchdog_checkin(p_adcs_task); // Would be fatal for an unregistered task
+    PVDX_ASSERT_MSG(get_watchdog_checkin_stats().command_checkins == checkins + 1, "restarted task checks in\n");
+    PVDX_ASSERT_MSG(get_watchdog_checkin_interval_stats(p_adcs_task).intervals == intervals + 1, "check-in timed from restart\n");
+    task_manager_disable_task(p_adcs_task);
+}
+
+void test_mode_profiles(void) {
+    test_log("----- testing mode profiles -----\n");
+
+    // Every mode can be found by name, keeps the service tasks running, and no profile tries to switch off an OS task
+    for (size_t i = 0; i < NUM_MODES; i++) {
+        PVDX_ASSERT_MSG(get_mode_profile(mode_profiles[i].name) == &mode_profiles[i], "mode found by name\n");
+        PVDX_ASSERT_MSG(mode_profiles[i].mode == i, "profile at its mode's index\n");
+        PVDX_ASSERT_MSG((mode_profiles[i].enabled_tasks & MODE_SERVICE_TASKS) == MODE_SERVICE_TASKS, "service tasks enabled\n");
+        for (size_t t = 0; task_list[t] != NULL; t++) {
+            if (task_list[t]->task_type == OS) {
+                PVDX_ASSERT_MSG(mode_profiles[i].priorities[t] == MODE_PROFILE_KEEP, "OS task priority left alone\n");
+                PVDX_ASSERT_MSG(mode_profiles[i].watchdog_timeouts_ms[t] == MODE_PROFILE_KEEP, "OS task timeout left alone\n");
+            }
+        }
+    }
+    PVDX_ASSERT_MSG(get_mode_profile("cruise") == NULL, "unknown mode rejected\n");
+
+    // The command routes to the task manager with the profile as its data
+    const command_t cmd_set_mode = get_set_mode_command(&mode_profiles[MODE_NOMINAL]);
+    PVDX_ASSERT_MSG(validate_command(&cmd_set_mode) == SUCCESS, "set mode command routed\n");
+
+    // Before the task manager has created every subtask, a transition is refused without touching any task
+    const bool adcs_enabled = p_adcs_task->enabled;
+    PVDX_ASSERT_MSG(task_manager_set_mode(&mode_profiles[MODE_NOMINAL]) == ERROR_NOT_READY, "transition refused before init\n");
+    PVDX_ASSERT_MSG(p_adcs_task->enabled == adcs_enabled && get_current_mode() == NULL, "nothing changed\n");
+}
+
+void test_run_time_stats(void) {
+    test_log("----- testing run-time stats -----\n");
+
+    // Windows the kernel's 32-bit counters cannot cover are refused before anything is sampled
+    static run_time_report_t report;
+    PVDX_ASSERT_MSG(run_time_stats_measure(0, &report) == ERROR_SANITY_CHECK_FAILED, "empty window refused\n");
+    PVDX_ASSERT_MSG(run_time_stats_measure(RUN_TIME_STATS_MAX_WINDOW_MS + 1, &report) == ERROR_SANITY_CHECK_FAILED,
+                    "window past counter wrap refused\n");
+}
+
+void test_stack_usage(void) {
+    test_log("----- testing stack usage -----\n");
+
+    // Tasks created before the tests (OS and sensor tasks) have at least their initial context on the stack
+    stack_usage_sample();
+    const stack_usage_record_t adcs_record = get_stack_usage_record(p_adcs_task);
+    test_log("adcs: %u of %u stack words used\n", adcs_record.peak_used_words, adcs_record.stack_size_words);
+    PVDX_ASSERT_MSG(adcs_record.flags & STACK_USAGE_FLAG_RUNNING, "adcs is running\n");
+    PVDX_ASSERT_MSG(adcs_record.stack_size_words == p_adcs_task->stack_size, "stack size reported in words\n");
+    PVDX_ASSERT_MSG(adcs_record.peak_used_words > 0 && adcs_record.peak_used_words < adcs_record.stack_size_words,
+                    "initial context counted\n");
+    PVDX_ASSERT_MSG(adcs_record.peak_used_words + adcs_record.min_free_words == adcs_record.stack_size_words, "used + free\n");
+
+    // The peak never goes down, even if the current high-water mark is shallower
+    const uint32_t saved_peak_words = p_adcs_task->stack_peak_used_words;
+    p_adcs_task->stack_peak_used_words = p_adcs_task->stack_size - 1;
+    stack_usage_sample();
+    PVDX_ASSERT_MSG(get_stack_usage_record(p_adcs_task).peak_used_words == p_adcs_task->stack_size - 1, "peak kept\n");
+    PVDX_ASSERT_MSG(get_stack_usage_record(p_adcs_task).flags & STACK_USAGE_FLAG_LOW, "low stack flagged\n");
+    p_adcs_task->stack_peak_used_words = saved_peak_words;
+
+    // Tasks that have not been created yet are reported without a peak
+    const stack_usage_record_t display_record = get_stack_usage_record(p_display_task);
+    PVDX_ASSERT_MSG(!(display_record.flags & STACK_USAGE_FLAG_RUNNING) && display_record.peak_used_words == 0, "display not running\n");
+
+    static uint8_t buffer[NUM_TASKS * sizeof(stack_usage_record_t)];
+    PVDX_ASSERT_MSG(stack_usage_serialize(buffer, sizeof(buffer)) == sizeof(buffer), "one record per task\n");
+    PVDX_ASSERT_MSG(stack_usage_serialize(buffer, sizeof(stack_usage_record_t) + 1) == sizeof(stack_usage_record_t),
+                    "only whole records written\n");
+}
+
+void test_task_periods(void) {
+    test_log("----- testing task periods -----\n");
+
+    // Every profile must leave periodic tasks room to check in once per period
+    for (size_t mode = 0; mode < NUM_MODES; mode++) {
+        for (size_t i = 0; task_list[i] != NULL; i++) {
+            const uint32_t timeout_ms = mode_profiles[mode].watchdog_timeouts_ms[i];
+            PVDX_ASSERT_MSG(timeout_ms == MODE_PROFILE_KEEP || task_list[i]->period_ms <= timeout_ms / 2,
+                            "profile timeout fits the period\n");
+        }
+    }
+
+    // Event-driven tasks report an empty record; periodic ones report their period
+    PVDX_ASSERT_MSG(get_task_period_record(p_shell_task).period_ms == 0, "shell is event-driven\n");
+    PVDX_ASSERT_MSG(get_task_period_record(p_shell_task).releases == 0, "no releases for event-driven tasks\n");
+    PVDX_ASSERT_MSG(get_task_period_record(p_adcs_task).period_ms == p_adcs_task->period_ms && p_adcs_task->period_ms > 0,
+                    "adcs is periodic\n");
+
+    // The mean jitter is derived from the sum, and a reset keeps the schedule
+    const task_period_stats_t saved_stats = p_adcs_task->period_stats;
+    p_adcs_task->period_stats.last_release_ticks = 1234;
+    p_adcs_task->period_stats.jitter_samples = 4;
+    p_adcs_task->period_stats.total_jitter_us = 100;
+    p_adcs_task->period_stats.overruns = 2;
+    PVDX_ASSERT_MSG(get_task_period_record(p_adcs_task).mean_jitter_us == 25, "mean jitter\n");
+    reset_task_period_stats();
+    PVDX_ASSERT_MSG(p_adcs_task->period_stats.overruns == 0 && p_adcs_task->period_stats.jitter_samples == 0, "stats reset\n");
+    PVDX_ASSERT_MSG(p_adcs_task->period_stats.last_release_ticks == 1234, "schedule kept\n");
+    p_adcs_task->period_stats = saved_stats;
+
+    static uint8_t buffer[NUM_TASKS * sizeof(task_period_record_t)];
+    PVDX_ASSERT_MSG(task_period_serialize(buffer, sizeof(buffer)) == sizeof(buffer), "one record per task\n");
+}
+
+void test_tickless_clock(void) {
+    test_log("----- testing tickless clock -----\n");
+
+    // Conversions between the tick timer and clock units agree to within a few timer counts
+    const uint32_t counts_per_tick = 120000;
+    const uint32_t half_tick = tickless_clock_units_from_timer(counts_per_tick / 2, counts_per_tick);
+    PVDX_ASSERT_MSG(half_tick == TICKLESS_UNITS_PER_TICK / 2, "half a tick\n");
+    PVDX_ASSERT_MSG(tickless_clock_timer_from_units(half_tick, counts_per_tick) == counts_per_tick / 2, "round trip\n");
+    PVDX_ASSERT_MSG(tickless_clock_units_from_timer(counts_per_tick, counts_per_tick) < TICKLESS_UNITS_PER_TICK, "stays in the tick\n");
+
+    // Nothing to sleep for when the unblock time is the next tick
+    tickless_clock_t clock = {.units_into_tick = 0, .owed_ticks = 0};
+    PVDX_ASSERT_MSG(tickless_clock_sleep_counts(&clock, 1) == 0, "no sleep for one tick\n");
+    clock.owed_ticks = 2;
+    PVDX_ASSERT_MSG(tickless_clock_sleep_counts(&clock, 3) == 0, "owed ticks shorten the sleep\n");
+
+    // Simulate sleeps of random length (some cut short by interrupts, some overslept) separated by time awake, and
+    // check that the kernel's tick count plus the owed ticks always matches real time and sleeps never pass the
+    // unblock time
+    clock = (tickless_clock_t){.units_into_tick = 0, .owed_ticks = 0};
+    uint64_t real_units = 0;
+    uint64_t kernel_ticks = 0;
+    uint32_t seed = 12345;
+    bool time_kept = true;
+    bool woke_in_time = true;
+    bool stepped_in_range = true;
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 1103515245 + 12345;
+        const uint32_t random = seed >> 8;
+
+        // Awake: the tick timer runs and the kernel counts ticks normally (owed ticks stay owed)
+        const uint32_t awake_units = random % (3 * TICKLESS_UNITS_PER_TICK);
+        real_units += awake_units;
+        kernel_ticks += (clock.units_into_tick + awake_units) / TICKLESS_UNITS_PER_TICK;
+        clock.units_into_tick = (clock.units_into_tick + awake_units) % TICKLESS_UNITS_PER_TICK;
+
+        // Asleep
+        const uint32_t expected_idle_ticks = 2 + (random >> 4) % 40;
+        uint32_t slept_counts = tickless_clock_sleep_counts(&clock, expected_idle_ticks);
+        const uint64_t wake_units = (uint64_t)clock.units_into_tick + (uint64_t)slept_counts * TICKLESS_UNITS_PER_RTC_COUNT;
+        woke_in_time &= slept_counts == 0 || wake_units <= (uint64_t)(expected_idle_ticks - clock.owed_ticks) * TICKLESS_UNITS_PER_TICK;
+        if ((random >> 12) % 4 == 0) {
+            slept_counts = slept_counts * ((random >> 14) % 8) / 8; // Woken early by an interrupt
+        } else if ((random >> 12) % 4 == 1) {
+            slept_counts += (random >> 14) % 200; // Overslept (the wakeup was late being handled)
+        }
+        real_units += (uint64_t)slept_counts * TICKLESS_UNITS_PER_RTC_COUNT;
+
+        const tickless_step_t step = tickless_clock_wakeup(&clock, slept_counts, expected_idle_ticks);
+        stepped_in_range &= step.ticks_to_step < expected_idle_ticks;
+        kernel_ticks += step.ticks_to_step + (step.tick_pending ? 1 : 0);
+
+        time_kept &= kernel_ticks + clock.owed_ticks == real_units / TICKLESS_UNITS_PER_TICK;
+        time_kept &= clock.units_into_tick == real_units % TICKLESS_UNITS_PER_TICK;
+    }
+    PVDX_ASSERT_MSG(time_kept, "no time lost or gained across sleeps\n");
+    PVDX_ASSERT_MSG(woke_in_time, "wakeup before the unblock time\n");
+    PVDX_ASSERT_MSG(stepped_in_range, "kernel never stepped to or past the unblock time\n");
+}
+
+void test_command_schedule(void) {
+    test_log("----- testing command schedule -----\n");
+
+    // ADCS reads and processes in its own periodic releases, so nothing is scheduled for it
+    size_t adcs_entries = 0;
+    command_schedule_info_t info;
+    for (size_t i = 0; i < COMMAND_SCHEDULE_MAX_ENTRIES; i++) {
+        if (get_command_schedule_entry(i, &info) && info.target == p_adcs_task) {
+            adcs_entries++;
+        }
+    }
+    PVDX_ASSERT_MSG(adcs_entries == 0, "adcs driven by its releases, not the schedule\n");
+
+    // Bad periods, phases and commands without a route are refused
+    command_t cmd_process = {
+        .target = p_adcs_task,
+        .operation = OPERATION_PROCESS,
+        .data = {0},
+        .data_type = CMD_DATA_ADCS,
+        .result = NO_STATUS_RETURN,
+    };
+    PVDX_ASSERT_MSG(schedule_periodic_command(&cmd_process, 0, 0, NULL) == ERROR_SANITY_CHECK_FAILED, "zero period refused\n");
+    PVDX_ASSERT_MSG(schedule_periodic_command(&cmd_process, 100, 100, NULL) == ERROR_SANITY_CHECK_FAILED, "phase past period refused\n");
+    const command_t cmd_unrouted = {.target = p_display_task, .operation = OPERATION_PROCESS, .data_type = CMD_DATA_ADCS};
+    PVDX_ASSERT_MSG(schedule_periodic_command(&cmd_unrouted, 100, 0, NULL) == ERROR_INVALID_COMMAND, "unrouted command refused\n");
+
+    // Scheduling the same command again moves it rather than adding a second entry
+    size_t entry = COMMAND_SCHEDULE_MAX_ENTRIES;
+    size_t same_entry = COMMAND_SCHEDULE_MAX_ENTRIES;
+    PVDX_ASSERT_MSG(schedule_periodic_command(&cmd_process, 100, 30, &entry) == SUCCESS, "command scheduled\n");
+    PVDX_ASSERT_MSG(schedule_periodic_command(&cmd_process, 200, 50, &same_entry) == SUCCESS && same_entry == entry,
+                    "rescheduled in place\n");
+    PVDX_ASSERT_MSG(get_command_schedule_entry(entry, &info) && info.period_ms == 200 && info.phase_ms == 50, "new period and phase\n");
+    PVDX_ASSERT_MSG(info.next_release_ms > 0 && info.next_release_ms <= 200, "first release within a period\n");
+    PVDX_ASSERT_MSG(cancel_periodic_command(entry) == SUCCESS && !get_command_schedule_entry(entry, &info), "cancelled\n");
+    PVDX_ASSERT_MSG(cancel_periodic_command(entry) == ERROR_SANITY_CHECK_FAILED, "cancelled only once\n");
+
+    // Scheduled commands are emitted from the timer service task, so a full lane must drop them instead of blocking
+    if (get_dispatch_mode() == DISPATCH_MODE_DIRECT) {
+        task_manager_enable_task(p_adcs_task); // Commands for a disabled task never reach its lanes
+        const overflow_policy_config_t saved_policy = get_overflow_policy(OPERATION_PROCESS);
+        set_overflow_policy(OPERATION_PROCESS, OVERFLOW_POLICY_BOUNDED_WAIT, 1000);
+        const command_dispatcher_stats_t stats_before = get_command_dispatcher_stats();
+        for (size_t i = 0; i < COMMAND_QUEUE_MAX_COMMANDS; i++) {
+            dispatch_command(&cmd_process);
+        }
+        PVDX_ASSERT_MSG(enqueue_command_no_wait(&cmd_process) == ERROR_QUEUE_FULL, "full lane drops without waiting\n");
+        PVDX_ASSERT_MSG(get_command_dispatcher_stats().overflow_waits == stats_before.overflow_waits, "no bounded wait\n");
+        command_t received;
+        while (receive_command(p_adcs_task, &received, 0)) {
+        }
+        set_overflow_policy(OPERATION_PROCESS, saved_policy.policy, saved_policy.wait_ms);
+        task_manager_disable_task(p_adcs_task);
+    }
+}
+
+// Packs the arguments the way a tokenized logging call would
+static size_t encode_log_args(uint8_t *const p_payload, size_t capacity, bool *const p_truncated, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    const size_t length = log_token_encode_args(format, &args, p_payload, capacity, p_truncated);
+    va_end(args);
+    return length;
+}
+
+void test_log_tokens(void) {
+    test_log("----- testing log tokens -----\n");
+
+    // One little-endian word per integer conversion and a length-prefixed string per %s, in order; flags, widths,
+    // length modifiers and %% take no space
+    uint8_t payload[LOG_TOKEN_MAX_PAYLOAD];
+    bool truncated = false;
+    size_t length = encode_log_args(payload, sizeof(payload), &truncated, "%d %-4s %08lx%% %c\n", -2, "abc", 0xBEEFu, 'z');
+    const uint8_t expected[] = {0xFE, 0xFF, 0xFF, 0xFF, 3, 'a', 'b', 'c', 0xEF, 0xBE, 0x00, 0x00, 'z', 0, 0, 0};
+    PVDX_ASSERT_MSG(length == sizeof(expected) && memcmp(payload, expected, sizeof(expected)) == 0, "payload layout\n");
+    PVDX_ASSERT_MSG(!truncated, "nothing truncated\n");
+    PVDX_ASSERT_MSG(encode_log_args(payload, sizeof(payload), &truncated, "no arguments\n") == 0, "empty payload\n");
+
+    // Long strings are cut to LOG_TOKEN_MAX_STRING_LENGTH, and a NULL string is sent as an empty one
+    const char *long_string = "0123456789012345678901234567890123456789";
+    length = encode_log_args(payload, sizeof(payload), &truncated, "%s%s", long_string, NULL);
+    PVDX_ASSERT_MSG(length == LOG_TOKEN_MAX_STRING_LENGTH + 2 && payload[0] == LOG_TOKEN_MAX_STRING_LENGTH, "long string cut\n");
+    PVDX_ASSERT_MSG(memcmp(&payload[1], long_string, LOG_TOKEN_MAX_STRING_LENGTH) == 0 && payload[length - 1] == 0, "NULL string\n");
+    PVDX_ASSERT_MSG(truncated, "cut string reported\n");
+
+    // Arguments that don't fit are dropped whole
+    truncated = false;
+    length = encode_log_args(payload, 6, &truncated, "%u %u", 1u, 2u);
+    PVDX_ASSERT_MSG(length == 4 && truncated, "argument past the payload dropped\n");
+}
+
+void test_log_modules(void) {
+    test_log("----- testing log modules -----\n");
+
+#if defined(DEVBUILD) // Modules only exist in builds with logging
+    // Every file that includes logging.h is a module, this one included
+    size_t module_count = 0;
+    const log_module_t *const p_modules = get_log_modules(&module_count);
+    bool found = false;
+    for (size_t i = 0; i < module_count; i++) {
+        found |= p_modules[i].name == log_module.name;
+    }
+    PVDX_ASSERT_MSG(found, "this file is listed as a module\n");
+
+    // A module's level can be set on its own, by file name with or without the extension
+    PVDX_ASSERT_MSG(set_module_log_level("test.c", WARNING) == 1 && log_module.level == WARNING, "set by file name\n");
+    PVDX_ASSERT_MSG(!log_enabled(INFO) && log_enabled(WARNING), "messages below the module's level are dropped\n");
+    PVDX_ASSERT_MSG(set_module_log_level("test", INFO) == 1 && log_module.level == INFO, "set without the extension\n");
+    PVDX_ASSERT_MSG(set_module_log_level("no_such_module.c", DEBUG) == 0, "unknown module\n");
+    PVDX_ASSERT_MSG(set_module_log_level("tes", DEBUG) == 0 && log_module.level == INFO, "no prefix matches\n");
+
+    set_module_log_level("test.c", get_log_level());
+#endif
+}
+
+// Adds a text message to a ring the way a deferred logging call would
+static bool push_log(log_ring_t *const p_ring, bool *const p_was_empty, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    const bool pushed = log_ring_push(p_ring, LOG_ENTRY_TEXT, format, 0, format, &args, p_was_empty);
+    va_end(args);
+    return pushed;
+}
+
+void test_log_ring(void) {
+    test_log("----- testing log ring -----\n");
+    static log_ring_t ring; // Too large for the stack; zeroed below, which is an empty ring
+    memset(&ring, 0, sizeof(ring));
+    log_entry_t entry;
+    log_ring_stats_t stats;
+
+    // Messages come out in the order they went in, and only the first into an empty ring asks for a wakeup
+    bool was_empty = false;
+    PVDX_ASSERT_MSG(log_ring_is_empty(&ring) && !log_ring_pop(&ring, &entry), "zeroed ring is empty\n");
+    PVDX_ASSERT_MSG(push_log(&ring, &was_empty, "first %d\n", 1) && was_empty, "first message wakes the consumer\n");
+    PVDX_ASSERT_MSG(push_log(&ring, &was_empty, "second %d\n", 2) && !was_empty, "second message doesn't\n");
+    PVDX_ASSERT_MSG(log_ring_pop(&ring, &entry) && strcmp(entry.p_source, "first %d\n") == 0, "oldest message first\n");
+    PVDX_ASSERT_MSG(log_ring_pop(&ring, &entry) && strcmp(entry.p_source, "second %d\n") == 0, "then the next\n");
+    PVDX_ASSERT_MSG(log_ring_is_empty(&ring) && !log_ring_pop(&ring, &entry), "ring empty again\n");
+
+    // A full ring drops new messages and counts them, and keeps working across many laps
+    for (uint32_t i = 0; i < LOG_RING_CAPACITY; i++) {
+        push_log(&ring, &was_empty, "fill %u\n", i);
+    }
+    PVDX_ASSERT_MSG(!push_log(&ring, &was_empty, "overflow\n"), "full ring drops the message\n");
+    bool in_order = true;
+    for (uint32_t i = 0; i < 3 * LOG_RING_CAPACITY + 1; i++) {
+        in_order &= log_ring_pop(&ring, &entry) && entry.payload[0] == (uint8_t)i;
+        in_order &= push_log(&ring, &was_empty, "fill %u\n", i + LOG_RING_CAPACITY);
+    }
+    PVDX_ASSERT_MSG(in_order, "order kept across wraparound\n");
+    get_log_ring_stats(&ring, &stats);
+    PVDX_ASSERT_MSG(stats.dropped == 1 && stats.max_depth == LOG_RING_CAPACITY, "drops and depth counted\n");
+
+    // The Logger task prints a message from its packed arguments exactly as SEGGER_RTT_vprintf would have
+    memset(&ring, 0, sizeof(ring));
+    push_log(&ring, &was_empty, "[%s:%d] %5u|%-3d|%03x|%X|%p|%c|%%|%.4d\n", "test.c", 42, 7u, -5, 0xAu, 0xBEEFu, (void *)0x1234, 'k', 12);
+    char text[64];
+    log_ring_pop(&ring, &entry);
+    const size_t length = log_format_payload(entry.p_source, entry.payload, entry.payload_length, text, sizeof(text) - 1);
+    text[length] = '\0';
+    PVDX_ASSERT_MSG(strcmp(text, "[test.c:42]     7|-5 |00A|BEEF|00001234|k|%|0012\n") == 0, "formatted like SEGGER_RTT_vprintf\n");
+    PVDX_ASSERT_MSG(log_format_payload("%d %s!", entry.payload, 0, text, sizeof(text)) == 2, "missing arguments print nothing\n");
+    PVDX_ASSERT_MSG(log_format_payload("abcdef", NULL, 0, text, 3) == 3, "text cut to the buffer\n");
+}
+
+// Writes a message to a crash log the way a fatal error or warning would
+static void write_crash_log(crash_log_t *const p_log, log_kind_t kind, const char *file, uint32_t line, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    crash_log_write(p_log, kind, file, line, format, &args);
+    va_end(args);
+}
+
+void test_crash_log(void) {
+    test_log("----- testing crash log -----\n");
+    static crash_log_t log; // Too large for the stack
+    static crash_log_record_t records[CRASH_LOG_CAPACITY];
+
+    // CRC-16/CCITT-FALSE check value
+    PVDX_ASSERT_MSG(crash_log_crc16((const uint8_t *)"123456789", 9) == 0x29B1, "CRC check value\n");
+
+    // Garbage (as in backup RAM after a power loss) recovers as an empty log
+    memset(&log, 0xA5, sizeof(log));
+    PVDX_ASSERT_MSG(crash_log_recover(&log, records) == 0 && log.next_sequence == 0, "garbage rejected\n");
+
+    // Messages come back in order, formatted, without colour codes, and with the call site when it isn't in the text
+    write_crash_log(&log, LOG_KIND_WARNING, NULL, 0, "\x1b[1;31m[WARNING|%s:%d]: low %s\x1b[0m\n", "a.c", 7, "power");
+    write_crash_log(&log, LOG_KIND_FATAL, "b.c", 12, "failed %d times\n", 3);
+    PVDX_ASSERT_MSG(crash_log_recover(&log, records) == 2, "both records recovered\n");
+    PVDX_ASSERT_MSG(strcmp(records[0].text, "[WARNING|a.c:7]: low power\n") == 0 && records[0].kind == LOG_KIND_WARNING,
+                    "colour codes stripped\n");
+    PVDX_ASSERT_MSG(strcmp(records[1].text, "b.c:12: failed 3 times\n") == 0 && records[1].sequence == 1, "call site added\n");
+    write_crash_log(&log, LOG_KIND_WARNING, NULL, 0, "after the reset\n");
+    PVDX_ASSERT_MSG(crash_log_recover(&log, records) == 1 && records[0].sequence == 2, "numbering continues after a reset\n");
+    PVDX_ASSERT_MSG(crash_log_recover(&log, records) == 0 && log.next_sequence == 0, "log emptied\n");
+
+    // Once full, the oldest records are overwritten; a torn or corrupted record is dropped on its own
+    for (uint32_t i = 0; i < CRASH_LOG_CAPACITY + 5; i++) {
+        write_crash_log(&log, LOG_KIND_WARNING, NULL, 0, "message %u\n", i);
+    }
+    log.records[8].text[0] ^= 1;
+    log.records[9].crc ^= 1;
+    const size_t count = crash_log_recover(&log, records);
+    bool in_order = true;
+    for (size_t i = 1; i < count; i++) {
+        in_order &= records[i].sequence > records[i - 1].sequence;
+    }
+    PVDX_ASSERT_MSG(count == CRASH_LOG_CAPACITY - 2 && in_order, "corrupted records dropped, the rest in order\n");
+    PVDX_ASSERT_MSG(records[0].sequence == 5 && records[count - 1].sequence == CRASH_LOG_CAPACITY + 4, "oldest overwritten\n");
+
+    // Text longer than a record is cut short and stays terminated
+    write_crash_log(&log, LOG_KIND_WARNING, NULL, 0, "%s%s%s", "0123456789012345678901234567890",
+                    "0123456789012345678901234567890", "0123456789012345678901234567890");
+    PVDX_ASSERT_MSG(crash_log_recover(&log, records) == 1 && records[0].length == CRASH_LOG_TEXT_LENGTH - 1 &&
+                        records[0].text[CRASH_LOG_TEXT_LENGTH - 1] == '\0',
+                    "long text cut\n");
+}
+
+// Reads the next `count` bits of a compressed payload, most significant first; false if the payload ends first
+static bool read_log_payload_bits(const uint8_t *p_payload, size_t payload_length, size_t *const p_bit, size_t count,
+                                  uint32_t *const p_value) {
+    *p_value = 0;
+    for (size_t i = 0; i < count; i++, (*p_bit)++) {
+        if (*p_bit >= (payload_length - LOG_COMPRESS_HEADER_SIZE) * 8) {
+            return false;
+        }
+        const uint8_t byte = p_payload[LOG_COMPRESS_HEADER_SIZE + *p_bit / 8];
+        *p_value = (*p_value << 1) | ((byte >> (7 - *p_bit % 8)) & 1);
+    }
+    return true;
+}
+
+// Decompresses one payload the way scripts/log_decompress.py does, returning the length (0 if the payload is invalid)
+static size_t decompress_log_payload(const uint8_t *p_payload, size_t payload_length, uint8_t *const p_output, size_t capacity) {
+    const size_t length = p_payload[1] | ((size_t)p_payload[2] << 8);
+    if (p_payload[0] != LOG_COMPRESS_FORMAT || length > capacity) {
+        return 0;
+    }
+    size_t bit = 0;
+    size_t produced = 0;
+    while (produced < length) {
+        uint32_t is_literal, offset, count;
+        if (!read_log_payload_bits(p_payload, payload_length, &bit, 1, &is_literal)) {
+            return 0;
+        }
+        if (is_literal) {
+            uint32_t value;
+            if (!read_log_payload_bits(p_payload, payload_length, &bit, 8, &value)) {
+                return 0;
+            }
+            p_output[produced++] = (uint8_t)value;
+            continue;
+        }
+        if (!read_log_payload_bits(p_payload, payload_length, &bit, LOG_COMPRESS_WINDOW_BITS, &offset) ||
+            !read_log_payload_bits(p_payload, payload_length, &bit, LOG_COMPRESS_LENGTH_BITS, &count)) {
+            return 0;
+        }
+        offset += 1;
+        count += LOG_COMPRESS_MIN_MATCH;
+        if (offset > produced || produced + count > length) {
+            return 0;
+        }
+        for (size_t i = 0; i < count; i++, produced++) {
+            p_output[produced] = p_output[produced - offset];
+        }
+    }
+    return produced;
+}
+
+void test_log_compress(void) {
+    test_log("----- testing log compression -----\n");
+    static log_compressor_t compressor; // Too large for the stack
+    static uint8_t input[1500];
+    static uint8_t output[1500];
+    uint8_t payload[LOG_COMPRESS_HEADER_SIZE + 128];
+    const char *const line = "[DEBUG|display_main.c:52]: display: No more commands queued.\n";
+    const size_t line_length = strlen(line);
+
+    // No input gives an empty payload; a repeat becomes one back-reference (9 + 9 + 15 bits)
+    memset(&compressor, 0, sizeof(compressor));
+    log_compressor_start(&compressor, payload, sizeof(payload));
+    PVDX_ASSERT_MSG(log_compressor_finish(&compressor) == LOG_COMPRESS_HEADER_SIZE && payload[0] == LOG_COMPRESS_FORMAT &&
+                        payload[1] == 0 && payload[2] == 0,
+                    "empty payload\n");
+    log_compressor_start(&compressor, payload, sizeof(payload));
+    PVDX_ASSERT_MSG(log_compressor_sink(&compressor, (const uint8_t *)"abababab", 8) == 8, "input taken\n");
+    size_t length = log_compressor_finish(&compressor);
+    PVDX_ASSERT_MSG(length == LOG_COMPRESS_HEADER_SIZE + 5 && payload[1] == 8, "repeat becomes a back-reference\n");
+    PVDX_ASSERT_MSG(decompress_log_payload(payload, length, output, sizeof(output)) == 8 && memcmp(output, "abababab", 8) == 0,
+                    "repeat decompressed\n");
+
+    // Repetitive log text, given a few bytes at a time, spreads over payloads that each decompress on their own
+    size_t size = 0;
+    for (uint32_t i = 0; size + line_length <= sizeof(input); i++) {
+        memcpy(&input[size], line, line_length);
+        input[size + 2] = (uint8_t)('A' + i % 26); // Vary the lines a little
+        size += line_length;
+    }
+    size_t offset = 0;
+    size_t decompressed = 0;
+    size_t compressed = 0;
+    bool payloads_valid = true;
+    do {
+        log_compressor_start(&compressor, payload, sizeof(payload));
+        while (offset < size) {
+            const size_t piece = (size - offset) < 7 ? (size - offset) : 7;
+            const size_t taken = log_compressor_sink(&compressor, &input[offset], piece);
+            offset += taken;
+            if (taken < piece) {
+                break;
+            }
+        }
+        length = log_compressor_finish(&compressor);
+        compressed += length;
+        const size_t chunk = decompress_log_payload(payload, length, &output[decompressed], sizeof(output) - decompressed);
+        payloads_valid &= length <= sizeof(payload) && chunk > 0;
+        decompressed += chunk;
+    } while (offset < size || log_compressor_pending(&compressor) > 0);
+    PVDX_ASSERT_MSG(payloads_valid && decompressed == size && memcmp(input, output, size) == 0, "log text round trip\n");
+    // (one line repeated is far more compressible than real logs; benchmark_log_compress() measures crash log records)
+    PVDX_ASSERT_MSG(compressed * 4 < size, "repeated line compressed to under a quarter\n");
+
+    // Data with nothing to match grows by at most a bit per byte, plus the headers
+    uint32_t state = 0x12345678;
+    for (size_t i = 0; i < sizeof(input); i++) {
+        state = state * 1664525u + 1013904223u;
+        input[i] = (uint8_t)(state >> 24);
+    }
+    offset = 0;
+    decompressed = 0;
+    compressed = 0;
+    size_t payloads = 0;
+    do {
+        log_compressor_start(&compressor, payload, sizeof(payload));
+        offset += log_compressor_sink(&compressor, &input[offset], sizeof(input) - offset);
+        length = log_compressor_finish(&compressor);
+        compressed += length;
+        payloads++;
+        decompressed += decompress_log_payload(payload, length, &output[decompressed], sizeof(output) - decompressed);
+    } while (offset < sizeof(input) || log_compressor_pending(&compressor) > 0);
+    PVDX_ASSERT_MSG(decompressed == sizeof(input) && memcmp(input, output, sizeof(input)) == 0, "random data round trip\n");
+    PVDX_ASSERT_MSG(compressed <= sizeof(input) * 9 / 8 + payloads * (LOG_COMPRESS_HEADER_SIZE + 1), "random data bounded\n");
+}